@@ -0,0 +1,342 @@
+#include <osek/osek.h>
+#include <debug.h>
+#include <sdvos.h>
+#include <board.h>
+#include <sdvos_printf.h>
+
+/*
+ * Kernel microbenchmarks. Each benchmark takes
+ * BENCH_ITERATIONS samples with the cycle counter and the
+ * results are printed as CSV between "# sdvos-bench" and
+ * "# end" lines. Compare two runs with
+ * tools/benchcmp/benchcmp.sh.
+ */
+
+DeclareTask (bench);
+DeclareTask (target);
+DeclareTask (pong);
+DeclareTask (chain);
+DeclareTask (sink);
+
+/** Output format version, bump when rows change meaning */
+#define BENCH_VERSION      1
+
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS   1000
+#endif
+
+/** Alarms available to the counter benchmark */
+#define BENCH_ALARMS       (NUM_ALARMS - BENCH_ALARM0)
+
+#define XSTR(s) STR(s)
+#define STR(s) #s
+
+typedef struct bench_result_t {
+  uint32_t n;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+} BenchResult;
+
+extern volatile uint32_t bench_callbacks;
+
+/* Time stamps taken by the measured tasks */
+static volatile CycleType target_stamp = 0;
+static volatile CycleType pong_stamp = 0;
+static volatile CycleType chain_stamp = 0;
+static volatile uint32_t chain_left = 0;
+static BenchResult chain_result;
+
+static void
+BenchReset (BenchResult * r)
+{
+  r->n = 0;
+  r->min = 0xFFFFFFFFUL;
+  r->max = 0;
+  r->sum = 0;
+}
+
+static void
+BenchAdd (BenchResult * r, CycleType cycles)
+{
+  r->n++;
+  r->sum += cycles;
+  if (cycles < r->min) r->min = cycles;
+  if (cycles > r->max) r->max = cycles;
+}
+
+static unsigned long
+BenchNs (uint64_t cycles)
+{
+  return (unsigned long) CyclesToNs (cycles);
+}
+
+static void
+BenchPrint (const char * name, BenchResult * r)
+{
+  if (!r->n) return;
+  sdvos_printf ("%s,%lu,%lu,%lu,%lu\n", name, (unsigned long) r->n,
+                BenchNs (r->min), BenchNs (r->sum / r->n),
+                BenchNs (r->max));
+}
+
+/* Cost of taking a time stamp, included in all results */
+static void
+BenchOverhead (void)
+{
+  BenchResult r;
+  CycleType t0 = 0;
+  uint32_t i = 0;
+
+  BenchReset (&r);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    t0 = GetCycleCount ();
+    BenchAdd (&r, GetCycleCount () - t0);
+  }
+  BenchPrint ("cycle_overhead", &r);
+}
+
+/* ActivateTask until the first instruction of target */
+static void
+BenchActivate (void)
+{
+  BenchResult r;
+  CycleType t0 = 0;
+  uint32_t i = 0;
+
+  BenchReset (&r);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    t0 = GetCycleCount ();
+    ActivateTask (target);
+    BenchAdd (&r, target_stamp - t0);
+  }
+  BenchPrint ("activate_dispatch", &r);
+}
+
+/* SetEvent on a waiting task, one way and round trip */
+static void
+BenchEvent (void)
+{
+  BenchResult wake, rtt;
+  CycleType t0 = 0;
+  uint32_t i = 0;
+
+  BenchReset (&wake);
+  BenchReset (&rtt);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    t0 = GetCycleCount ();
+    SetEvent (pong, EV_PING);
+    WaitEvent (EV_PONG);
+    ClearEvent (EV_PONG);
+    BenchAdd (&rtt, GetCycleCount () - t0);
+    BenchAdd (&wake, pong_stamp - t0);
+  }
+  BenchPrint ("event_wakeup", &wake);
+  BenchPrint ("event_pingpong", &rtt);
+}
+
+/* Time between two consecutive instances of chain */
+static void
+BenchChain (void)
+{
+  BenchReset (&chain_result);
+  chain_left = BENCH_ITERATIONS + 1;
+  ActivateTask (chain);
+  BenchPrint ("chain_task", &chain_result);
+}
+
+/* GetResource/ReleaseResource round trip */
+static void
+BenchResource (void)
+{
+  BenchResult r;
+  CycleType t0 = 0;
+  uint32_t i = 0;
+
+  BenchReset (&r);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    t0 = GetCycleCount ();
+    GetResource (RES_BENCH);
+    ReleaseResource (RES_BENCH);
+    BenchAdd (&r, GetCycleCount () - t0);
+  }
+  BenchPrint ("resource_get_release", &r);
+}
+
+/*
+ * IncrementCounter with n cyclic alarms armed one tick
+ * apart. Every increment expires one alarm, calls its
+ * callback and inserts it back behind the other n - 1.
+ */
+static void
+BenchCounter (uint32_t n)
+{
+  BenchResult r;
+  CycleType t0 = 0;
+  uint32_t i = 0;
+  char name[24];
+
+  if (n > BENCH_ALARMS) return;
+
+  for (i = 0; i < n; i++) {
+    SetRelAlarm (BENCH_ALARM0 + i, i + 1, n);
+  }
+
+  BenchReset (&r);
+  bench_callbacks = 0;
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    t0 = GetCycleCount ();
+    IncrementCounter (BENCH_COUNTER);
+    BenchAdd (&r, GetCycleCount () - t0);
+  }
+
+  for (i = 0; i < n; i++) {
+    CancelAlarm (BENCH_ALARM0 + i);
+  }
+
+  if (bench_callbacks != BENCH_ITERATIONS) {
+    sdvos_printf ("# counter_tick_%lu: %lu callbacks\n",
+                  (unsigned long) n, (unsigned long) bench_callbacks);
+  }
+
+  sdvos_sprintf (name, "counter_tick_%lu", (unsigned long) n);
+  BenchPrint (name, &r);
+}
+
+/*
+ * IncrementCounter with n cyclic alarms sharing the same
+ * expiration and cycle. Every increment expires all of
+ * them and inserts them back together.
+ */
+static void
+BenchCounterGroup (uint32_t n)
+{
+  BenchResult r;
+  CycleType t0 = 0;
+  uint32_t i = 0;
+  char name[24];
+
+  if (n > BENCH_ALARMS) return;
+
+  for (i = 0; i < n; i++) {
+    SetRelAlarm (BENCH_ALARM0 + i, 1, 1);
+  }
+
+  BenchReset (&r);
+  bench_callbacks = 0;
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    t0 = GetCycleCount ();
+    IncrementCounter (BENCH_COUNTER);
+    BenchAdd (&r, GetCycleCount () - t0);
+  }
+
+  for (i = 0; i < n; i++) {
+    CancelAlarm (BENCH_ALARM0 + i);
+  }
+
+  if (bench_callbacks != n * BENCH_ITERATIONS) {
+    sdvos_printf ("# counter_group_%lu: %lu callbacks\n",
+                  (unsigned long) n, (unsigned long) bench_callbacks);
+  }
+
+  sdvos_sprintf (name, "counter_group_%lu", (unsigned long) n);
+  BenchPrint (name, &r);
+}
+
+/* IncrementCounter processing one expiry point per tick */
+static void
+BenchScheduleTable (void)
+{
+  BenchResult r;
+  CycleType t0 = 0;
+  uint32_t i = 0;
+
+  StartScheduleTableRel (BENCH_TABLE, 1);
+
+  BenchReset (&r);
+  for (i = 0; i < BENCH_ITERATIONS; i++) {
+    t0 = GetCycleCount ();
+    IncrementCounter (BENCH_COUNTER);
+    BenchAdd (&r, GetCycleCount () - t0);
+  }
+
+  StopScheduleTable (BENCH_TABLE);
+  BenchPrint ("schedtbl_expiry", &r);
+}
+
+TASK (bench)
+{
+  sdvos_printf ("# sdvos-bench %d\n", BENCH_VERSION);
+  sdvos_printf ("# board=" XSTR(BOARDNAME) " freq=%lu iterations=%lu\n",
+                (unsigned long) GetCycleFreq (),
+                (unsigned long) BENCH_ITERATIONS);
+  sdvos_printf ("name,iterations,min_ns,avg_ns,max_ns\n");
+
+  BenchOverhead ();
+  BenchActivate ();
+  BenchEvent ();
+  BenchChain ();
+  BenchResource ();
+  BenchCounter (1);
+  BenchCounter (10);
+  BenchCounter (100);
+  BenchCounter (1000);
+  BenchCounterGroup (10);
+  BenchCounterGroup (100);
+  BenchScheduleTable ();
+
+  sdvos_printf ("# end\n");
+
+  ShutdownOS (E_OK);
+  TerminateTask ();
+
+  return E_OK;
+}
+
+TASK (target)
+{
+  target_stamp = GetCycleCount ();
+  TerminateTask ();
+
+  return E_OK;
+}
+
+TASK (pong)
+{
+  while (1) {
+    WaitEvent (EV_PING);
+    pong_stamp = GetCycleCount ();
+    ClearEvent (EV_PING);
+    SetEvent (bench, EV_PONG);
+  }
+
+  return E_OK;
+}
+
+TASK (chain)
+{
+  CycleType now = GetCycleCount ();
+
+  /* The first instance only takes the reference time */
+  if (chain_left <= BENCH_ITERATIONS) {
+    BenchAdd (&chain_result, now - chain_stamp);
+  }
+  chain_stamp = now;
+
+  if (--chain_left) ChainTask (chain);
+  TerminateTask ();
+
+  return E_OK;
+}
+
+TASK (sink)
+{
+  while (1) {
+    WaitEvent (EV_SINK);
+    ClearEvent (EV_SINK);
+  }
+
+  return E_OK;
+}
+
+/* vi: set et ai sw=2 sts=2: */
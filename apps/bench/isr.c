@@ -0,0 +1,51 @@
+#include <osek/osek.h>
+#include <debug.h>
+#include <sdvos.h>
+#include <sdvos_printf.h>
+
+#ifdef __ARCH_LINUX__
+#include <stdlib.h>
+#endif
+
+/* Number of BENCH_CALLBACK invocations */
+volatile uint32_t bench_callbacks = 0;
+
+void
+BENCH_CALLBACK ()
+{
+  bench_callbacks++;
+}
+
+void
+ErrorHook (StatusType e)
+{
+  sdvos_printf ("# error %d in service %d\n", e,
+                OSErrorGetServiceId ());
+}
+
+void
+StartupHook ()
+{
+}
+
+void
+ShutdownHook (StatusType e)
+{
+#ifdef __ARCH_LINUX__
+  /* Leave the process so that runs can be scripted */
+  exit (e == E_OK ? 0 : 1);
+#endif
+}
+
+int
+main (void)
+{
+  StartOS (OSDEFAULTAPPMODE);
+
+  /* Should not reach here */
+  while (1) {};
+
+  return 0;
+}
+
+/* vi: set et ai sw=2 sts=2: */
@@ -28,22 +28,35 @@
 
 /** Global queue for all counters in the system */
 extern Counter counters[NUM_COUNTERS];
-/** Global queue for all alarms in the system */
-extern AlarmQueueType alarms[NUM_ALARMS];
+/** Global queue for all alarms (and task timers) in the system */
+extern AlarmQueueType alarms[NUM_ALARMS + NUM_TASK_TIMERS];
+
+/*
+ * Without alarms (e.g. CYCLIC_EXECUTIVE, where the alarms of
+ * SYS_COUNTER are compiled into the cyclic table), the alarm
+ * queues of all counters stay empty and are never processed.
+ * Alarm services then check the alarm ID in any status and
+ * always fail with E_OS_ID.
+ */
+#if (NUM_ALARMS + NUM_TASK_TIMERS) > 0
+#define ALARM_QUEUES
+#elif defined USE_TIMING_WHEEL
+#error "USE_TIMING_WHEEL requires alarms!"
+#endif
 
 /**
  * @brief Setting alarm parameters
  *
- * This function sets alarm specific parameters (OVF bit,
- * expiration, cycle) based on input provided. If exp is
- * smaller than (or equal to) current counter count, it
- * will be treated as an overflow. This is consistent with
- * SetAbs/RelAlarm specification.
+ * This function sets alarm specific parameters (expiration,
+ * cycle) based on input provided. If exp is smaller than
+ * (or equal to) current counter count, it will be treated
+ * as an overflow. This is consistent with SetAbs/RelAlarm
+ * specification.
  *
  * @param[in] alarm
  *   Reference to alarm
  * @param[in] exp
- *   Alarm expiration time in ticks
+ *   Alarm expiration time in ticks (counter count)
  * @param[in] cycle
  *   Cycle value in case of cyclic alarm
  */
@@ -51,42 +64,229 @@ static void
 SetAlarm (AlarmType alarm, TickType exp, TickType cycle)
 {
   Counter * counter = alarms[alarm].counter;
+  TickType max = counter->properties.maxallowedvalue;
 
   if (exp <= counter->count) {
-    /* exp is an overflow of the counter count */
-    ToggleAlarmOVF (alarm);
+    /* exp is in the next counter cycle */
+    alarms[alarm].exp = counter->ticks + (max - counter->count) +
+                        exp + 1;
   } else {
-    /* exp does not overflow */
-    SetAlarmOVF (alarm);
+    alarms[alarm].exp = counter->ticks + (exp - counter->count);
   }
 
   alarms[alarm].cycle = cycle;
-  alarms[alarm].exp = exp;
 }
 
+#ifdef USE_TIMING_WHEEL
 /**
- * @brief Activate an alarm
+ * @def WheelLowMask
+ * @brief Mask of the wheel time digits below a level
  *
- * ActivateAlarm inserts the specified alarm into its
- * counter's alarm queue and sets the status of the alarm
- * to "active". If the given alarm is already active,
- * ActivateAlarm will do nothing and return.
+ * @param[in] level
+ *   Timing wheel level
+ */
+#define WheelLowMask(level)                                    \
+  ((((uint32_t) 0x1UL) << ((level) * WHEEL_SLOT_BITS)) - 1)
+
+/**
+ * @def WheelTimeMask
+ * @brief Mask of the wheel time covered by all the levels
  *
- * Alarms in counter alarm queue are sorted by their
- * expiration time with the earliest being the head of the
- * queue. An overflow bit in each alarm and counter is used
- * to simplify the queue management.
+ * @param[in] wheel
+ *   Reference to a timing wheel
+ */
+#define WheelTimeMask(wheel)                                   \
+  ((((uint32_t) WHEEL_SLOTS) <<                                \
+   (((wheel)->levels - 1) * WHEEL_SLOT_BITS)) - 1)
+
+/**
+ * @brief Number of ticks until an alarm expires
  *
- * @param[in] alarm
+ * AlarmTicks returns the number of counter ticks between
+ * the current counter time and the expiration time of an
+ * alarm. An alarm which is not ahead of the counter is due
+ * on the next tick.
+ *
+ * @param[in] alm
+ *   Reference to an alarm
+ *
+ * @return
+ *   Ticks to expiration, between 1 and maxallowedvalue + 1
+ */
+static uint32_t
+AlarmTicks (AlarmQueueType * alm)
+{
+  Counter * counter = alm->counter;
+
+  if (TickDue (counter, alm->exp)) return 1;
+
+  return (CounterTimeType) (alm->exp - counter->ticks);
+}
+
+/**
+ * @brief Find the timing wheel slot of an alarm
+ *
+ * The slot is selected by the highest digit in which the
+ * wheel expiration time of the alarm differs from the
+ * current wheel time. This stays true until the wheel time
+ * reaches the slot and the alarm is cascaded.
+ *
+ * @param[in] alm
+ *   Reference to an alarm
+ *
+ * @return
+ *   Reference to the head of the slot list
+ */
+static AlarmQueueType **
+WheelSlot (AlarmQueueType * alm)
+{
+  TimingWheelType * wheel = alm->counter->wheel;
+  uint32_t diff = alm->wexp ^ wheel->now;
+  udata_word_t level = 0;
+
+  while (((level + 1) < wheel->levels) &&
+         (diff >> ((level + 1) * WHEEL_SLOT_BITS))) {
+    level++;
+  }
+
+  return &wheel->slots[(level << WHEEL_SLOT_BITS) +
+                       ((alm->wexp >> (level * WHEEL_SLOT_BITS)) &
+                        (WHEEL_SLOTS - 1))];
+}
+
+/**
+ * @brief Append an alarm to its timing wheel slot
+ *
+ * Slots are kept in insertion order, so alarms with the
+ * same expiration time fire in the order they were set.
+ *
+ * @param[in] alm
  *   Reference to an alarm
  */
 static void
-ActivateAlarm (AlarmType alarm)
+WheelAppend (AlarmQueueType * alm)
 {
-  AlarmQueueType * queue = alarms[alarm].counter->alarms;
-  AlarmQueueType * alm = &alarms[alarm];
+  AlarmQueueType ** slot = WheelSlot (alm);
+
+  if (!*slot) {
+    alm->next = alm->prev = alm;
+    *slot = alm;
+  } else {
+    /* The tail of a circular list is prev of its head */
+    alm->next = *slot;
+    alm->prev = (*slot)->prev;
+    (*slot)->prev->next = alm;
+    (*slot)->prev = alm;
+  }
+}
+
+/**
+ * @brief Insert an alarm into its counter timing wheel
+ *
+ * @param[in] alm
+ *   Reference to an alarm
+ * @param[in] ticks
+ *   Ticks to expiration relative to the wheel time
+ */
+static void
+WheelInsert (AlarmQueueType * alm, uint32_t ticks)
+{
+  TimingWheelType * wheel = alm->counter->wheel;
+
+  alm->wexp = (wheel->now + ticks) & WheelTimeMask (wheel);
+  WheelAppend (alm);
+}
+
+/**
+ * @brief Remove an alarm from its counter timing wheel
+ *
+ * @param[in] alm
+ *   Reference to an alarm
+ */
+static void
+WheelRemove (AlarmQueueType * alm)
+{
+  AlarmQueueType ** slot = WheelSlot (alm);
+
+  if (alm->next == alm) {
+    *slot = NULL;
+  } else {
+    alm->prev->next = alm->next;
+    alm->next->prev = alm->prev;
+    if (*slot == alm) *slot = alm->next;
+  }
+}
+
+/**
+ * @brief Move alarms of the current slot down one level
+ *
+ * WheelCascade empties the slot of a level selected by the
+ * current wheel time and puts each alarm in it back into
+ * the wheel. As the wheel time has caught up with their
+ * digit of the level, all of them end up in lower levels.
+ * The order of the slot is preserved.
+ *
+ * @param[in] wheel
+ *   Reference to a timing wheel
+ * @param[in] level
+ *   Level to cascade
+ */
+static void
+WheelCascade (TimingWheelType * wheel, udata_word_t level)
+{
+  AlarmQueueType ** slot = NULL;
+  AlarmQueueType * alm = NULL, * next = NULL;
+
+  slot = &wheel->slots[(level << WHEEL_SLOT_BITS) +
+                       ((wheel->now >> (level * WHEEL_SLOT_BITS)) &
+                        (WHEEL_SLOTS - 1))];
+  if (!(alm = *slot)) return;
+
+  /* Detach the list first, alarms may land in other slots */
+  *slot = NULL;
+  alm->prev->next = NULL;
+
+  while (alm) {
+    next = alm->next;
+    WheelAppend (alm);
+    alm = next;
+  }
+}
+#endif
+
+/**
+ * @brief Insert a list of alarms into their counter queue
+ *
+ * QueueAlarms inserts alarms linked by peer into their
+ * counter's alarm queue and sets them to "active". All of
+ * them must have the expiration time of the first one.
+ *
+ * Nodes in counter alarm queue are sorted by their
+ * expiration time with the earliest being the head of the
+ * queue. Expiration times are compared by their position
+ * in the counter window (see TickPos). If a node expiring at
+ * the same tick already exists, the alarms are appended to
+ * its peers, so that alarms sharing an expiration time
+ * still expire in the order they were set.
+ *
+ * @param[in] alm
+ *   Reference to the first alarm of the list
+ */
+static void
+QueueAlarms (AlarmQueueType * alm)
+{
+  AlarmQueueType * queue = alm->counter->alarms;
   AlarmQueueType * last = NULL;
   Counter * counter = alm->counter;
+  CounterTimeType pos = 0;
+
+  /* Link the list as the peers of its first alarm */
+  for (last = alm; last->peer; last = last->peer) {
+    last->peer->prev = last;
+    last->peer->next = NULL;
+    last->peer->status |= (ALARM_STATUS_PEER | ALARM_STATUS_ACTIVE);
+  }
+  last = NULL;
 
   if (!queue) {
     alm->counter->alarms = alm;
@@ -94,35 +294,11 @@ ActivateAlarm (AlarmType alarm)
     goto finish;
   }
 
-  /*
-   * Now, insert the alarm into alarm queue. The alarm queue
-   * is ordered by absolute expiration time. Here we assume
-   * that *NO* alarm with counter UNDERFLOW will exist in
-   * the queue at the time of ActivateAlarm. Overflow is
-   * allowed.
-   *
-   * This assumption is correct because whenever a counter
-   * gets updated through IncrementCounter, all the alarms
-   * with an underflow will be triggered and removed from
-   * the queue. So, only CheckAlarms will encounter the
-   * rare case of having an alarm underflow.
-   */
-  while (queue) {
-    if (((queue->status ^ alm->status) & ALARM_STATUS_OVF) &&
-        (CounterOVF (counter) == AlarmOVF (alarm))) {
-      /* The expiration time of 'queue' is an overflow. */
-      /* Expiration time of alarm is not an overflow. */
-      /* Alarm should be inserted in front of 'queue'. */
-      break;
-    } else if (!((queue->status ^ alm->status) &
-               ALARM_STATUS_OVF) && (alm->exp < queue->exp)) {
-      /* Alarm and 'queue' have the same OVF bit. */
-      /* A comparison of expiration time is enough. */
-      break;
-    } else {
-      if (!queue->next) last = queue;
-      queue = queue->next;
-    }
+  /* Find the first node not earlier than the alarms */
+  pos = TickPos (counter, alm->exp);
+  while (queue && (TickPos (counter, queue->exp) < pos)) {
+    last = queue;
+    queue = queue->next;
   }
 
   if (!queue) {
@@ -130,6 +306,13 @@ ActivateAlarm (AlarmType alarm)
     last->next = alm;
     alm->prev = last;
     alm->next = NULL;
+  } else if (alm->exp == queue->exp) {
+    /* Same expiration, join the node behind its peers */
+    for (last = queue; last->peer; last = last->peer);
+    last->peer = alm;
+    alm->prev = last;
+    alm->next = NULL;
+    alm->status |= ALARM_STATUS_PEER;
   } else {
     /*
      * Otherwise, queue is the alarm where our alarm should
@@ -149,18 +332,52 @@ ActivateAlarm (AlarmType alarm)
 finish:
   /* Sets alarm to active */
   alm->status |= ALARM_STATUS_ACTIVE;
+  /* Alarm might expire before the counter next event */
+  UpdateNextEvent (counter, alm->exp);
   return;
 }
 
+/**
+ * @brief Activate an alarm
+ *
+ * ActivateAlarm inserts the specified alarm into its
+ * counter's alarm queue and sets the status of the alarm
+ * to "active". If the given alarm is already active,
+ * ActivateAlarm will do nothing and return.
+ *
+ * @param[in] alarm
+ *   Reference to an alarm
+ */
+static void
+ActivateAlarm (AlarmType alarm)
+{
+  AlarmQueueType * alm = &alarms[alarm];
+
+#ifdef USE_TIMING_WHEEL
+  if (alm->counter->wheel) {
+    /* Set while in the middle of a counter update */
+    WheelInsert (alm, AlarmTicks (alm) + alm->counter->wheel->lag);
+    alm->status |= ALARM_STATUS_ACTIVE;
+    return;
+  }
+#endif
+
+  alm->peer = NULL;
+  QueueAlarms (alm);
+}
+
 /**
  * @brief Deactivate an alarm
  *
  * RemoveAlarm does the opposite of ActivateAlarm, it
  * removes an alarm from its counter alarm queue and
- * mark it as not active.
+ * mark it as not active. If the alarm shares its queue
+ * node with peers, the node stays in the queue with the
+ * remaining ones.
  *
  * If the specified alarm is not active, RemoveAlarm will
- * do nothing and return.
+ * do nothing and return. This includes the alarms of a node
+ * being fired (see FireAlarmNode).
  *
  * @param[in] alarm
  *   Reference to an alarm
@@ -169,21 +386,47 @@ static void
 RemoveAlarm (AlarmType alarm)
 {
   AlarmQueueType * alm = &alarms[alarm];
+  AlarmQueueType * node = NULL;
 
   if (!AlarmIsActive (alarm)) return;
+#ifdef USE_TIMING_WHEEL
+  if (alm->counter->wheel) {
+    WheelRemove (alm);
+    goto finish;
+  }
+#endif
+  if (alm->status & ALARM_STATUS_PEER) {
+    /* alarm is behind a peer, the node stays in the queue */
+    alm->prev->peer = alm->peer;
+    if (alm->peer) alm->peer->prev = alm->prev;
+    goto finish;
+  }
+  if ((node = alm->peer)) {
+    /* The next peer takes over the node of alarm */
+    node->status &= (~((FlagType) ALARM_STATUS_PEER));
+    node->next = alm->next;
+    node->prev = alm->prev;
+    if (alm->next) alm->next->prev = node;
+  } else {
+    node = alm->next;
+    if (alm->next) alm->next->prev = alm->prev;
+  }
   if (alm->prev) {
     /* alarm is not the head of the queue */
-    alm->prev->next = alm->next;
+    alm->prev->next = node;
   } else {
     /* alarm is the head of the queue */
-    alm->counter->alarms = alm->next;
+    alm->counter->alarms = node;
   }
-  if (alm->next) alm->next->prev = alm->prev;
-  alm->next = alm->prev = NULL;
+
+finish:
+  alm->next = alm->prev = alm->peer = NULL;
   /* Clear alarm active bit */
-  alm->status &= (~((FlagType) ALARM_STATUS_ACTIVE));
+  alm->status &= (~((FlagType) (ALARM_STATUS_ACTIVE |
+                                ALARM_STATUS_PEER)));
 }
 
+#ifdef ALARM_QUEUES
 /**
  * @brief Perform alarm action
  *
@@ -206,18 +449,26 @@ DoAlarmAction (AlarmType alarm)
     case ALARM_ACTION_SETEVENT :
       DEBUG_PRINTFV ("Alarm %d, SetEvent (%d, %d)\n",
                      action->task, action->event);
-      Sys_SetEvent (action->task, action->event);
+      SYSPROF_COUNT (OSServiceId_SetEvent,
+                     Sys_SetEvent (action->task, action->event));
       break;
     case ALARM_ACTION_ACTIVATETASK :
       DEBUG_PRINTFV ("Alarm %d, ActivateTask (%d)\n",
                      alarm, action->task);
-      Sys_ActivateTask (action->task);
+      SYSPROF_COUNT (OSServiceId_ActivateTask,
+                     Sys_ActivateTask (action->task));
       break;
     case ALARM_ACTION_CALLBACK :
       DEBUG_PRINTFV ("Alarm %d, Calling callback\n", alarm);
       callback = action->callback;
       callback ();
       break;
+#ifdef TASK_TIMERS
+    case ALARM_ACTION_TIMEOUT :
+      DEBUG_PRINTFV ("Task %d timed out\n", action->task);
+      TaskTimeout (action->task);
+      break;
+#endif
     default :
       DEBUG_PRINTFV ("Unknow alarm action: %d\n",
                      action->type);
@@ -229,7 +480,6 @@ DoAlarmAction (AlarmType alarm)
  * @brief Increment alarm expiration time
  *
  * IncAlarm increments alarm expiration time by inc.
- * Overflow will be handled properly.
  *
  * @param[in] alarm
  *   Reference to an alarm
@@ -239,26 +489,16 @@ DoAlarmAction (AlarmType alarm)
 static void
 IncAlarm (AlarmType alarm, TickType inc)
 {
-  Counter * counter = alarms[alarm].counter;
-  TickType max = counter->properties.maxallowedvalue;
-
-  if (inc) {
-    /* Update next expiration time */
-    if ((max - inc) < alarms[alarm].exp) {
-      alarms[alarm].exp = inc - (max - alarms[alarm].exp) - 1;
-      ToggleAlarmOVF (alarm);
-    } else {
-      alarms[alarm].exp += inc;
-    }
-  }
+  /* Counter time wraps around at the TickType range */
+  alarms[alarm].exp += inc;
 }
+#endif
 
 /**
  * @brief Update alarm expiration time
  *
  * UpdateAlarm updates alarm expiration time according to
- * current counter count and inc. Overflow will be handled
- * properly.
+ * current counter time and inc.
  *
  * @param[in] alarm
  *   Reference to an alarm
@@ -270,29 +510,101 @@ IncAlarm (AlarmType alarm, TickType inc)
 static void
 UpdateAlarm (AlarmType alarm, TickType inc, TickType cycle)
 {
-  Counter * counter = alarms[alarm].counter;
-  TickType max = counter->properties.maxallowedvalue;
-
-  SetAlarmOVF (alarm);
   alarms[alarm].cycle = cycle;
+  alarms[alarm].exp = alarms[alarm].counter->ticks + inc;
+}
 
-  if (inc) {
-    /* Update next expiration time */
-    if ((max - inc) < counter->count) {
-      alarms[alarm].exp = inc - (max - counter->count) - 1;
-      ToggleAlarmOVF (alarm);
-    } else {
-      alarms[alarm].exp = counter->count + inc;
+#ifdef ALARM_QUEUES
+/**
+ * @brief Trigger the head node of an alarm queue
+ *
+ * FireAlarmNode triggers all the alarms sharing the node at
+ * the head of a counter alarm queue. The node is taken off
+ * the queue and all of its alarms are deactivated, then the
+ * actions are performed in the order the alarms were set.
+ * Deactivating the whole node first matters when an action
+ * stops another alarm of the node, e.g. SetEvent stopping
+ * the timer of the task it releases: the alarm is already
+ * off the queue, so RemoveAlarm leaves the node alone.
+ *
+ * Cyclic alarms with the same cycle expire together again.
+ * They are collected into one list which is put back into
+ * the queue with a single insertion.
+ *
+ * FireAlarmNode does not check whether the node expires.
+ * The caller is responsible for that. As with any alarm
+ * action, alarm callbacks are not allowed to use alarm
+ * services.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ */
+static void
+FireAlarmNode (Counter * counter)
+{
+  AlarmQueueType * alm = counter->alarms;
+  AlarmQueueType * next = NULL, * group = NULL, * last = NULL;
+  AlarmQueueType * cyclic = NULL, ** tail = &cyclic;
+
+  /* Take the node off the queue */
+  counter->alarms = alm->next;
+  if (alm->next) alm->next->prev = NULL;
+
+  /* Deactivate all the alarms of the node, keeping peer */
+  for (next = alm; next; next = next->peer) {
+    next->next = next->prev = NULL;
+    next->status &= (~((FlagType) (ALARM_STATUS_ACTIVE |
+                                   ALARM_STATUS_PEER)));
+  }
+
+  while (alm) {
+    next = alm->peer;
+    alm->peer = NULL;
+    TRACE (TRACE_ALARM, 0, alm->id, counter->count);
+    /* Perform alarm action */
+    LATENCY_ALARM_ACTION (TRUE);
+    DoAlarmAction (alm->id);
+    LATENCY_ALARM_ACTION (FALSE);
+    /* Keep cyclic alarms in order through peer */
+    if (alm->cycle) {
+      *tail = alm;
+      tail = &alm->peer;
     }
+    alm = next;
+  }
+
+  /* Activate cyclic alarms again, one insertion per cycle */
+  while (cyclic) {
+    group = last = cyclic;
+    cyclic = group->peer;
+    IncAlarm (group->id, group->cycle);
+
+    /* Move the alarms with the same cycle behind group */
+    tail = &cyclic;
+    while ((alm = *tail)) {
+      if (alm->cycle == group->cycle) {
+        *tail = alm->peer;
+        alm->exp = group->exp;
+        last->peer = alm;
+        last = alm;
+      } else {
+        tail = &alm->peer;
+      }
+    }
+    last->peer = NULL;
+
+    /* Put the alarms back into counter alarm queue */
+    QueueAlarms (group);
   }
 }
 
+#ifdef USE_TIMING_WHEEL
 /**
- * @brief Trigger an alarm
+ * @brief Trigger a timing wheel alarm
  *
- * FireAlarm triggers an alarm. It performs the action
- * specified by the alarm, deactivates it, and inserts it
- * back to alarm queue if it is cyclic.
+ * FireAlarm triggers an alarm of a timing wheel counter. It
+ * performs the action specified by the alarm, deactivates
+ * it, and inserts it back to the wheel if it is cyclic.
  *
  * FireAlarm does not check whether the alarm expires. The
  * caller is responsible for that.
@@ -303,25 +615,74 @@ UpdateAlarm (AlarmType alarm, TickType inc, TickType cycle)
 static void
 FireAlarm (AlarmType alarm)
 {
+  TRACE (TRACE_ALARM, 0, alarm, alarms[alarm].counter->count);
   /* Perform alarm action */
+  LATENCY_ALARM_ACTION (TRUE);
   DoAlarmAction (alarm);
-  /* Remove alarm from counter queue */
+  LATENCY_ALARM_ACTION (FALSE);
+  /* Remove alarm from timing wheel */
   RemoveAlarm (alarm);
 
   /* Activate alarm again if it is cyclic */
   if (alarms[alarm].cycle) {
     IncAlarm (alarm, alarms[alarm].cycle);
-    /* Put alarm back into counter alarm queue */
-    ActivateAlarm (alarm);
+    /* Relative to the tick being processed, not the count */
+    WheelInsert (&alarms[alarm], alarms[alarm].cycle);
+    alarms[alarm].status |= ALARM_STATUS_ACTIVE;
   }
 }
 
+/**
+ * @brief Trigger all expired alarms of a timing wheel counter
+ *
+ * CheckWheel advances the timing wheel of a counter tick by
+ * tick over the ticks of the last update. At each tick, the
+ * slots reached by the wheel time are cascaded from the
+ * highest level down and all the alarms left in the level 0
+ * slot expire.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ * @param[in] ticks
+ *   Ticks the counter count has been moved forward by
+ */
+static void
+CheckWheel (Counter * counter, TickType ticks)
+{
+  TimingWheelType * wheel = counter->wheel;
+  AlarmQueueType ** slot = NULL;
+  udata_word_t level = 0;
+
+  wheel->lag = ticks;
+
+  while (wheel->lag) {
+    wheel->lag--;
+    wheel->now = (wheel->now + 1) & WheelTimeMask (wheel);
+
+    /* Highest level with all lower digits wrapped around */
+    level = 0;
+    while (((level + 1) < wheel->levels) &&
+           !(wheel->now & WheelLowMask (level + 1))) {
+      level++;
+    }
+    for (; level > 0; level--) {
+      WheelCascade (wheel, level);
+    }
+
+    slot = &wheel->slots[wheel->now & (WHEEL_SLOTS - 1)];
+    while (*slot) {
+      FireAlarm ((*slot)->id);
+    }
+  }
+}
+#endif
+
 /**
  * @brief Trigger all expired alarms of a counter
  *
- * CheckAlarms iterates through all the alarms in a counter
+ * CheckAlarms iterates through the nodes in a counter
  * alarm queue and trigger all the expired alarms. (Not
- * every alarm in the queue is checked because they are
+ * every node in the queue is checked because they are
  * ordered.)
  *
  * @param[in] counter
@@ -330,69 +691,193 @@ FireAlarm (AlarmType alarm)
 static void
 CheckAlarms (Counter * counter)
 {
-  TickType max = counter->properties.maxallowedvalue;
-  TickType tpb = counter->properties.ticksperbase;
-  AlarmQueueType * queue = counter->alarms;
+  /* Stop at the first node not due */
+  while (counter->alarms &&
+         TickDue (counter, counter->alarms->exp)) {
+    FireAlarmNode (counter);
+  }
+}
+#endif
 
-  while (queue) {
-    if (CounterOVF (counter) == AlarmOVF (queue->id)) {
-      if (counter->count >= queue->exp) {
-        FireAlarm (queue->id);
-      } else {
-        break;
-      }
-    } else if ((max - queue->exp + counter->count + 1) < tpb) {
-      /* Should this ever happen? */
-      /*
-       * This is a special case when an alarm was set to
-       * between one counter update and this counter update
-       * happens to make the counter overflow.
-       */
-      FireAlarm (queue->id);
-    } else {
-      /*
-       * Otherwise, we can skip all the other alarms. Their
-       * expiration should be in the future.
-       */
-      break;
-    }
-    queue = counter->alarms;
+void
+UpdateNextEvent (Counter * counter, CounterTimeType tick)
+{
+  if (TickPos (counter, tick) < TickPos (counter, counter->next_tick)) {
+    counter->next_tick = tick;
   }
 }
 
-StatusType
-Sys_IncrementCounter (CounterType CounterID)
+/**
+ * @brief Recompute the next event tick of a counter
+ *
+ * ResetNextEvent finds the earliest expiration among the
+ * alarm queue and the running schedule tables of a
+ * counter. It is called after all the expired alarms and
+ * schedule table events have been processed.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ */
+static void
+ResetNextEvent (Counter * counter)
 {
-  StatusType ret = E_OK;
+  /* Nothing pending, stay inside the window of the counter */
+  counter->next_tick = counter->ticks +
+                       counter->properties.maxallowedvalue;
 
-#ifdef OSEK_EXTENDED
-  /* Is counter valid? */
-  ValidateCounter (CounterID);
+  /* Alarm queue is sorted, the head expires first */
+  if (counter->alarms) {
+    UpdateNextEvent (counter, counter->alarms->exp);
+  }
+
+#ifdef USE_SCHEDTBL
+  ScheduleTableNextEvent (counter);
 #endif
+}
 
-  Counter * counter = &counters[CounterID];
+TickType
+CounterTicksTo (Counter * counter, CounterTimeType tick)
+{
   TickType max = counter->properties.maxallowedvalue;
   TickType tpb = counter->properties.ticksperbase;
+  CounterTimeType dist = 0;
 
-  /* Update counter count by ticks per base */
-  if ((max - tpb) < counter->count) {
+  /* Event already due */
+  if (TickDue (counter, tick)) return 1;
+  dist = tick - counter->ticks;
+
+  /* Round up to whole counter updates */
+  dist = (dist / tpb) + ((dist % tpb) ? 1 : 0);
+  /* Waking up early is harmless */
+  return (dist > max) ? max : (TickType) dist;
+}
+
+/**
+ * @brief Move a counter count forward
+ *
+ * CountTicks adds ticks to the count and the time of a
+ * counter, and tells whether the next event tick of the
+ * counter has been reached.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ * @param[in] ticks
+ *   Ticks to add, at most maxallowedvalue
+ *
+ * @return
+ *   TRUE if alarms or schedule tables need to be checked
+ */
+static bool
+CountTicks (Counter * counter, TickType ticks)
+{
+  TickType max = counter->properties.maxallowedvalue;
+
+  counter->ticks += ticks;
+
+  if ((max - ticks) < counter->count) {
     /* Counter will overflow */
-    counter->count = tpb - (max - counter->count) -1;
-    /* Toggle the overflow bit */
-    ToggleCounterOVF (counter);
+    counter->count = ticks - (max - counter->count) -1;
   } else {
-    /* No counter overflow */
-    counter->count += tpb;
+    counter->count += ticks;
   }
 
+  return CounterEventDue (counter);
+}
+
+/**
+ * @brief Process all the expired events of a counter
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ */
+static void
+CheckEvents (Counter * counter)
+{
+#ifdef ALARM_QUEUES
   /* Now, check all alarms */
   CheckAlarms (counter);
+#endif
 
 #ifdef USE_SCHEDTBL
   /* Process all running schedule tables */
   CheckScheduleTables (counter);
 #endif
 
+  ResetNextEvent (counter);
+}
+
+/**
+ * @brief Increment a counter several times
+ *
+ * AdvanceCounter has the same effect as a number of calls
+ * to Sys_IncrementCounter, but only stops at the counter
+ * updates where an event is due. Each stop processes the
+ * expired alarms and schedule table events, which may arm
+ * new ones (e.g. cyclic alarms) inside the remaining window
+ * before the distance to the next stop is computed.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ * @param[in] updates
+ *   Number of counter updates
+ */
+static void
+AdvanceCounter (Counter * counter, TickType updates)
+{
+  TickType tpb = counter->properties.ticksperbase;
+  TickType limit = counter->properties.maxallowedvalue / tpb;
+  TickType step = 0;
+  bool due = FALSE;
+
+  while (updates) {
+    step = CounterTicksTo (counter, counter->next_tick);
+    if (step > updates) step = updates;
+    /* Less than one counter cycle at a time */
+    if (step > limit) step = limit;
+    updates -= step;
+
+    due = CountTicks (counter, step * tpb);
+
+#ifdef USE_TIMING_WHEEL
+    /* Timing wheels advance on every tick */
+    if (counter->wheel) CheckWheel (counter, step * tpb);
+#endif
+
+    if (due) CheckEvents (counter);
+  }
+}
+
+StatusType
+Sys_IncrementCounter (CounterType CounterID)
+{
+  StatusType ret = E_OK;
+
+#ifdef OSEK_EXTENDED
+  /* Is counter valid? */
+  ValidateCounter (CounterID);
+#endif
+
+  Counter * counter = &counters[CounterID];
+  TickType tpb = counter->properties.ticksperbase;
+  bool due = FALSE;
+
+  STATS_INC (counter_ticks);
+
+  /* Update counter count by ticks per base */
+  due = CountTicks (counter, tpb);
+
+#ifdef USE_TIMING_WHEEL
+  /* Timing wheels advance on every tick */
+  if (counter->wheel) CheckWheel (counter, tpb);
+#endif
+
+  if (due) {
+    CheckEvents (counter);
+  } else {
+    /* Nothing due before the next event tick */
+    STATS_INC (fast_ticks);
+  }
+
 #ifdef OSEK_EXTENDED
 std_ret:
 #endif
@@ -411,6 +896,45 @@ Sys_IncrementCounter_Preempt (CounterType CounterID)
   return ret;
 }
 
+StatusType
+Sys_IncrementCounterBy (CounterType CounterID,
+                        TickType Increments)
+{
+  StatusType ret = E_OK;
+
+#ifdef OSEK_EXTENDED
+  /* Is counter valid? */
+  ValidateCounter (CounterID);
+#endif
+
+  STATS_INC (counter_ticks);
+
+  /*
+   * Any number of increments is accepted in both standard
+   * and extended status. AdvanceCounter splits the window
+   * in steps of less than one counter cycle.
+   */
+  AdvanceCounter (&counters[CounterID], Increments);
+
+#ifdef OSEK_EXTENDED
+std_ret:
+#endif
+  SaveOSErrorService (OSServiceId_IncrementCounterBy,
+                      CounterID, Increments, 0);
+  ERRORHOOK (ret);
+  return ret;
+}
+
+StatusType
+Sys_IncrementCounterBy_Preempt (CounterType CounterID,
+                                TickType Increments)
+{
+  StatusType ret = E_OK;
+  ret = Sys_IncrementCounterBy (CounterID, Increments);
+  if (ret == E_OK) CheckPreemption (PREEMPT_SCHED);
+  return ret;
+}
+
 StatusType
 Sys_GetCounterValue (CounterType CounterID, TickRefType Value)
 {
@@ -520,10 +1044,155 @@ std_ret:
   return ret;
 }
 
+#ifdef TASK_TIMERS
+void
+StartTaskTimer (TaskType tid, CounterType CounterID, TickType ticks)
+{
+  AlarmType timer = TaskTimer (tid);
+  AlarmQueueType * alm = &alarms[timer];
+
+  RemoveAlarm (timer);
+
+  alm->id = timer;
+  alm->counter = &counters[CounterID];
+  alm->action.task = tid;
+  alm->action.type = ALARM_ACTION_TIMEOUT;
+  UpdateAlarm (timer, ticks, 0);
+  ActivateAlarm (timer);
+}
+
+void
+StopTaskTimer (TaskType tid)
+{
+  /*
+   * The counter next event tick is left as it is. Being
+   * early only costs one extra check of the alarm queue.
+   */
+  RemoveAlarm (TaskTimer (tid));
+}
+#endif
+
+#ifdef TICKLESS
+volatile bool tickless_idle = FALSE;
+
+#ifdef USE_TIMING_WHEEL
+/**
+ * @brief Number of counter updates until the wheel needs one
+ *
+ * WheelTicksTo returns the number of counter updates until
+ * the timing wheel of a counter reaches its next non-empty
+ * slot. For levels above 0 this is when the slot cascades,
+ * which is a lower bound of the alarm expiration.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ *
+ * @return
+ *   Counter updates to the next slot, 0 if the wheel is empty
+ */
+static TickType
+WheelTicksTo (Counter * counter)
+{
+  TimingWheelType * wheel = counter->wheel;
+  TickType max = counter->properties.maxallowedvalue;
+  TickType tpb = counter->properties.ticksperbase;
+  uint32_t digit = 0, dist = 0, i = 0;
+  udata_word_t level = 0;
+
+  for (level = 0; level < wheel->levels; level++) {
+    digit = wheel->now >> (level * WHEEL_SLOT_BITS);
+    for (i = 1; i < WHEEL_SLOTS; i++) {
+      if (!wheel->slots[(level << WHEEL_SLOT_BITS) +
+                        ((digit + i) & (WHEEL_SLOTS - 1))]) continue;
+      dist = (i << (level * WHEEL_SLOT_BITS)) -
+             (wheel->now & WheelLowMask (level));
+      dist = (dist / tpb) + ((dist % tpb) ? 1 : 0);
+      /* Waking up early is harmless */
+      return (dist > max) ? max : (TickType) dist;
+    }
+  }
+
+  return 0;
+}
+#endif
+
+void
+TicklessIdle (void)
+{
+  Counter * counter = &counters[SYS_COUNTER];
+  TickType ticks = 0;
+#ifdef USE_TIMING_WHEEL
+  TickType wheel_ticks = 0;
+#endif
+
+  /* Timer is still programmed if woken up by an ISR1 */
+  if (tickless_idle) return;
+
+  /* Alarm queue and schedule tables */
+  ticks = CounterTicksTo (counter, counter->next_tick);
+
+#ifdef USE_TIMING_WHEEL
+  if (counter->wheel) {
+    wheel_ticks = WheelTicksTo (counter);
+    if (wheel_ticks && (wheel_ticks < ticks)) ticks = wheel_ticks;
+  }
+#endif
+
+#ifdef TASK_STATS
+  /* Wake up before the cycle counter wraps around */
+  if ((!ticks) || (ticks > TaskStatsMaxTicks ())) {
+    ticks = TaskStatsMaxTicks ();
+  }
+#endif
+
+  /* Nothing to gain if the next tick is already due */
+  if (ticks == 1) return;
+
+  if (ArchTimerOneShot (ticks)) {
+    tickless_idle = TRUE;
+  }
+}
+
+void
+TicklessResume (void)
+{
+  TickType ticks = 0;
+
+  tickless_idle = FALSE;
+  ticks = ArchTimerResume ();
+
+  /* Catch up with all the suppressed counter updates */
+  AdvanceCounter (&counters[SYS_COUNTER], ticks);
+}
+#endif
+
 void
 TickHandler ()
 {
+#ifdef TASK_STATS
+  TaskStatsTick ();
+#endif
+#ifdef TICKLESS
+  if (tickless_idle) {
+    /* One-shot period expired, catch up with the counter */
+    TicklessResume ();
+#ifdef TIME_SLICING
+    TimeSliceTick ();
+#endif
+    return;
+  }
+#endif
+#ifdef CYCLIC_EXECUTIVE
+  /* No alarms on the system counter, only keep its count */
+  STATS_INC (counter_ticks);
+  CountTicks (&counters[SYS_COUNTER], 1);
+  CyclicTick ();
+#else
   Sys_IncrementCounter (SYS_COUNTER);
+#endif
+#ifdef TIME_SLICING
+  TimeSliceTick ();
+#endif
 }
 
 StatusType
@@ -531,7 +1200,7 @@ Sys_GetAlarmBase (AlarmType alarm, AlarmBaseRefType info)
 {
   StatusType ret = E_OK;
 
-#ifdef OSEK_EXTENDED
+#if defined OSEK_EXTENDED || !defined ALARM_QUEUES
   /* Is alarm valid? */
   ValidateAlarm (alarm);
 #endif
@@ -545,7 +1214,7 @@ Sys_GetAlarmBase (AlarmType alarm, AlarmBaseRefType info)
   info->ticksperbase = alm.counter->properties.ticksperbase;
   info->mincycle = alm.counter->properties.mincycle;
 
-#ifdef OSEK_EXTENDED
+#if defined OSEK_EXTENDED || !defined ALARM_QUEUES
 std_ret:
 #endif
   SaveOSErrorService (OSServiceId_GetAlarmBase, alarm, info, 0);
@@ -556,30 +1225,20 @@ std_ret:
 StatusType
 Sys_GetAlarm (AlarmType alarm, TickRefType tick)
 {
-  Counter * counter = NULL;
-  TickType max = 0;
   StatusType ret = E_OK;
 
-  if (!AlarmIsActive (alarm)) {
-    ret = E_OS_NOFUNC;
-    goto std_ret;
-  }
-
-#ifdef OSEK_EXTENDED
+#if defined OSEK_EXTENDED || !defined ALARM_QUEUES
   /* Is alarm valid? */
   ValidateAlarm (alarm);
 #endif
 
-  counter = alarms[alarm].counter;
-  max = counter->properties.maxallowedvalue;
-
-  if (alarms[alarm].exp > counter->count) {
-    *tick = alarms[alarm].exp - counter->count;
-  } else {
-    /* expiration time overflowed */
-    *tick = max - counter->count + alarms[alarm].exp + 1;
+  if (!AlarmIsActive (alarm)) {
+    ret = E_OS_NOFUNC;
+    goto std_ret;
   }
 
+  *tick = alarms[alarm].exp - alarms[alarm].counter->ticks;
+
 std_ret:
   SaveOSErrorService (OSServiceId_GetAlarm, alarm, tick, 0);
   ERRORHOOK (ret);
@@ -595,7 +1254,9 @@ Sys_SetRelAlarm (AlarmType alarm, TickType inc,
 #ifdef OSEK_EXTENDED
   Counter * counter = NULL;
   TickType max = 0, mcycle = 0;
+#endif
 
+#if defined OSEK_EXTENDED || !defined ALARM_QUEUES
   /* Is alarm valid? */
   ValidateAlarm (alarm);
 #endif
@@ -662,7 +1323,9 @@ Sys_SetAbsAlarm (AlarmType alarm, TickType start,
 #ifdef OSEK_EXTENDED
   Counter * counter = NULL;
   TickType max = 0, mcycle = 0;
+#endif
 
+#if defined OSEK_EXTENDED || !defined ALARM_QUEUES
   /* Is alarm valid? */
   ValidateAlarm (alarm);
 #endif
@@ -715,16 +1378,16 @@ Sys_CancelAlarm (AlarmType alarm)
 {
   StatusType ret = E_OK;
 
+#if defined OSEK_EXTENDED || !defined ALARM_QUEUES
+  /* Is alarm valid? */
+  ValidateAlarm (alarm);
+#endif
+
   if (!AlarmIsActive (alarm)) {
     ret = E_OS_NOFUNC;
     goto std_ret;
   }
 
-#ifdef OSEK_EXTENDED
-  /* Is alarm valid? */
-  ValidateAlarm (alarm);
-#endif
-
   RemoveAlarm (alarm);
 
 std_ret:
@@ -741,13 +1404,14 @@ AlarmInit ()
 
   /* Start auto-start alarms */
   for (i = 0; i < NUM_ALARMS; i++) {
-    if (auto_alarms[mode][i] == INVALID_ALARM) break;
+    /* Entries of alarms not started in this mode are invalid */
+    if (auto_alarms[mode][i] == INVALID_ALARM) continue;
     /*
-     * OVF bit of all the alarms should be 0 at this
-     * point. Which is the same as the counter OVF. Alarm
-     * properties (exp, cycle, action, etc.) should all
-     * have been properly initialized. As a result, calling
-     * SetAlarm is not necessary.
+     * Counter time starts at 0 like the count, so the
+     * expiration generated as a counter value is a valid
+     * counter time. Alarm properties (exp, cycle, action,
+     * etc.) should all have been properly initialized. As a
+     * result, calling SetAlarm is not necessary.
      *
      * ActivateAlarm just inserts the alarm into its queue
      * in expiration order. No early expiration will be
@@ -759,6 +1423,11 @@ AlarmInit ()
                    auto_alarms[mode][i]);
   }
 
+#ifdef CYCLIC_EXECUTIVE
+  /* Auto start alarms of SYS_COUNTER are in the table */
+  CyclicInit (mode);
+#endif
+
   ArchTimerInit ();
 }
 
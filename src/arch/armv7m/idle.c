@@ -23,6 +23,8 @@
  * @brief  Architectural Dependant Idle Loop
  */
 #include <arch/armv7m/barrier.h>
+#include <arch/armv7m/interrupt.h>
+#include <sdvos.h>
 
 /**
  * @brief Architectural dependant idle loop
@@ -30,11 +32,23 @@
  * WFI instruction is used to put system into sleep.
  * We do not use deep sleep since SYSTICK will stop in this
  * mode. See InterruptInit () for initialization.
+ *
+ * In tickless mode, PRIMASK is set while the system timer
+ * is reprogrammed. A pending interrupt still wakes up WFI
+ * and is taken as soon as PRIMASK is cleared again.
  */
 void
 IdleLoop ()
 {
-#ifdef __IDLE_WFI__
+#ifdef TICKLESS
+  while (1) {
+    __disable_irq ();
+    TicklessIdle ();
+    DSB ();
+    __asm__ volatile ("wfi\n\t");
+    __enable_irq ();
+  }
+#elif defined __IDLE_WFI__
   DSB ();
   while (1) __asm__ volatile ("wfi\n\t");
 #else
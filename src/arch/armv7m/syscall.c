@@ -41,6 +41,15 @@ code_addr_t * syscall_vectors[NUM_SYSCALLS] ALIGNED(32) = {
   (code_addr_t *) Sys_SetEvent_Preempt,
   (code_addr_t *) Sys_WaitEvent,
   (code_addr_t *) Sys_IncrementCounter_Preempt,
+  (code_addr_t *) Sys_IncrementCounterBy_Preempt,
+#ifdef TASK_TIMERS
+  (code_addr_t *) Sys_WaitEventTimeout,
+  (code_addr_t *) Sys_SleepTicks,
+#else
+  (code_addr_t *) NULL,
+  (code_addr_t *) NULL,
+#endif
+  (code_addr_t *) Sys_ActivateTaskSet_Preempt,
   (code_addr_t *) Sys_TerminateTask,
   (code_addr_t *) Sys_ChainTask,
   (code_addr_t *) Sys_GetTaskID,
@@ -75,9 +84,106 @@ code_addr_t * syscall_vectors[NUM_SYSCALLS] ALIGNED(32) = {
   (code_addr_t *) Sys_SyncScheduleTable,
   (code_addr_t *) Sys_SetScheduleTableAsync,
 #endif
+#endif
+  /*
+   * Entries of services not configured are left NULL.
+   * SvcHandler returns E_OS_SERVICEID for them.
+   */
+#ifdef TASK_STATS
+  [SVC_NO_GETTASKSTATS] = (code_addr_t *) Sys_GetTaskStats,
+#endif
+#ifdef LATENCY_HIST
+  [SVC_NO_GETLATENCYHIST] = (code_addr_t *) Sys_GetLatencyHist,
+#endif
+  [SVC_NO_GETCYCLECOUNT] = (code_addr_t *) Sys_GetCycleCount,
+#ifdef SYSCALL_PROF
+  [SVC_NO_GETSYSPROF] = (code_addr_t *) Sys_GetSysProf,
+#endif
+#ifdef STACK_MONITOR
+  [SVC_NO_GETSTACKUSAGE] = (code_addr_t *) Sys_GetStackUsage,
 #endif
 };
 
+#ifdef SYSCALL_PROF
+/**
+ * @brief Service IDs of system calls
+ *
+ * Service ID profiled for each SVC number. Services
+ * without an OSServiceId_* are not profiled.
+ */
+static const OSServiceIdType syscall_services[NUM_SYSCALLS] = {
+  [0 ... NUM_SYSCALLS - 1] = INVALID_SERVICE,
+  [SVC_NO_ACTIVATETASK] = OSServiceId_ActivateTask,
+  [SVC_NO_SCHEDULE] = OSServiceId_Schedule,
+  [SVC_NO_RELEASERESOURCE] = OSServiceId_ReleaseResource,
+  [SVC_NO_SETEVENT] = OSServiceId_SetEvent,
+  [SVC_NO_WAITEVENT] = OSServiceId_WaitEvent,
+  [SVC_NO_INCREMENTCOUNTER] = OSServiceId_IncrementCounter,
+  [SVC_NO_INCREMENTCOUNTERBY] = OSServiceId_IncrementCounterBy,
+  [SVC_NO_WAITEVENTTIMEOUT] = OSServiceId_WaitEventTimeout,
+  [SVC_NO_SLEEPTICKS] = OSServiceId_SleepTicks,
+  [SVC_NO_ACTIVATETASKSET] = OSServiceId_ActivateTaskSet,
+  [SVC_NO_TERMINATETASK] = OSServiceId_TerminateTask,
+  [SVC_NO_CHAINTASK] = OSServiceId_ChainTask,
+  [SVC_NO_GETTASKID] = OSServiceId_GetTaskID,
+  [SVC_NO_GETTASKSTATE] = OSServiceId_GetTaskState,
+  [SVC_NO_GETRESOURCE] = OSServiceId_GetResource,
+  [SVC_NO_CLEAREVENT] = OSServiceId_ClearEvent,
+  [SVC_NO_GETEVENT] = OSServiceId_GetEvent,
+  [SVC_NO_GETALARMBASE] = OSServiceId_GetAlarmBase,
+  [SVC_NO_GETALARM] = OSServiceId_GetAlarm,
+  [SVC_NO_SETRELALARM] = OSServiceId_SetRelAlarm,
+  [SVC_NO_SETABSALARM] = OSServiceId_SetAbsAlarm,
+  [SVC_NO_CANCELALARM] = OSServiceId_CancelAlarm,
+  [SVC_NO_GETCOUNTERVALUE] = OSServiceId_GetCounterValue,
+  [SVC_NO_GETELAPSEDVALUE] = OSServiceId_GetElapsedValue,
+  [SVC_NO_STARTSCHEDULETABLEREL] = OSServiceId_StartScheduleTableRel,
+  [SVC_NO_STARTSCHEDULETABLEABS] = OSServiceId_StartScheduleTableAbs,
+  [SVC_NO_STOPSCHEDULETABLE] = OSServiceId_StopScheduleTable,
+  [SVC_NO_NEXTSCHEDULETABLE] = OSServiceId_NextScheduleTable,
+  [SVC_NO_GETSCHEDULETABLESTATUS] = OSServiceId_GetScheduleTableStatus,
+  [SVC_NO_STARTSCHEDULETABLESYNCHRON] =
+    OSServiceId_StartScheduleTableSynchron,
+  [SVC_NO_SYNCSCHEDULETABLE] = OSServiceId_SyncScheduleTable,
+  [SVC_NO_SETSCHEDULETABLEASYNC] = OSServiceId_SetScheduleTableAsync,
+};
+
+/** Service ID of the system call being served */
+static OSServiceIdType syscall_service = INVALID_SERVICE;
+/** Whether the system call being served is timed */
+static bool syscall_timed = FALSE;
+
+/**
+ * @brief Record the entry of a system call
+ *
+ * Called by SvcHandler before the service function.
+ *
+ * @param[in] svc
+ *   SVC number
+ */
+void
+SysProfSvcEnter (uint32_t svc)
+{
+  syscall_service = syscall_services[svc];
+  syscall_timed = SysProfEnter (syscall_service);
+}
+
+/**
+ * @brief Record the return of a system call
+ *
+ * Called by SvcHandler if the service function returns
+ * without a context switch.
+ *
+ * @param[in] ret
+ *   Status returned by the service
+ */
+void
+SysProfSvcExit (StatusType ret)
+{
+  SysProfExit (syscall_service, ret, syscall_timed);
+}
+#endif
+
 /**
  * @brief Check whether we are in handler/kernel mode
  *
@@ -122,7 +228,9 @@ ActivateTask (TaskType tid)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_ActivateTask);
     ret = Sys_ActivateTask (tid);
+    SYSPROF_EXIT (OSServiceId_ActivateTask, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -134,12 +242,33 @@ ActivateTask (TaskType tid)
   return ret;
 }
 
+StatusType
+ActivateTaskSet (TaskSetRefType TaskSet)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_ActivateTaskSet);
+    ret = Sys_ActivateTaskSet (TaskSet);
+    SYSPROF_EXIT (OSServiceId_ActivateTaskSet, ret);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "svc %2\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (TaskSet), "I" (SVC_NO_ACTIVATETASKSET)
+                      :"r0");
+  }
+  return ret;
+}
+
 StatusType
 TerminateTask (void)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_TerminateTask);
     ret = Sys_TerminateTask ();
+    SYSPROF_EXIT (OSServiceId_TerminateTask, ret);
   } else {
     __asm__ volatile ("svc %1\n\t"
                       "mov %0, r0\n\t"
@@ -155,7 +284,9 @@ ChainTask (TaskType tid)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_ChainTask);
     ret = Sys_ChainTask (tid);
+    SYSPROF_EXIT (OSServiceId_ChainTask, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -172,7 +303,9 @@ Schedule (void)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_Schedule);
     ret = Sys_Schedule ();
+    SYSPROF_EXIT (OSServiceId_Schedule, ret);
   } else {
     __asm__ volatile ("svc %1\n\t"
                       "mov %0, r0\n\t"
@@ -188,7 +321,9 @@ GetTaskID (TaskRefType tid_ref)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetTaskID);
     ret = Sys_GetTaskID (tid_ref);
+    SYSPROF_EXIT (OSServiceId_GetTaskID, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -205,7 +340,9 @@ GetTaskState (TaskType tid, TaskStateRefType state_ref)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetTaskState);
     ret = Sys_GetTaskState (tid, state_ref);
+    SYSPROF_EXIT (OSServiceId_GetTaskState, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -302,7 +439,9 @@ GetResource (ResourceType rid)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetResource);
     ret = Sys_GetResource (rid);
+    SYSPROF_EXIT (OSServiceId_GetResource, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -319,7 +458,9 @@ ReleaseResource (ResourceType rid)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_ReleaseResource);
     ret = Sys_ReleaseResource (rid);
+    SYSPROF_EXIT (OSServiceId_ReleaseResource, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -336,7 +477,9 @@ SetEvent (TaskType tid, EventMaskType mask)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_SetEvent);
     ret = Sys_SetEvent (tid, mask);
+    SYSPROF_EXIT (OSServiceId_SetEvent, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -355,7 +498,9 @@ ClearEvent (EventMaskType mask)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_ClearEvent);
     ret = Sys_ClearEvent (mask);
+    SYSPROF_EXIT (OSServiceId_ClearEvent, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -372,7 +517,9 @@ GetEvent (TaskType tid, EventMaskRefType event)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetEvent);
     ret = Sys_GetEvent (tid, event);
+    SYSPROF_EXIT (OSServiceId_GetEvent, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -391,7 +538,9 @@ WaitEvent (EventMaskType mask)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_WaitEvent);
     ret = Sys_WaitEvent (mask);
+    SYSPROF_EXIT (OSServiceId_WaitEvent, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -408,7 +557,9 @@ GetAlarmBase (AlarmType alarm, AlarmBaseRefType info)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetAlarmBase);
     ret = Sys_GetAlarmBase (alarm, info);
+    SYSPROF_EXIT (OSServiceId_GetAlarmBase, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -427,7 +578,9 @@ GetAlarm (AlarmType alarm, TickRefType tick)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetAlarm);
     ret = Sys_GetAlarm (alarm, tick);
+    SYSPROF_EXIT (OSServiceId_GetAlarm, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -446,7 +599,9 @@ SetRelAlarm (AlarmType alarm, TickType inc, TickType cycle)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_SetRelAlarm);
     ret = Sys_SetRelAlarm (alarm, inc, cycle);
+    SYSPROF_EXIT (OSServiceId_SetRelAlarm, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -466,7 +621,9 @@ SetAbsAlarm (AlarmType alarm, TickType start, TickType cycle)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_SetAbsAlarm);
     ret = Sys_SetAbsAlarm (alarm, start, cycle);
+    SYSPROF_EXIT (OSServiceId_SetAbsAlarm, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -486,7 +643,9 @@ CancelAlarm (AlarmType alarm)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_CancelAlarm);
     ret = Sys_CancelAlarm (alarm);
+    SYSPROF_EXIT (OSServiceId_CancelAlarm, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -534,7 +693,9 @@ IncrementCounter (CounterType CounterID)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_IncrementCounter);
     ret = Sys_IncrementCounter (CounterID);
+    SYSPROF_EXIT (OSServiceId_IncrementCounter, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -546,12 +707,81 @@ IncrementCounter (CounterType CounterID)
   return ret;
 }
 
+StatusType
+IncrementCounterBy (CounterType CounterID, TickType Increments)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_IncrementCounterBy);
+    ret = Sys_IncrementCounterBy (CounterID, Increments);
+    SYSPROF_EXIT (OSServiceId_IncrementCounterBy, ret);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "mov r1, %2\n\t"
+                      "svc %3\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (CounterID), "l" (Increments),
+                       "I" (SVC_NO_INCREMENTCOUNTERBY)
+                      :"r0", "r1");
+  }
+  return ret;
+}
+
+#ifdef TASK_TIMERS
+StatusType
+WaitEventTimeout (EventMaskType Mask, CounterType CounterID,
+                  TickType Ticks)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_WaitEventTimeout);
+    ret = Sys_WaitEventTimeout (Mask, CounterID, Ticks);
+    SYSPROF_EXIT (OSServiceId_WaitEventTimeout, ret);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "mov r1, %2\n\t"
+                      "mov r2, %3\n\t"
+                      "svc %4\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (Mask), "l" (CounterID), "l" (Ticks),
+                       "I" (SVC_NO_WAITEVENTTIMEOUT)
+                      :"r0", "r1", "r2");
+  }
+  return ret;
+}
+
+StatusType
+SleepTicks (CounterType CounterID, TickType Ticks)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_SleepTicks);
+    ret = Sys_SleepTicks (CounterID, Ticks);
+    SYSPROF_EXIT (OSServiceId_SleepTicks, ret);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "mov r1, %2\n\t"
+                      "svc %3\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (CounterID), "l" (Ticks),
+                       "I" (SVC_NO_SLEEPTICKS)
+                      :"r0", "r1");
+  }
+  return ret;
+}
+#endif
+
 StatusType
 GetCounterValue (CounterType CounterID, TickRefType Value)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetCounterValue);
     ret = Sys_GetCounterValue (CounterID, Value);
+    SYSPROF_EXIT (OSServiceId_GetCounterValue, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -571,7 +801,9 @@ GetElapsedValue (CounterType CounterID, TickRefType Value,
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetElapsedValue);
     ret = Sys_GetElapsedValue (CounterID, Value, ElapsedValue);
+    SYSPROF_EXIT (OSServiceId_GetElapsedValue, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -594,7 +826,9 @@ StartScheduleTableRel (ScheduleTableType ScheduleTableID,
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_StartScheduleTableRel);
     ret = Sys_StartScheduleTableRel (ScheduleTableID, Offset);
+    SYSPROF_EXIT (OSServiceId_StartScheduleTableRel, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -614,7 +848,9 @@ StartScheduleTableAbs (ScheduleTableType ScheduleTableID,
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_StartScheduleTableAbs);
     ret = Sys_StartScheduleTableAbs (ScheduleTableID, Start);
+    SYSPROF_EXIT (OSServiceId_StartScheduleTableAbs, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -633,7 +869,9 @@ StopScheduleTable (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_StopScheduleTable);
     ret = Sys_StopScheduleTable (ScheduleTableID);
+    SYSPROF_EXIT (OSServiceId_StopScheduleTable, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -652,8 +890,10 @@ NextScheduleTable (ScheduleTableType ScheduleTableID_From,
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_NextScheduleTable);
     ret = Sys_NextScheduleTable (ScheduleTableID_From,
                                  ScheduleTableID_To);
+    SYSPROF_EXIT (OSServiceId_NextScheduleTable, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -675,8 +915,10 @@ GetScheduleTableStatus (
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_GetScheduleTableStatus);
     ret = Sys_GetScheduleTableStatus (ScheduleTableID,
                                       ScheduleStatus);
+    SYSPROF_EXIT (OSServiceId_GetScheduleTableStatus, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -697,7 +939,9 @@ StartScheduleTableSynchron (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_StartScheduleTableSynchron);
     ret = Sys_StartScheduleTableSynchron (ScheduleTableID);
+    SYSPROF_EXIT (OSServiceId_StartScheduleTableSynchron, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -716,7 +960,9 @@ SyncScheduleTable (ScheduleTableType ScheduleTableID,
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_SyncScheduleTable);
     ret = Sys_SyncScheduleTable (ScheduleTableID, Value);
+    SYSPROF_EXIT (OSServiceId_SyncScheduleTable, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "mov r1, %2\n\t"
@@ -735,7 +981,9 @@ SetScheduleTableAsync (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
   if (InKernel ()) {
+    SYSPROF_ENTER (OSServiceId_SetScheduleTableAsync);
     ret = Sys_SetScheduleTableAsync (ScheduleTableID);
+    SYSPROF_EXIT (OSServiceId_SetScheduleTableAsync, ret);
   } else {
     __asm__ volatile ("mov r0, %1\n\t"
                       "svc %2\n\t"
@@ -750,4 +998,106 @@ SetScheduleTableAsync (ScheduleTableType ScheduleTableID)
 #endif
 #endif
 
+#ifdef TASK_STATS
+StatusType
+GetTaskStats (TaskType TaskID, TaskStatsRefType Stats)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    ret = Sys_GetTaskStats (TaskID, Stats);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "mov r1, %2\n\t"
+                      "svc %3\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (TaskID), "l" (Stats),
+                       "I" (SVC_NO_GETTASKSTATS)
+                      :"r0", "r1");
+  }
+  return ret;
+}
+#endif
+
+#ifdef LATENCY_HIST
+StatusType
+GetLatencyHist (LatencyType Type, LatencyHistRefType Hist, bool Reset)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    ret = Sys_GetLatencyHist (Type, Hist, Reset);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "mov r1, %2\n\t"
+                      "mov r2, %3\n\t"
+                      "svc %4\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (Type), "l" (Hist), "l" (Reset),
+                       "I" (SVC_NO_GETLATENCYHIST)
+                      :"r0", "r1", "r2");
+  }
+  return ret;
+}
+#endif
+
+CycleType
+GetCycleCount ()
+{
+  CycleType count = 0;
+  if (InKernel ()) {
+    count = Sys_GetCycleCount ();
+  } else {
+    __asm__ volatile ("svc %1\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (count)
+                      :"I" (SVC_NO_GETCYCLECOUNT)
+                      :"r0");
+  }
+  return count;
+}
+
+#ifdef SYSCALL_PROF
+StatusType
+GetSysProf (OSServiceIdType ServiceID, SysProfRefType Prof, bool Reset)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    ret = Sys_GetSysProf (ServiceID, Prof, Reset);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "mov r1, %2\n\t"
+                      "mov r2, %3\n\t"
+                      "svc %4\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (ServiceID), "l" (Prof), "l" (Reset),
+                       "I" (SVC_NO_GETSYSPROF)
+                      :"r0", "r1", "r2");
+  }
+  return ret;
+}
+#endif
+
+#ifdef STACK_MONITOR
+StatusType
+GetStackUsage (TaskType StackID, StackUsageRefType Usage)
+{
+  StatusType ret = E_OK;
+  if (InKernel ()) {
+    ret = Sys_GetStackUsage (StackID, Usage);
+  } else {
+    __asm__ volatile ("mov r0, %1\n\t"
+                      "mov r1, %2\n\t"
+                      "svc %3\n\t"
+                      "mov %0, r0\n\t"
+                      :"=l" (ret)
+                      :"l" (StackID), "l" (Usage),
+                       "I" (SVC_NO_GETSTACKUSAGE)
+                      :"r0", "r1");
+  }
+  return ret;
+}
+#endif
+
 /* vi: set et ai sw=2 sts=2: */
@@ -26,11 +26,31 @@
 #include <arch/armv7m/scs.h>
 #include <arch/armv7m/utils.h>
 #include <arch/armv7m/atomic.h>
+#include <arch/armv7m/cycle.h>
 #include <cc.h>
 #include <sdvos.h>
+#include <config/config.h>
 
 extern uint32_t SysTick_ONESEC;
 
+/*
+ * SysTick cycles of one tick. SysTick counts from LOAD down
+ * to 0, so its period is LOAD + 1 cycles.
+ */
+static uint32_t tick_cycles = 0;
+
+/*
+ * SysTick cycles in TICKPERIOD_US given the cycles in one
+ * ms, rounded the same way as in sdvgen. Split in ms and us
+ * to avoid 64-bit division.
+ */
+static uint32_t
+TickCycles (uint32_t ms_cycles)
+{
+  return ms_cycles * (TICKPERIOD_US / 1000) +
+         (ms_cycles * (TICKPERIOD_US % 1000) + 500) / 1000;
+}
+
 void
 ArchTimerInit ()
 {
@@ -48,15 +68,14 @@ ArchTimerInit ()
 
   if (SysTick_ONESEC) {
     /* SysTick frequency available from board initialization */
-    rval = SysTick_ONESEC / 1000;
+    rval = TickCycles (SysTick_ONESEC / 1000);
   } else {
     if (SysTick->CALIB & SysTick_CALIB_NOREF) {
       /* No external reference clock (STCLK) */
       DEBUG_PRINTF ("No reference clock!\n");
     } else {
-      /* Set reload value (1ms by default) */
-      /* Read calibration value for 1 ms */
-      rval = SysTick->CALIB & SysTick_CALIB_TENMS / 10;
+      /* Scale calibration value for 10 ms */
+      rval = TickCycles ((SysTick->CALIB & SysTick_CALIB_TENMS) / 10);
 
 #ifdef DEBUG_SDVOS_VERBOSE
       if (SysTick->CALIB & SysTick_CALIB_SKEW) {
@@ -69,10 +88,14 @@ ArchTimerInit ()
   /* If calibration is not available, use config value */
   if (!rval) {
     DEBUG_PRINTF ("SysTick frequency not available!\n");
-    rval = SYSTICK_RELOAD_VALUE;
+    rval = SYSTICK_RELOAD_VALUE + 1;
   }
 
-  SysTick->LOAD = (rval & SysTick_LOAD_RELOAD);
+  if (rval > (SysTick_LOAD_RELOAD + 1)) {
+    rval = SysTick_LOAD_RELOAD + 1;
+  }
+  tick_cycles = rval;
+  SysTick->LOAD = tick_cycles - 1;
   DEBUG_PRINTFV ("SysTick reload value: 0x%X\n", SysTick->LOAD);
 
   /* Clear current value */
@@ -82,6 +105,99 @@ ArchTimerInit ()
                     SysTick_CTRL_TICKINT);
 }
 
+void
+ArchCycleInit ()
+{
+  CoreDebug_DEMCR |= CoreDebug_DEMCR_TRCENA;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+uint32_t
+ArchCycleFreq ()
+{
+  /* SysTick runs at HCLK / 8 on all the supported boards */
+  return SysTick_ONESEC << 3;
+}
+
+#ifdef TICKLESS
+/* Length in cycles and in ticks of the one-shot period */
+static uint32_t oneshot_cycles = 0;
+static uint32_t oneshot_ticks = 0;
+
+TickType
+ArchTimerOneShot (TickType ticks)
+{
+  uint32_t max = (SysTick_LOAD_RELOAD + 1) / tick_cycles;
+
+  if ((!ticks) || (ticks > max)) ticks = max;
+  /* Nothing to gain over the periodic tick */
+  if (ticks < 2) return 0;
+
+  /* Stop SysTick to get a stable current value */
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE;
+
+  if (SCB->ICSR & SCB_ICSR_PENDSTSET) {
+    /* A tick is pending, keep the periodic tick */
+    SysTick->CTRL |= SysTick_CTRL_ENABLE;
+    return 0;
+  }
+
+  /*
+   * Expire on the tick boundary "ticks" ticks from now. The
+   * current tick ends in VAL cycles.
+   */
+  oneshot_cycles = SysTick->VAL + (ticks - 1) * tick_cycles;
+  oneshot_ticks = ticks;
+  SysTick->LOAD = oneshot_cycles - 1;
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE;
+
+  return ticks;
+}
+
+TickType
+ArchTimerResume (void)
+{
+  uint32_t ctrl = 0, val = 0, elapsed = 0, ticks = 0;
+
+  /* Reading CTRL also clears COUNTFLAG */
+  ctrl = SysTick->CTRL;
+  SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE;
+  val = SysTick->VAL;
+
+  if (ctrl & SysTick_CTRL_COUNTFLAG) {
+    /* One-shot expired, SysTick restarted the period */
+    elapsed = val ? (oneshot_cycles - val) : 0;
+    ticks = oneshot_ticks + elapsed / tick_cycles;
+    val = tick_cycles - elapsed % tick_cycles;
+  } else {
+    /* Woken up early, val cycles left in the period */
+    ticks = oneshot_ticks - 1 - val / tick_cycles;
+    val %= tick_cycles;
+    if (!val) {
+      /* Right on a tick boundary */
+      ticks++;
+      val = tick_cycles;
+    }
+  }
+
+  if (val < 2) {
+    /* LOAD 0 would stop SysTick, count the tick now */
+    ticks++;
+    val += tick_cycles;
+  }
+
+  /* Finish the current tick, then go back to periodic */
+  SysTick->LOAD = val - 1;
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE;
+  SysTick->LOAD = tick_cycles - 1;
+
+  return ticks;
+}
+#endif
+
 /**
  * @brief Internal Tick Handler
  *
@@ -93,12 +209,17 @@ ArchTimerInit ()
  * is used to avoid compiler inlining the function for
  * optimization.
  */
+void NAKED SystickHandler (void);
+
 void NOINLINE
 _SystickHandler ()
 {
+  TRACE (TRACE_ISR_ENTER, 2, 0, SystickHandler);
+  LATENCY_ISR_ENTER ();
   uatomic_inc (&NestedISRs);
   TickHandler ();
   uatomic_dec (&NestedISRs);
+  TRACE (TRACE_ISR_EXIT, 2, 0, SystickHandler);
   CheckPreemption (PREEMPT_ISR);
 }
 
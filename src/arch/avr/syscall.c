@@ -38,11 +38,13 @@
  *
  * This prologue tests current task level interrupt status,
  * disables interrupt and set system processing level to
- * SYS_LV_SCHED.
+ * SYS_LV_SCHED. id is the OSServiceId_* of the service for
+ * the syscall profiler, or INVALID_SERVICE.
  */
-#define SysEnter()            \
+#define SysEnter(id)          \
   uint8_t IBit = TstI ();     \
-  __asm__ volatile ("cli")
+  __asm__ volatile ("cli");   \
+  SYSPROF_ENTER (id)
 
 /**
  * @def SysExit
@@ -50,22 +52,37 @@
  *
  * This epilogue restores system processing level to task
  * level and restores the original task level interrupt
- * status.
+ * status. ret is the status returned by the service.
  */
-#define SysExit()             \
+#define SysExit(id, ret)      \
+  SYSPROF_EXIT (id, ret);     \
   if (IBit)  __asm__ volatile ("sei")
 
 StatusType
 ActivateTask (TaskType tid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ActivateTask);
   if (NestedISRs) {
     ret = Sys_ActivateTask (tid);
   } else {
     ret = Sys_ActivateTask_Preempt (tid);
   }
-  SysExit ();
+  SysExit (OSServiceId_ActivateTask, ret);
+  return ret;
+}
+
+StatusType
+ActivateTaskSet (TaskSetRefType TaskSet)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_ActivateTaskSet);
+  if (NestedISRs) {
+    ret = Sys_ActivateTaskSet (TaskSet);
+  } else {
+    ret = Sys_ActivateTaskSet_Preempt (TaskSet);
+  }
+  SysExit (OSServiceId_ActivateTaskSet, ret);
   return ret;
 }
 
@@ -73,9 +90,9 @@ StatusType
 TerminateTask (void)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_TerminateTask);
   ret = Sys_TerminateTask ();
-  SysExit ();
+  SysExit (OSServiceId_TerminateTask, ret);
   return ret;
 }
 
@@ -83,9 +100,9 @@ StatusType
 ChainTask (TaskType tid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ChainTask);
   ret = Sys_ChainTask (tid);
-  SysExit ();
+  SysExit (OSServiceId_ChainTask, ret);
   return ret;
 }
 
@@ -93,9 +110,9 @@ StatusType
 Schedule (void)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_Schedule);
   ret = Sys_Schedule ();
-  SysExit ();
+  SysExit (OSServiceId_Schedule, ret);
   return ret;
 }
 
@@ -103,9 +120,9 @@ StatusType
 GetTaskID (TaskRefType tid_ref)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetTaskID);
   ret = Sys_GetTaskID (tid_ref);
-  SysExit ();
+  SysExit (OSServiceId_GetTaskID, ret);
   return ret;
 }
 
@@ -113,9 +130,9 @@ StatusType
 GetTaskState (TaskType tid, TaskStateRefType state_ref)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetTaskState);
   ret = Sys_GetTaskState (tid, state_ref);
-  SysExit ();
+  SysExit (OSServiceId_GetTaskState, ret);
   return ret;
 }
 
@@ -167,9 +184,9 @@ StatusType
 GetResource (ResourceType rid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetResource);
   ret = Sys_GetResource (rid);
-  SysExit ();
+  SysExit (OSServiceId_GetResource, ret);
   return ret;
 }
 
@@ -177,13 +194,13 @@ StatusType
 ReleaseResource (ResourceType rid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ReleaseResource);
   if (NestedISRs) {
     ret = Sys_ReleaseResource (rid);
   } else {
     ret = Sys_ReleaseResource_Preempt (rid);
   }
-  SysExit ();
+  SysExit (OSServiceId_ReleaseResource, ret);
   return ret;
 }
 
@@ -191,13 +208,13 @@ StatusType
 SetEvent (TaskType tid, EventMaskType mask)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetEvent);
   if (NestedISRs) {
     ret = Sys_SetEvent (tid, mask);
   } else {
     ret = Sys_SetEvent_Preempt (tid, mask);
   }
-  SysExit ();
+  SysExit (OSServiceId_SetEvent, ret);
   return ret;
 }
 
@@ -205,9 +222,9 @@ StatusType
 ClearEvent (EventMaskType mask)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ClearEvent);
   ret = Sys_ClearEvent (mask);
-  SysExit ();
+  SysExit (OSServiceId_ClearEvent, ret);
   return ret;
 }
 
@@ -215,9 +232,9 @@ StatusType
 GetEvent (TaskType tid, EventMaskRefType event)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetEvent);
   ret = Sys_GetEvent (tid, event);
-  SysExit ();
+  SysExit (OSServiceId_GetEvent, ret);
   return ret;
 }
 
@@ -225,9 +242,9 @@ StatusType
 WaitEvent (EventMaskType mask)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_WaitEvent);
   ret = Sys_WaitEvent (mask);
-  SysExit ();
+  SysExit (OSServiceId_WaitEvent, ret);
   return ret;
 }
 
@@ -235,9 +252,9 @@ StatusType
 GetAlarmBase (AlarmType alarm, AlarmBaseRefType info)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetAlarmBase);
   ret = Sys_GetAlarmBase (alarm, info);
-  SysExit ();
+  SysExit (OSServiceId_GetAlarmBase, ret);
   return ret;
 }
 
@@ -245,9 +262,9 @@ StatusType
 GetAlarm (AlarmType alarm, TickRefType tick)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetAlarm);
   ret = Sys_GetAlarm (alarm, tick);
-  SysExit ();
+  SysExit (OSServiceId_GetAlarm, ret);
   return ret;
 }
 
@@ -255,9 +272,9 @@ StatusType
 SetRelAlarm (AlarmType alarm, TickType inc, TickType cycle)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetRelAlarm);
   ret = Sys_SetRelAlarm (alarm, inc, cycle);
-  SysExit ();
+  SysExit (OSServiceId_SetRelAlarm, ret);
   return ret;
 }
 
@@ -265,9 +282,9 @@ StatusType
 SetAbsAlarm (AlarmType alarm, TickType start, TickType cycle)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetAbsAlarm);
   ret = Sys_SetAbsAlarm (alarm, start, cycle);
-  SysExit ();
+  SysExit (OSServiceId_SetAbsAlarm, ret);
   return ret;
 }
 
@@ -275,9 +292,9 @@ StatusType
 CancelAlarm (AlarmType alarm)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_CancelAlarm);
   ret = Sys_CancelAlarm (alarm);
-  SysExit ();
+  SysExit (OSServiceId_CancelAlarm, ret);
   return ret;
 }
 
@@ -291,23 +308,60 @@ StatusType
 IncrementCounter (CounterType CounterID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_IncrementCounter);
   if (NestedISRs) {
     ret = Sys_IncrementCounter (CounterID);
   } else {
     ret = Sys_IncrementCounter_Preempt (CounterID);
   }
-  SysExit ();
+  SysExit (OSServiceId_IncrementCounter, ret);
+  return ret;
+}
+
+StatusType
+IncrementCounterBy (CounterType CounterID, TickType Increments)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_IncrementCounterBy);
+  if (NestedISRs) {
+    ret = Sys_IncrementCounterBy (CounterID, Increments);
+  } else {
+    ret = Sys_IncrementCounterBy_Preempt (CounterID, Increments);
+  }
+  SysExit (OSServiceId_IncrementCounterBy, ret);
   return ret;
 }
 
+#ifdef TASK_TIMERS
+StatusType
+WaitEventTimeout (EventMaskType Mask, CounterType CounterID,
+                  TickType Ticks)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_WaitEventTimeout);
+  ret = Sys_WaitEventTimeout (Mask, CounterID, Ticks);
+  SysExit (OSServiceId_WaitEventTimeout, ret);
+  return ret;
+}
+
+StatusType
+SleepTicks (CounterType CounterID, TickType Ticks)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_SleepTicks);
+  ret = Sys_SleepTicks (CounterID, Ticks);
+  SysExit (OSServiceId_SleepTicks, ret);
+  return ret;
+}
+#endif
+
 StatusType
 GetCounterValue (CounterType CounterID, TickRefType Value)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetCounterValue);
   ret = Sys_GetCounterValue (CounterID, Value);
-  SysExit ();
+  SysExit (OSServiceId_GetCounterValue, ret);
   return ret;
 }
 
@@ -316,9 +370,9 @@ GetElapsedValue (CounterType CounterID, TickRefType Value,
                  TickRefType ElapsedValue)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetElapsedValue);
   ret = Sys_GetElapsedValue (CounterID, Value, ElapsedValue);
-  SysExit ();
+  SysExit (OSServiceId_GetElapsedValue, ret);
   return ret;
 }
 
@@ -328,9 +382,9 @@ StartScheduleTableRel (ScheduleTableType ScheduleTableID,
                        TickType Offset)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StartScheduleTableRel);
   ret = Sys_StartScheduleTableRel (ScheduleTableID, Offset);
-  SysExit ();
+  SysExit (OSServiceId_StartScheduleTableRel, ret);
   return ret;
 }
 
@@ -339,9 +393,9 @@ StartScheduleTableAbs (ScheduleTableType ScheduleTableID,
                        TickType Start)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StartScheduleTableAbs);
   ret = Sys_StartScheduleTableAbs (ScheduleTableID, Start);
-  SysExit ();
+  SysExit (OSServiceId_StartScheduleTableAbs, ret);
   return ret;
 }
 
@@ -349,9 +403,9 @@ StatusType
 StopScheduleTable (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StopScheduleTable);
   ret = Sys_StopScheduleTable (ScheduleTableID);
-  SysExit ();
+  SysExit (OSServiceId_StopScheduleTable, ret);
   return ret;
 }
 
@@ -360,10 +414,10 @@ NextScheduleTable (ScheduleTableType ScheduleTableID_From,
                    ScheduleTableType ScheduleTableID_To)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_NextScheduleTable);
   ret = Sys_NextScheduleTable (ScheduleTableID_From,
                                ScheduleTableID_To);
-  SysExit ();
+  SysExit (OSServiceId_NextScheduleTable, ret);
   return ret;
 }
 
@@ -372,9 +426,9 @@ StatusType
 StartScheduleTableSynchron (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StartScheduleTableSynchron);
   ret = Sys_StartScheduleTableSynchron (ScheduleTableID);
-  SysExit ();
+  SysExit (OSServiceId_StartScheduleTableSynchron, ret);
   return ret;
 }
 
@@ -383,9 +437,9 @@ SyncScheduleTable (ScheduleTableType ScheduleTableID,
                    TickType Value)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SyncScheduleTable);
   ret = Sys_SyncScheduleTable (ScheduleTableID, Value);
-  SysExit ();
+  SysExit (OSServiceId_SyncScheduleTable, ret);
   return ret;
 }
 
@@ -393,9 +447,9 @@ StatusType
 SetScheduleTableAsync (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetScheduleTableAsync);
   ret = Sys_SetScheduleTableAsync (ScheduleTableID);
-  SysExit ();
+  SysExit (OSServiceId_SetScheduleTableAsync, ret);
   return ret;
 }
 #endif
@@ -406,9 +460,57 @@ GetScheduleTableStatus (
   ScheduleTableStatusRefType ScheduleStatus)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetScheduleTableStatus);
   ret = Sys_GetScheduleTableStatus (ScheduleTableID, ScheduleStatus);
-  SysExit ();
+  SysExit (OSServiceId_GetScheduleTableStatus, ret);
+  return ret;
+}
+#endif
+
+#ifdef TASK_STATS
+StatusType
+GetTaskStats (TaskType TaskID, TaskStatsRefType Stats)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetTaskStats (TaskID, Stats);
+  SysExit (INVALID_SERVICE, ret);
+  return ret;
+}
+#endif
+
+#ifdef LATENCY_HIST
+StatusType
+GetLatencyHist (LatencyType Type, LatencyHistRefType Hist, bool Reset)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetLatencyHist (Type, Hist, Reset);
+  SysExit (INVALID_SERVICE, ret);
+  return ret;
+}
+#endif
+
+#ifdef SYSCALL_PROF
+StatusType
+GetSysProf (OSServiceIdType ServiceID, SysProfRefType Prof, bool Reset)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetSysProf (ServiceID, Prof, Reset);
+  SysExit (INVALID_SERVICE, ret);
+  return ret;
+}
+#endif
+
+#ifdef STACK_MONITOR
+StatusType
+GetStackUsage (TaskType StackID, StackUsageRefType Usage)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetStackUsage (StackID, Usage);
+  SysExit (INVALID_SERVICE, ret);
   return ret;
 }
 #endif
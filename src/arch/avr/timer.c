@@ -25,7 +25,78 @@
 #include <arch/avr/io.h>
 #include <arch/avr/vector.h>
 #include <arch/avr/interrupt.h>
+#include <arch/avr/atomic.h>
+#include <arch/avr/cycle.h>
 #include <sdvos.h>
+#include <config/config.h>
+
+#ifdef TICKLESS
+#error "TICKLESS is not supported on AVR yet!"
+#endif
+
+/*
+ * Timer 1 cycles in one tick with prescaler pre, rounded the
+ * same way as in sdvgen. Timer 1 is 16-bit, so the smallest
+ * prescaler that fits gives the best resolution.
+ */
+#define TICK_CYCLES(pre)                                      \
+  ((1ULL * (F_CPU) * TICKPERIOD_US + 500000ULL * (pre)) /    \
+   (1000000ULL * (pre)))
+
+#if TICK_CYCLES (1) <= 0x10000
+#define TICK_OCR        (TICK_CYCLES (1) - 1)
+#define TICK_CS         (1 << CS10)
+#define TICK_PRESCALE   1UL
+#elif TICK_CYCLES (8) <= 0x10000
+#define TICK_OCR        (TICK_CYCLES (8) - 1)
+#define TICK_CS         (1 << CS11)
+#define TICK_PRESCALE   8UL
+#elif TICK_CYCLES (64) <= 0x10000
+#define TICK_OCR        (TICK_CYCLES (64) - 1)
+#define TICK_CS         ((1 << CS11) | (1 << CS10))
+#define TICK_PRESCALE   64UL
+#elif TICK_CYCLES (256) <= 0x10000
+#define TICK_OCR        (TICK_CYCLES (256) - 1)
+#define TICK_CS         (1 << CS12)
+#define TICK_PRESCALE   256UL
+#elif TICK_CYCLES (1024) <= 0x10000
+#define TICK_OCR        (TICK_CYCLES (1024) - 1)
+#define TICK_CS         ((1 << CS12) | (1 << CS10))
+#define TICK_PRESCALE   1024UL
+#else
+#error "TICKPERIOD_US too long for Timer 1!"
+#endif
+
+#if TICK_CYCLES (1) == 0
+#error "TICKPERIOD_US too short for Timer 1!"
+#endif
+
+/* Timer 1 cycles counted up to the last tick */
+static volatile uint32_t tick_cycles = 0;
+
+uint32_t
+ArchCycleFreq ()
+{
+  return F_CPU / TICK_PRESCALE;
+}
+
+uint32_t
+ArchCycleCount ()
+{
+  uint32_t cycles = 0;
+  uint16_t count = 0;
+
+  EnterExcl ();
+  count = TCNT1;
+  cycles = tick_cycles;
+  /* Compare match not handled yet, count restarted from 0 */
+  if ((TIFR1 & (1 << OCF1A)) && (count < TICK_OCR)) {
+    cycles += TICK_OCR + 1;
+  }
+  ExitExcl ();
+
+  return cycles + count;
+}
 
 void
 ArchTimerInit ()
@@ -34,15 +105,16 @@ ArchTimerInit ()
   TCCR1B = 0;
 
   /*
-   * For 16MHz Processor:
+   * In CTC mode, Timer 1 counts from 0 to OCR1A, so one tick
+   * is OCR1A + 1 prescaled cycles. For 16MHz Processor:
    *
    * --------------------------------
    * | OCR1A  |  Prescale  |  Tick  |
    * --------------------------------
-   * | 15624  |  1024      |  1s    |
-   * | 625    |  256       |  10ms  |
-   * | 250    |  64        |  1ms   |
-   * | 2      |  8         |  1us   |
+   * | 1599   |  1         |  100us |
+   * | 15999  |  1         |  1ms   |
+   * | 19999  |  8         |  10ms  |
+   * | 62499  |  256       |  1s    |
    * --------------------------------
    *
    * ---------------------------------
@@ -54,37 +126,16 @@ ArchTimerInit ()
    * | 256       |  1     0     0    |
    * | 1024      |  1     0     1    |
    * ---------------------------------
-   *
-   * For 1MHz Internal Oscillator:
-   *
-   * --------------------------------
-   * | OCR1A  |  Prescale  |  Tick  |
-   * --------------------------------
-   * | 125    |  8         |  1ms   |
-   * ---------------------------------
    */
 
-#if F_CPU == 16000000UL
   /* set compare match register to desired timer count */
-  OCR1A = 250;
+  OCR1A = TICK_OCR;
   /* turn on CTC mode */
   TCCR1B |= (1 << WGM12);
   /* Enable Timer Compare Interrupt */
   TIMSK1 = (1 << OCIE1A);
   /* Set prescale */
-  TCCR1B |= (1 << CS11) | (1 << CS10);
-#elif F_CPU == 1000000UL
-  /* set compare match register to desired timer count */
-  OCR1A = 125;
-  /* turn on CTC mode */
-  TCCR1B |= (1 << WGM12);
-  /* Enable Timer Compare Interrupt */
-  TIMSK1 = (1 << OCIE1A);
-  /* Set prescale */
-  TCCR1B |= (1 << CS11);
-#else
-#error F_CPU not supported!
-#endif
+  TCCR1B |= TICK_CS;
 }
 
 /*
@@ -95,6 +146,7 @@ ArchTimerInit ()
  */
 ISR (TIMER1_COMPA_vect)
 {
+  tick_cycles += TICK_OCR + 1;
   TickHandler ();
 }
 
@@ -52,4 +52,24 @@ sdvos_memset (void * dst, udata_word_t ch, udata_word_t count)
                     ::"x" (dst), "a" (ch), "a" (count));
 }
 
+/* Index of the most significant set bit of a nibble */
+static const uint8_t nibble_msb[16] = {
+  0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+};
+
+uint8_t
+HighestBit (PrioMapType map)
+{
+  uint8_t b = (uint8_t) (map >> 8);
+  uint8_t base = 8;
+
+  if (!b) {
+    b = (uint8_t) map;
+    base = 0;
+  }
+
+  if (b & 0xF0) return base + 4 + nibble_msb[b >> 4];
+  return base + nibble_msb[b];
+}
+
 /* vi: set et ai sw=2 sts=2: */
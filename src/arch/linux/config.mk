@@ -0,0 +1,39 @@
+# Architecture specific configuration for Linux
+CFG += -D__ARCH_LINUX__
+# SRAM_END is only used to calculate offsets
+CFG += -DARCH_SRAM_END=0x20000000
+CFG += -DKERN_STK_SIZE=0x0
+CFG += -DIDLE_STK_SIZE=0x1000
+# Room for signal frames added to every stack
+CFG += -DSIG_STK_SIZE=0x4000
+# Switch tasks with ucontext instead of arch/linux/context.S
+#CFG += -DLINUX_UCONTEXT
+# Skip idle time and speed up the tick (see arch/linux/timer.h)
+#CFG += -DLINUX_VIRTUAL_TIME -DTICKLESS
+
+# Objects specific for Linux
+OBJ += arch/linux/task.o
+OBJ += arch/linux/context.o
+OBJ += arch/linux/panic.o
+OBJ += arch/linux/interrupt.o
+OBJ += arch/linux/syscall.o
+OBJ += arch/linux/timer.o
+OBJ += arch/linux/idle.o
+OBJ += arch/linux/utils.o
+OBJ += arch/linux/mcu.o
+#OBJ += drivers/usart/linux_usart.o
+
+# Tool Chain Flags and Defs
+CC = gcc
+LD = $(CC)
+LIBS = -lrt
+OBJDUMP = objdump
+OBJDUMP_FLAGS = -S
+SIZE = size
+OBJCPY = objcopy
+OBJCPY_FLAGS = -O ihex
+BIN = $(PROGRAM).hex
+DIS = $(PROGRAM)_hex.dis
+
+# Command to upload the binary to the board
+UPLOAD_COMMAND = ./sdvos
@@ -22,14 +22,47 @@
  * @author Ye Li (liye@sdvos.org)
  * @brief  Architectural Dependant Idle Loop
  */
+#include <sdvos.h>
+#include <arch/linux/interrupt.h>
+#include <arch/linux/timer.h>
+#include <signal.h>
 
 /**
  * @brief Architectural dependant idle loop
+ *
+ * Interrupts are disabled while the next wakeup is decided.
+ * Signals are then blocked only to check for pending
+ * interrupts, and sigsuspend atomically unblocks them and
+ * puts the process to sleep, so that no tick is lost
+ * between the two. Whatever woke the process up is
+ * delivered when interrupts are enabled again.
+ *
+ * In virtual time, the process never sleeps. Time skips
+ * to the next event instead (see LinuxVirtualIdle).
  */
 void
 IdleLoop ()
 {
-  while (1) __asm__ volatile ("pause");
+#ifndef LINUX_VIRTUAL_TIME
+  sigset_t set, oset;
+
+  sigfillset (&set);
+#endif
+
+  while (1) {
+    ArchDisableAllInterrupts ();
+#ifdef TICKLESS
+    TicklessIdle ();
+#endif
+#ifdef LINUX_VIRTUAL_TIME
+    LinuxVirtualIdle ();
+#else
+    sigprocmask (SIG_SETMASK, &set, &oset);
+    if (!linux_irq_pending) sigsuspend (&oset);
+    sigprocmask (SIG_SETMASK, &oset, NULL);
+#endif
+    ArchEnableAllInterrupts ();
+  }
 }
 
 /* vi: set et ai sw=2 sts=2: */
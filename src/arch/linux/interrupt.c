@@ -23,6 +23,102 @@
  * @brief  Linux Interrupt Management
  */
 #include <arch/linux/interrupt.h>
+#include <arch/linux/timer.h>
+
+volatile bool linux_irq_disabled = TRUE;
+volatile uatomic_t linux_irq_pending = ATOMIC_INIT (0);
+
+/* Interrupt entries indexed by signal number */
+static void (* linux_vectors[LINUX_NUM_VECTORS]) (int);
+
+/**
+ * @brief Run the interrupt entry of a signal
+ *
+ * Interrupts are disabled while the entry runs. If the
+ * entry switches to another task, interrupts are enabled
+ * again only when the preempted task returns here.
+ *
+ * @param[in] signo
+ *   Signal number
+ */
+static void
+DispatchInterrupt (int signo)
+{
+  ArchDisableAllInterrupts ();
+  linux_vectors[signo] (signo);
+  __asm__ volatile ("" ::: "memory");
+  linux_irq_disabled = FALSE;
+}
+
+/**
+ * @brief Common signal handler of all interrupt vectors
+ *
+ * The signal mask is never changed, not even while the
+ * handler runs. Task contexts do not save the signal mask
+ * and an ISR may switch to another task. A signal arriving
+ * while an ISR runs finds interrupts disabled and is only
+ * recorded.
+ *
+ * @param[in] signo
+ *   Signal number
+ */
+static void
+SignalHandler (int signo)
+{
+  if (linux_irq_disabled) {
+    /* Deliver when interrupts are enabled again */
+    uatomic_or (&linux_irq_pending, 0x1UL << signo);
+    return;
+  }
+
+  DispatchInterrupt (signo);
+  /* Signals received by the ISR itself */
+  if (linux_irq_pending) LinuxReplayInterrupts ();
+}
+
+void
+LinuxInstallVector (int vector, void (* entry) (int))
+{
+  struct sigaction act;
+
+  if ((vector <= 0) || (vector >= LINUX_NUM_VECTORS)) {
+    panic ();
+  }
+
+  linux_vectors[vector] = entry;
+
+  act.sa_handler = SignalHandler;
+  sigemptyset (&act.sa_mask);
+  act.sa_flags = SA_NODEFER;
+  if (sigaction (vector, &act, NULL) < 0) {
+    panic ();
+  }
+}
+
+void
+LinuxReplayInterrupts ()
+{
+  int signo = 0;
+
+  /*
+   * Bits are only set while interrupts are disabled. Each
+   * signal is picked with interrupts disabled, otherwise a
+   * nested ISR could deliver (and clear) it in between. The
+   * pending word is checked again after interrupts are
+   * enabled, for a signal recorded right before that.
+   */
+  do {
+    ArchDisableAllInterrupts ();
+    while (linux_irq_pending) {
+      signo = __builtin_ctz (linux_irq_pending);
+      uatomic_and (&linux_irq_pending, ~(0x1UL << signo));
+      DispatchInterrupt (signo);
+      ArchDisableAllInterrupts ();
+    }
+    __asm__ volatile ("" ::: "memory");
+    linux_irq_disabled = FALSE;
+  } while (linux_irq_pending);
+}
 
 void
 InterruptInit ()
@@ -30,8 +126,11 @@ InterruptInit ()
   /* Nothing to do */
 }
 
-ISR (SIGALRM)
+ISR (LINUX_TICK_VECTOR)
 {
+#ifdef LINUX_VIRTUAL_TIME
+  LinuxVirtualTick ();
+#endif
   TickHandler ();
 }
 
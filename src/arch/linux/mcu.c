@@ -24,7 +24,7 @@
  */
 #include <arch/linux/mcu.h>
 #include <arch/linux/task.h>
-#include <ucontext.h>
+#include <arch/linux/interrupt.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <task.h>
@@ -33,54 +33,102 @@
 #include <termios.h>
 #include <unistd.h>
 
+/* Alignment of the task stack pool */
+#define LINUX_STACK_POOL_ALIGN    0x1000
+
 void * linux_stack_pool = NULL;
 static struct termios termios_old, termios_new;
 
+/* Put the terminal back when the process exits */
+static void
+termios_reset (void)
+{
+  tcsetattr (STDIN_FILENO, TCSANOW, &termios_old);
+}
+
 void
 termios_restore ()
 {
-  tcsetattr (STDIN_FILENO, TCSANOW, &termios_old);
   exit (0);
 }
 
+#ifdef KERNEL_TRACE
+/*
+ * Write the trace buffer at exit. The file is a raw copy of
+ * kernel_trace, the same as a memory dump on MCU boards.
+ */
+static void
+TraceDump (void)
+{
+  const char * name = getenv ("SDVOS_TRACE_FILE");
+  FILE * fp = NULL;
+
+  if (!name) name = "sdvos.trace";
+  if (!(fp = fopen (name, "wb"))) return;
+  fwrite (&kernel_trace, sizeof (kernel_trace), 1, fp);
+  fclose (fp);
+}
+#endif
+
 void
 McuInit ()
 {
-  int i = 0, total_stk = 0;
-  sigset_t sigset;
+  int i = 0, j = 0;
+  data_addr_t total_stk = 0, pool_end = 0;
+  data_addr_t shift[NUM_TASKS];
   struct sigaction act;
 
-  /* Disable all signals */
-  sigfillset (&sigset);
-  sigprocmask (SIG_SETMASK, &sigset, NULL);
+  /* Disable all interrupts */
+  ArchDisableAllInterrupts ();
 
-  /* Set up stack pool */
+  /*
+   * Set up stack pool. Signal handlers (ISRs) run on the
+   * stack of the interrupted task, and a signal frame takes
+   * several KB on x86-64. Every stack gets SIG_STK_SIZE
+   * extra bytes for that, the layout of the configuration
+   * is kept otherwise.
+   */
   for (i = 0; i < NUM_TASKS; i++) {
-    total_stk += (tasks[i].sp - tasks[i].sp_end);
+    total_stk += (tasks[i].sp - tasks[i].sp_end) + SIG_STK_SIZE;
+    shift[i] = 0;
+    for (j = 0; j < NUM_TASKS; j++) {
+      if (tasks[j].sp > tasks[i].sp) shift[i] += SIG_STK_SIZE;
+    }
   }
-  /* 4K align stack pool */
-  linux_stack_pool = malloc ((total_stk + 0xFFF) & 0xFFFFF000);
+  /* 4K align stack pool (both base and size) */
+  total_stk = (total_stk + LINUX_STACK_POOL_ALIGN - 1) &
+              ~((data_addr_t) LINUX_STACK_POOL_ALIGN - 1);
+  if (posix_memalign (&linux_stack_pool, LINUX_STACK_POOL_ALIGN,
+                      total_stk) != 0) {
+    exit (1);
+  }
+  pool_end = (data_addr_t) linux_stack_pool + total_stk;
   for (i = 0; i < NUM_TASKS; i++) {
-    tasks[i].sp = (data_addr_t) linux_stack_pool +
-                  ((total_stk + 0xFFF) & 0xFFFFF000) -
-                  (SRAM_END - tasks[i].sp);
+    tasks[i].sp = pool_end - (SRAM_END - tasks[i].sp) - shift[i];
     tasks[i].bp = tasks[i].sp;
-    tasks[i].sp_end = (data_addr_t) linux_stack_pool +
-                      ((total_stk + 0xFFF) & 0xFFFFF000) -
-                      (SRAM_END - tasks[i].sp_end);
+    tasks[i].sp_end = pool_end - (SRAM_END - tasks[i].sp_end) -
+                      shift[i] - SIG_STK_SIZE;
   }
 
-  if (tcgetattr (STDIN_FILENO, &termios_old) < 0) {
-    exit (1);
-  }
+#ifdef LINUX_UCONTEXT
+  LinuxInitContexts ();
+#endif
+
+  /* Leave stdin alone if it is redirected (e.g. scripted runs) */
+  if (isatty (STDIN_FILENO)) {
+    if (tcgetattr (STDIN_FILENO, &termios_old) < 0) {
+      exit (1);
+    }
 
-  termios_new = termios_old;
+    termios_new = termios_old;
 
-  termios_new.c_iflag &= ~ICRNL;
-  termios_new.c_iflag |= INLCR;
-  termios_new.c_lflag &= ~(ECHO | ECHONL | ICANON);
+    termios_new.c_iflag &= ~ICRNL;
+    termios_new.c_iflag |= INLCR;
+    termios_new.c_lflag &= ~(ECHO | ECHONL | ICANON);
 
-  tcsetattr (STDIN_FILENO, TCSANOW, &termios_new);
+    tcsetattr (STDIN_FILENO, TCSANOW, &termios_new);
+    atexit (termios_reset);
+  }
 
   act.sa_handler = termios_restore;
   act.sa_flags = 0;
@@ -89,6 +137,10 @@ McuInit ()
   if (sigaction (SIGINT, &act, NULL) < 0) {
     exit (1);
   }
+
+#ifdef KERNEL_TRACE
+  atexit (TraceDump);
+#endif
 }
 
 /* vi: set et ai sw=2 sts=2: */
@@ -26,41 +26,59 @@
 #include <osek/osek.h>
 #include <autosar/autosar.h>
 #include <config/config.h>
-#include <signal.h>
+#include <arch/linux/interrupt.h>
 
 /**
  * @def SysEnter
  * @brief System service prologue
  *
- * For Linux, SysEnter() disables all signals and preserves
- * the old signal mask.
+ * For Linux, SysEnter() disables all interrupts and
+ * preserves the old interrupt state. id is the
+ * OSServiceId_* of the service for the syscall profiler,
+ * or INVALID_SERVICE.
  */
-#define SysEnter()                               \
-  sigset_t sigset, osigset;                      \
-  sigfillset (&sigset);                          \
-  sigprocmask (SIG_SETMASK, &sigset, &osigset)
+#define SysEnter(id)                             \
+  bool irq_disabled = linux_irq_disabled;        \
+  ArchDisableAllInterrupts ();                   \
+  SYSPROF_ENTER (id)
 
 /**
  * @def SysExit
  * @brief System service epilogue
  *
- * For Linux, SysExit() restores the old signal mask before
- * we entered system call.
+ * For Linux, SysExit() enables interrupts again if they
+ * were enabled before we entered system call. ret is the
+ * status returned by the service.
  */
-#define SysExit()                           \
-  sigprocmask (SIG_SETMASK, &osigset, NULL)
+#define SysExit(id, ret)                         \
+  SYSPROF_EXIT (id, ret);                        \
+  if (!irq_disabled) ArchEnableAllInterrupts ()
 
 StatusType
 ActivateTask (TaskType tid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ActivateTask);
   if (NestedISRs) {
     ret = Sys_ActivateTask (tid);
   } else {
     ret = Sys_ActivateTask_Preempt (tid);
   }
-  SysExit ();
+  SysExit (OSServiceId_ActivateTask, ret);
+  return ret;
+}
+
+StatusType
+ActivateTaskSet (TaskSetRefType TaskSet)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_ActivateTaskSet);
+  if (NestedISRs) {
+    ret = Sys_ActivateTaskSet (TaskSet);
+  } else {
+    ret = Sys_ActivateTaskSet_Preempt (TaskSet);
+  }
+  SysExit (OSServiceId_ActivateTaskSet, ret);
   return ret;
 }
 
@@ -68,9 +86,9 @@ StatusType
 TerminateTask (void)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_TerminateTask);
   ret = Sys_TerminateTask ();
-  SysExit ();
+  SysExit (OSServiceId_TerminateTask, ret);
   return ret;
 }
 
@@ -78,9 +96,9 @@ StatusType
 ChainTask (TaskType tid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ChainTask);
   ret = Sys_ChainTask (tid);
-  SysExit ();
+  SysExit (OSServiceId_ChainTask, ret);
   return ret;
 }
 
@@ -88,9 +106,9 @@ StatusType
 Schedule (void)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_Schedule);
   ret = Sys_Schedule ();
-  SysExit ();
+  SysExit (OSServiceId_Schedule, ret);
   return ret;
 }
 
@@ -98,9 +116,9 @@ StatusType
 GetTaskID (TaskRefType tid_ref)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetTaskID);
   ret = Sys_GetTaskID (tid_ref);
-  SysExit ();
+  SysExit (OSServiceId_GetTaskID, ret);
   return ret;
 }
 
@@ -108,9 +126,9 @@ StatusType
 GetTaskState (TaskType tid, TaskStateRefType state_ref)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetTaskState);
   ret = Sys_GetTaskState (tid, state_ref);
-  SysExit ();
+  SysExit (OSServiceId_GetTaskState, ret);
   return ret;
 }
 
@@ -162,9 +180,9 @@ StatusType
 GetResource (ResourceType rid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetResource);
   ret = Sys_GetResource (rid);
-  SysExit ();
+  SysExit (OSServiceId_GetResource, ret);
   return ret;
 }
 
@@ -172,13 +190,13 @@ StatusType
 ReleaseResource (ResourceType rid)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ReleaseResource);
   if (NestedISRs) {
     ret = Sys_ReleaseResource (rid);
   } else {
     ret = Sys_ReleaseResource_Preempt (rid);
   }
-  SysExit ();
+  SysExit (OSServiceId_ReleaseResource, ret);
   return ret;
 }
 
@@ -186,13 +204,13 @@ StatusType
 SetEvent (TaskType tid, EventMaskType mask)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetEvent);
   if (NestedISRs) {
     ret = Sys_SetEvent (tid, mask);
   } else {
     ret = Sys_SetEvent_Preempt (tid, mask);
   }
-  SysExit ();
+  SysExit (OSServiceId_SetEvent, ret);
   return ret;
 }
 
@@ -200,9 +218,9 @@ StatusType
 ClearEvent (EventMaskType mask)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_ClearEvent);
   ret = Sys_ClearEvent (mask);
-  SysExit ();
+  SysExit (OSServiceId_ClearEvent, ret);
   return ret;
 }
 
@@ -210,9 +228,9 @@ StatusType
 GetEvent (TaskType tid, EventMaskRefType event)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetEvent);
   ret = Sys_GetEvent (tid, event);
-  SysExit ();
+  SysExit (OSServiceId_GetEvent, ret);
   return ret;
 }
 
@@ -220,9 +238,9 @@ StatusType
 WaitEvent (EventMaskType mask)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_WaitEvent);
   ret = Sys_WaitEvent (mask);
-  SysExit ();
+  SysExit (OSServiceId_WaitEvent, ret);
   return ret;
 }
 
@@ -230,9 +248,9 @@ StatusType
 GetAlarmBase (AlarmType alarm, AlarmBaseRefType info)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetAlarmBase);
   ret = Sys_GetAlarmBase (alarm, info);
-  SysExit ();
+  SysExit (OSServiceId_GetAlarmBase, ret);
   return ret;
 }
 
@@ -240,9 +258,9 @@ StatusType
 GetAlarm (AlarmType alarm, TickRefType tick)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetAlarm);
   ret = Sys_GetAlarm (alarm, tick);
-  SysExit ();
+  SysExit (OSServiceId_GetAlarm, ret);
   return ret;
 }
 
@@ -250,9 +268,9 @@ StatusType
 SetRelAlarm (AlarmType alarm, TickType inc, TickType cycle)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetRelAlarm);
   ret = Sys_SetRelAlarm (alarm, inc, cycle);
-  SysExit ();
+  SysExit (OSServiceId_SetRelAlarm, ret);
   return ret;
 }
 
@@ -260,9 +278,9 @@ StatusType
 SetAbsAlarm (AlarmType alarm, TickType start, TickType cycle)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetAbsAlarm);
   ret = Sys_SetAbsAlarm (alarm, start, cycle);
-  SysExit ();
+  SysExit (OSServiceId_SetAbsAlarm, ret);
   return ret;
 }
 
@@ -270,9 +288,9 @@ StatusType
 CancelAlarm (AlarmType alarm)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_CancelAlarm);
   ret = Sys_CancelAlarm (alarm);
-  SysExit ();
+  SysExit (OSServiceId_CancelAlarm, ret);
   return ret;
 }
 
@@ -286,23 +304,60 @@ StatusType
 IncrementCounter (CounterType CounterID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_IncrementCounter);
   if (NestedISRs) {
     ret = Sys_IncrementCounter (CounterID);
   } else {
     ret = Sys_IncrementCounter_Preempt (CounterID);
   }
-  SysExit ();
+  SysExit (OSServiceId_IncrementCounter, ret);
+  return ret;
+}
+
+StatusType
+IncrementCounterBy (CounterType CounterID, TickType Increments)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_IncrementCounterBy);
+  if (NestedISRs) {
+    ret = Sys_IncrementCounterBy (CounterID, Increments);
+  } else {
+    ret = Sys_IncrementCounterBy_Preempt (CounterID, Increments);
+  }
+  SysExit (OSServiceId_IncrementCounterBy, ret);
   return ret;
 }
 
+#ifdef TASK_TIMERS
+StatusType
+WaitEventTimeout (EventMaskType Mask, CounterType CounterID,
+                  TickType Ticks)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_WaitEventTimeout);
+  ret = Sys_WaitEventTimeout (Mask, CounterID, Ticks);
+  SysExit (OSServiceId_WaitEventTimeout, ret);
+  return ret;
+}
+
+StatusType
+SleepTicks (CounterType CounterID, TickType Ticks)
+{
+  StatusType ret = E_OK;
+  SysEnter (OSServiceId_SleepTicks);
+  ret = Sys_SleepTicks (CounterID, Ticks);
+  SysExit (OSServiceId_SleepTicks, ret);
+  return ret;
+}
+#endif
+
 StatusType
 GetCounterValue (CounterType CounterID, TickRefType Value)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetCounterValue);
   ret = Sys_GetCounterValue (CounterID, Value);
-  SysExit ();
+  SysExit (OSServiceId_GetCounterValue, ret);
   return ret;
 }
 
@@ -311,9 +366,9 @@ GetElapsedValue (CounterType CounterID, TickRefType Value,
                  TickRefType ElapsedValue)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetElapsedValue);
   ret = Sys_GetElapsedValue (CounterID, Value, ElapsedValue);
-  SysExit ();
+  SysExit (OSServiceId_GetElapsedValue, ret);
   return ret;
 }
 
@@ -323,9 +378,9 @@ StartScheduleTableRel (ScheduleTableType ScheduleTableID,
                        TickType Offset)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StartScheduleTableRel);
   ret = Sys_StartScheduleTableRel (ScheduleTableID, Offset);
-  SysExit ();
+  SysExit (OSServiceId_StartScheduleTableRel, ret);
   return ret;
 }
 
@@ -334,9 +389,9 @@ StartScheduleTableAbs (ScheduleTableType ScheduleTableID,
                        TickType Start)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StartScheduleTableAbs);
   ret = Sys_StartScheduleTableAbs (ScheduleTableID, Start);
-  SysExit ();
+  SysExit (OSServiceId_StartScheduleTableAbs, ret);
   return ret;
 }
 
@@ -344,9 +399,9 @@ StatusType
 StopScheduleTable (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StopScheduleTable);
   ret = Sys_StopScheduleTable (ScheduleTableID);
-  SysExit ();
+  SysExit (OSServiceId_StopScheduleTable, ret);
   return ret;
 }
 
@@ -355,10 +410,10 @@ NextScheduleTable (ScheduleTableType ScheduleTableID_From,
                    ScheduleTableType ScheduleTableID_To)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_NextScheduleTable);
   ret = Sys_NextScheduleTable (ScheduleTableID_From,
                                ScheduleTableID_To);
-  SysExit ();
+  SysExit (OSServiceId_NextScheduleTable, ret);
   return ret;
 }
 
@@ -367,9 +422,9 @@ StatusType
 StartScheduleTableSynchron (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_StartScheduleTableSynchron);
   ret = Sys_StartScheduleTableSynchron (ScheduleTableID);
-  SysExit ();
+  SysExit (OSServiceId_StartScheduleTableSynchron, ret);
   return ret;
 }
 
@@ -378,9 +433,9 @@ SyncScheduleTable (ScheduleTableType ScheduleTableID,
                    TickType Value)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SyncScheduleTable);
   ret = Sys_SyncScheduleTable (ScheduleTableID, Value);
-  SysExit ();
+  SysExit (OSServiceId_SyncScheduleTable, ret);
   return ret;
 }
 
@@ -388,9 +443,9 @@ StatusType
 SetScheduleTableAsync (ScheduleTableType ScheduleTableID)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_SetScheduleTableAsync);
   ret = Sys_SetScheduleTableAsync (ScheduleTableID);
-  SysExit ();
+  SysExit (OSServiceId_SetScheduleTableAsync, ret);
   return ret;
 }
 #endif
@@ -401,9 +456,57 @@ GetScheduleTableStatus (
   ScheduleTableStatusRefType ScheduleStatus)
 {
   StatusType ret = E_OK;
-  SysEnter ();
+  SysEnter (OSServiceId_GetScheduleTableStatus);
   ret = Sys_GetScheduleTableStatus (ScheduleTableID, ScheduleStatus);
-  SysExit ();
+  SysExit (OSServiceId_GetScheduleTableStatus, ret);
+  return ret;
+}
+#endif
+
+#ifdef TASK_STATS
+StatusType
+GetTaskStats (TaskType TaskID, TaskStatsRefType Stats)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetTaskStats (TaskID, Stats);
+  SysExit (INVALID_SERVICE, ret);
+  return ret;
+}
+#endif
+
+#ifdef LATENCY_HIST
+StatusType
+GetLatencyHist (LatencyType Type, LatencyHistRefType Hist, bool Reset)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetLatencyHist (Type, Hist, Reset);
+  SysExit (INVALID_SERVICE, ret);
+  return ret;
+}
+#endif
+
+#ifdef SYSCALL_PROF
+StatusType
+GetSysProf (OSServiceIdType ServiceID, SysProfRefType Prof, bool Reset)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetSysProf (ServiceID, Prof, Reset);
+  SysExit (INVALID_SERVICE, ret);
+  return ret;
+}
+#endif
+
+#ifdef STACK_MONITOR
+StatusType
+GetStackUsage (TaskType StackID, StackUsageRefType Usage)
+{
+  StatusType ret = E_OK;
+  SysEnter (INVALID_SERVICE);
+  ret = Sys_GetStackUsage (StackID, Usage);
+  SysExit (INVALID_SERVICE, ret);
   return ret;
 }
 #endif
@@ -23,7 +23,46 @@
  * @brief  Linux Context Switch
  */
 #include <task.h>
+#include <sdvos.h>
+#include <arch/linux/interrupt.h>
+#ifdef LINUX_UCONTEXT
 #include <ucontext.h>
+#include <signal.h>
+#endif
+
+void
+LinuxTaskEntry (void)
+{
+  TCB * task = cur_task;
+
+  /* An ISR might preempt the task right away */
+  ArchEnableAllInterrupts ();
+  ((void (*) (void)) (task->start)) ();
+}
+
+#ifdef LINUX_UCONTEXT
+ucontext_t linux_start_contexts[NUM_TASKS];
+
+void
+LinuxInitContexts ()
+{
+  ucontext_t * ctx = NULL;
+  int i = 0;
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    ctx = &linux_start_contexts[i];
+    if (getcontext (ctx) == -1) {
+      panic ();
+    }
+    ctx->uc_stack.ss_sp = (void *) tasks[i].sp_end;
+    ctx->uc_stack.ss_size = (tasks[i].bp - tasks[i].sp_end);
+    ctx->uc_stack.ss_flags = 0;
+    ctx->uc_link = (void *) 0;
+    /* Clear the signal mask */
+    sigemptyset (&(ctx->uc_sigmask));
+    makecontext (ctx, LinuxTaskEntry, 0);
+  }
+}
 
 void
 SwitchTask (TCB * src, TCB * dst)
@@ -35,5 +74,12 @@ SwitchTask (TCB * src, TCB * dst)
     setcontext (&(dst->context.context));
   }
 }
+#else
+const uintptr_t linux_start_frame[LINUX_START_FRAME_WORDS] = {
+  [LINUX_START_FRAME_WORDS - 2] = (uintptr_t) LinuxTaskEntry,
+};
+
+/* SwitchTask is implemented in context.S */
+#endif
 
 /* vi: set et ai sw=2 sts=2: */
@@ -24,26 +24,201 @@
  */
 #include <arch/linux/vector.h>
 #include <arch/linux/interrupt.h>
+#include <arch/linux/timer.h>
 #include <sdvos.h>
+#include <config/config.h>
 #include <signal.h>
 #include <time.h>
 #include <features.h>
+#ifdef LINUX_VIRTUAL_TIME
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+/* Tick period in nanoseconds */
+#define TICK_NS         ((long) OSTICKDURATION)
+/* Longest one-shot period in ticks */
+#define MAX_ONESHOT     0x100000UL
+
+/* POSIX timer driving the system tick */
+static timer_t timer_id;
+
+#ifdef LINUX_VIRTUAL_TIME
+/* Time dilation factor, 0 stops the periodic tick */
+static unsigned long vtime_dilation = 1;
+/* Simulated ticks since ArchTimerInit */
+static uint64_t vtime_ticks = 0;
+/* Ticks skipped by the pending one-shot period */
+static TickType vtime_oneshot = 0;
+/* Wall time of ArchTimerInit */
+static uint64_t vtime_start = 0;
+#endif
+
+#ifdef TICKLESS
+static uint64_t
+MonotonicNs (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#ifdef LINUX_VIRTUAL_TIME
+void
+LinuxVirtualTick ()
+{
+  /*
+   * A periodic tick stands for vtime_dilation ticks. It is
+   * handled as the expiry of a one-shot period of that
+   * length, so TickHandler catches the counter up in one go.
+   */
+  if (!vtime_oneshot) {
+    vtime_oneshot = vtime_dilation;
+    tickless_idle = TRUE;
+  }
+}
+
+void
+LinuxVirtualIdle ()
+{
+  if (linux_irq_pending || tickless_idle) return;
+
+  /* The next tick is due, raise it right away */
+  vtime_oneshot = 1;
+  tickless_idle = TRUE;
+  uatomic_or (&linux_irq_pending, 0x1UL << LINUX_TICK_VECTOR);
+}
+
+TickType
+ArchTimerOneShot (TickType ticks)
+{
+  /* Deliver whatever is pending before skipping ahead */
+  if (linux_irq_pending) return 0;
+
+  if ((!ticks) || (ticks > MAX_ONESHOT)) ticks = MAX_ONESHOT;
+
+  /* Expire as soon as IdleLoop enables interrupts again */
+  vtime_oneshot = ticks;
+  uatomic_or (&linux_irq_pending, 0x1UL << LINUX_TICK_VECTOR);
+
+  return ticks;
+}
+
+TickType
+ArchTimerResume (void)
+{
+  TickType ticks = vtime_oneshot;
+
+  /* The periodic tick was never stopped */
+  vtime_ticks += ticks;
+  vtime_oneshot = 0;
+
+  return ticks;
+}
+
+/* Print simulated time versus wall time at exit */
+static void
+VirtualTimeReport (void)
+{
+  uint64_t sim = vtime_ticks * TICK_NS;
+  uint64_t wall = MonotonicNs () - vtime_start;
+
+  fprintf (stderr, "Simulated time: %llu.%03llu s, "
+           "wall time: %llu.%03llu s\n",
+           (unsigned long long) (sim / 1000000000ULL),
+           (unsigned long long) ((sim / 1000000ULL) % 1000),
+           (unsigned long long) (wall / 1000000000ULL),
+           (unsigned long long) ((wall / 1000000ULL) % 1000));
+}
+
+/* Read the time dilation factor, return the tick period */
+static long
+VirtualTimeInit (void)
+{
+  char * env = getenv ("SDVOS_TIME_DILATION");
+
+  if (env) {
+    vtime_dilation = strcmp (env, "max") ?
+                     strtoul (env, NULL, 0) : 0;
+  }
+  if (vtime_dilation > MAX_ONESHOT) vtime_dilation = MAX_ONESHOT;
+
+  vtime_start = MonotonicNs ();
+  atexit (VirtualTimeReport);
+
+  return vtime_dilation ? TICK_NS : 0;
+}
+#else
+/* Time of the last tick boundary before going tickless */
+static uint64_t oneshot_base = 0;
+
+/* Program timer_id with a first expiry and interval in ns */
+static void
+SetTimer (uint64_t value, uint64_t interval)
+{
+  struct itimerspec its;
+
+  its.it_value.tv_sec = value / 1000000000ULL;
+  its.it_value.tv_nsec = value % 1000000000ULL;
+  its.it_interval.tv_sec = interval / 1000000000ULL;
+  its.it_interval.tv_nsec = interval % 1000000000ULL;
+  timer_settime (timer_id, 0, &its, NULL);
+}
+
+TickType
+ArchTimerOneShot (TickType ticks)
+{
+  struct itimerspec its;
+  uint64_t remain = 0;
+
+  if ((!ticks) || (ticks > MAX_ONESHOT)) ticks = MAX_ONESHOT;
+
+  /* Time left until the next periodic tick */
+  timer_gettime (timer_id, &its);
+  remain = (uint64_t) its.it_value.tv_sec * 1000000000ULL +
+           its.it_value.tv_nsec;
+  if (!remain) return 0;
+
+  oneshot_base = MonotonicNs () + remain - TICK_NS;
+  SetTimer (remain + (uint64_t) (ticks - 1) * TICK_NS, 0);
+
+  return ticks;
+}
+
+TickType
+ArchTimerResume (void)
+{
+  uint64_t elapsed = MonotonicNs () - oneshot_base;
+
+  /* Restart periodic tick on the next tick boundary */
+  SetTimer (TICK_NS - (elapsed % TICK_NS), TICK_NS);
+
+  return (TickType) (elapsed / TICK_NS);
+}
+#endif
+#endif
 
 void
 ArchTimerInit ()
 {
 #ifdef _POSIX_C_SOURCE
   if (_POSIX_C_SOURCE >= 199309L) {
-    timer_t timer_id;
     struct itimerspec its;
+    long period = TICK_NS;
+
+#ifdef LINUX_VIRTUAL_TIME
+    /* No periodic tick at all in "max" mode */
+    period = VirtualTimeInit ();
+#endif
 
     timer_create (CLOCK_MONOTONIC, NULL, &timer_id);
-    /* 1 ms initial delay */
-    its.it_value.tv_sec = 0;
-    its.it_value.tv_nsec = 1000000L;
-    its.it_interval.tv_sec = 0;
-    /* 1 ms interval */
-    its.it_interval.tv_nsec = 1000000L;
+    /* One tick initial delay */
+    its.it_value.tv_sec = period / 1000000000L;
+    its.it_value.tv_nsec = period % 1000000000L;
+    /* One tick interval */
+    its.it_interval = its.it_value;
     timer_settime (timer_id, 0, &its, NULL);
   } else {
     DEBUG_PRINTF ("POSIX per-process timer not supported!\n");
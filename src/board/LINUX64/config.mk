@@ -0,0 +1,7 @@
+# Board Specific Configuration for Linux (x86-64)
+-include arch/linux/config.mk
+
+OBJ += board/LINUX64/board.o
+
+CFLAGS = -g -Os -std=gnu99 -m64 -Iinclude -I. -Wall -MMD $(CFG)
+LDFLAGS = $(CFLAGS)
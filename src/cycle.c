@@ -0,0 +1,49 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/cycle.c
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  High Resolution Cycle Counter
+ */
+#include <osek/osek.h>
+#include <sdvos.h>
+
+/** Nanoseconds per second */
+#define NS_PER_SEC            1000000000ULL
+
+#ifdef ARCH_CYCLE_PRIVILEGED
+CycleType
+Sys_GetCycleCount ()
+{
+  return (CycleType) ArchCycleCount ();
+}
+#endif
+
+uint64_t
+CyclesToNs (uint64_t cycles)
+{
+  uint32_t freq = ArchCycleFreq ();
+
+  /* Whole seconds first so that cycles * NS_PER_SEC cannot overflow */
+  return (cycles / freq) * NS_PER_SEC +
+         (cycles % freq) * NS_PER_SEC / freq;
+}
+
+/* vi: set et ai sw=2 sts=2: */
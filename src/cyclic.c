@@ -0,0 +1,63 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/cyclic.c
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Cyclic Executive Dispatcher
+ */
+#include <osek/osek.h>
+#include <config/config.h>
+#include <sdvos.h>
+
+/** Dispatch table of the active application mode */
+static const CyclicTableType * cyclic_table = NULL;
+/** Current tick in the hyperperiod */
+static TickType cyclic_tick = 0;
+/** Next slot due in cyclic_table */
+static TickType cyclic_next = 0;
+
+void
+CyclicInit (AppModeType mode)
+{
+  cyclic_table = &cyclic_tables[mode];
+  cyclic_tick = 0;
+  cyclic_next = 0;
+}
+
+void
+CyclicTick ()
+{
+  const CyclicSlotType * slot = NULL;
+
+  /* Ticks run from 1 to hyperperiod */
+  if (cyclic_tick == cyclic_table->hyperperiod) cyclic_tick = 0;
+  cyclic_tick++;
+
+  if (!cyclic_table->num_slots) return;
+
+  slot = &cyclic_table->slots[cyclic_next];
+  if (slot->tick != cyclic_tick) return;
+
+  DoActivateTaskSet (&slot->tasks);
+
+  if ((++cyclic_next) == cyclic_table->num_slots) cyclic_next = 0;
+}
+
+/* vi: set et ai sw=2 sts=2: */
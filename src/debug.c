@@ -34,6 +34,10 @@ struct OSErrorService_t OSErrorService;
 FlagType InErrorHook = FALSE;
 #endif
 
+#ifdef KERNEL_STATS
+KernelStatsType kernel_stats;
+#endif
+
 #ifdef DEBUG_SDVOS
 
 void
@@ -26,6 +26,71 @@
 #include <osek/osek.h>
 #include <config/config.h>
 
+#ifdef TASK_TIMERS
+/** Global queue for all counters in the system */
+extern Counter counters[NUM_COUNTERS];
+#endif
+
+/**
+ * @brief Block the calling task
+ *
+ * The calling task is put in the waiting state and the
+ * highest priority ready task is dispatched. Depending on
+ * the architecture, WaitBlock either returns when the task
+ * is dispatched again or never returns (the kernel stack is
+ * discarded).
+ */
+static void
+WaitBlock (void)
+{
+  TaskType tid = 0;
+
+  /* Block and re-schedule */
+  NextTask (&tid, MAX_PRIO, 0);
+
+  /*
+   * PostTaskHook is called after executing the current
+   * task, but before leaving the task's running state.
+   */
+  POSTTASKHOOK ();
+  cur_task->state = WAITING;
+  /* Release internal resource */
+  cur_task->priority = cur_task->orig_prio;
+  Dispatch (tid, DISPATCH_BLOCK);
+}
+
+/**
+ * @brief Set events of a task
+ *
+ * Internal use only. Called by SetEvent and DoSetEventList.
+ *
+ * @param[in] tid
+ *   Task whose events are set
+ * @param[in] mask
+ *   Mask of the events to be set
+ */
+static inline void
+DoSetEvent (TaskType tid, EventMaskType mask)
+{
+  /* Set events specified by mask */
+  tasks[tid].cevent |= mask;
+  if (tasks[tid].wevent & mask) {
+    /*
+     * Task tid is waiting for at least one of the events
+     * specified in mask. Task tid should be transferred to
+     * the ready state.
+     */
+    if (tasks[tid].state == WAITING) {
+#ifdef TASK_TIMERS
+      StopTaskTimer (tid);
+#endif
+      LATENCY_RELEASE (tid, TRUE);
+      tasks[tid].state = READY;
+      EnqueueTaskTail (tid);
+    }
+  }
+}
+
 StatusType
 Sys_SetEvent (TaskType tid, EventMaskType mask)
 {
@@ -46,19 +111,7 @@ Sys_SetEvent (TaskType tid, EventMaskType mask)
   }
 #endif
 
-  /* Set events specified by mask */
-  tasks[tid].cevent |= mask;
-  if (tasks[tid].wevent & mask) {
-    /*
-     * Task tid is waiting for at least one of the events
-     * specified in mask. Task tid should be transferred to
-     * the ready state.
-     */
-    if (tasks[tid].state == WAITING) {
-      tasks[tid].state = READY;
-      EnqueueTaskTail (tid);
-    }
-  }
+  DoSetEvent (tid, mask);
 
 #ifdef OSEK_EXTENDED
 std_ret:
@@ -77,6 +130,27 @@ Sys_SetEvent_Preempt (TaskType tid, EventMaskType mask)
   return ret;
 }
 
+#ifdef USE_SCHEDTBL
+void
+DoSetEventList (const ExpiryPointEventList * events,
+                udata_word_t num)
+{
+  udata_word_t i = 0;
+
+  for (i = 0; i < num; i++) {
+#ifdef OSEK_EXTENDED
+    if (tasks[events[i].tid].state == SUSPENDED) {
+      SaveOSErrorService (OSServiceId_SetEvent, events[i].tid,
+                          events[i].mask, 0);
+      ERRORHOOK (E_OS_STATE);
+      continue;
+    }
+#endif
+    DoSetEvent (events[i].tid, events[i].mask);
+  }
+}
+#endif
+
 StatusType
 Sys_ClearEvent (EventMaskType mask)
 {
@@ -139,7 +213,6 @@ std_ret:
 StatusType
 Sys_WaitEvent (EventMaskType mask)
 {
-  TaskType tid = 0;
   StatusType ret = E_OK;
 
 #ifdef OSEK_EXTENDED
@@ -168,18 +241,7 @@ Sys_WaitEvent (EventMaskType mask)
 
   /* None of the events in mask is set. Need to block. */
   cur_task->wevent = mask;
-  /* Block and re-schedule */
-  NextTask (&tid, MAX_PRIO, 0);
-
-  /*
-   * PostTaskHook is called after executing the current
-   * task, but before leaving the task's running state.
-   */
-  POSTTASKHOOK ();
-  cur_task->state = WAITING;
-  /* Release internal resource */
-  cur_task->priority = cur_task->orig_prio;
-  Dispatch (tid, DISPATCH_BLOCK);
+  WaitBlock ();
 
 std_ret:
   SaveOSErrorService (OSServiceId_WaitEvent, mask, 0, 0);
@@ -187,4 +249,123 @@ std_ret:
   return ret;
 }
 
+#ifdef TASK_TIMERS
+void
+TaskTimeout (TaskType tid)
+{
+  TCB * task = &tasks[tid];
+
+  if (task->state != WAITING) return;
+
+  /* A task sleeping in SleepTicks waits for no event */
+  SetWaitReturn (task, task->wevent ? E_OS_SYS_TIMEOUT : E_OK);
+  /* Tells a blocked WaitEventTimeout that it timed out */
+  task->wevent = (EventMaskType) 0;
+
+  LATENCY_RELEASE (tid, TRUE);
+  task->state = READY;
+  EnqueueTaskTail (tid);
+}
+
+StatusType
+Sys_WaitEventTimeout (EventMaskType mask, CounterType CounterID,
+                      TickType ticks)
+{
+  StatusType ret = E_OK;
+
+#ifdef OSEK_EXTENDED
+  /* Is tid extended task? */
+  if (!(cur_task->flag & TASK_EXTENDED)) {
+    ret = E_OS_ACCESS;
+    goto std_ret;
+  }
+  /* Check whether current task still occupies resource */
+  if (cur_task->res) {
+    ret = E_OS_RESOURCE;
+    goto std_ret;
+  }
+  /* Check whether OS is at interrupt level */
+  if (NestedISRs) {
+    ret = E_OS_CALLEVEL;
+    goto std_ret;
+  }
+  /* Is counter valid? */
+  ValidateCounter (CounterID);
+  /* Is ticks valid? */
+  if ((ticks == 0) ||
+      (ticks > counters[CounterID].properties.maxallowedvalue)) {
+    ret = E_OS_VALUE;
+    goto std_ret;
+  }
+#endif
+
+  /* At least one of the events in mask is set. Do nothing. */
+  if (cur_task->cevent & mask) {
+    ret = E_OK;
+    goto std_ret;
+  }
+
+  /* None of the events in mask is set. Need to block. */
+  cur_task->wevent = mask;
+  StartTaskTimer (cur_task->tid, CounterID, ticks);
+  WaitBlock ();
+
+  /* TaskTimeout clears the events waited for */
+  if (mask && !cur_task->wevent) {
+    /* Not an error, ErrorHook is not called */
+    return E_OS_SYS_TIMEOUT;
+  }
+
+std_ret:
+  SaveOSErrorService (OSServiceId_WaitEventTimeout, mask,
+                      CounterID, ticks);
+  ERRORHOOK (ret);
+  return ret;
+}
+
+StatusType
+Sys_SleepTicks (CounterType CounterID, TickType ticks)
+{
+  StatusType ret = E_OK;
+
+#ifdef OSEK_EXTENDED
+  /* Is tid extended task? */
+  if (!(cur_task->flag & TASK_EXTENDED)) {
+    ret = E_OS_ACCESS;
+    goto std_ret;
+  }
+  /* Check whether current task still occupies resource */
+  if (cur_task->res) {
+    ret = E_OS_RESOURCE;
+    goto std_ret;
+  }
+  /* Check whether OS is at interrupt level */
+  if (NestedISRs) {
+    ret = E_OS_CALLEVEL;
+    goto std_ret;
+  }
+  /* Is counter valid? */
+  ValidateCounter (CounterID);
+  /* Is ticks valid? */
+  if ((ticks == 0) ||
+      (ticks > counters[CounterID].properties.maxallowedvalue)) {
+    ret = E_OS_VALUE;
+    goto std_ret;
+  }
+#endif
+
+  /* Only the task timer releases the task */
+  cur_task->wevent = (EventMaskType) 0;
+  StartTaskTimer (cur_task->tid, CounterID, ticks);
+  WaitBlock ();
+
+#ifdef OSEK_EXTENDED
+std_ret:
+#endif
+  SaveOSErrorService (OSServiceId_SleepTicks, CounterID, ticks, 0);
+  ERRORHOOK (ret);
+  return ret;
+}
+#endif
+
 /* vi: set et ai sw=2 sts=2: */
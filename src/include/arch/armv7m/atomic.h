@@ -154,6 +154,33 @@ typedef uint32_t ALIGNED (4) uatomic_t;
  */
 #define uatomic_set atomic_set
 
+/**
+ * @def uatomic_fetch_inc32
+ * @brief Atomic 32-bit fetch and increase
+ *
+ * Atomically increase the 32-bit unsigned integer stored
+ * at v and return its value before the increment.
+ *
+ * @param[in] v
+ *   Reference to a uint32_t
+ *
+ * @return
+ *   Value stored at v before the increment
+ */
+#define uatomic_fetch_inc32(v) ({                \
+  uint32_t __old;                               \
+  __asm__ volatile ("1:\n\t"                    \
+                    "ldrex %0, [%2]\n\t"        \
+                    "adds r0, %0, #1\n\t"       \
+                    "strex r1, r0, [%2]\n\t"    \
+                    "cmp r1, #0\n\t"            \
+                    "bne 1b\n\t"                \
+                    :"=&l" (__old), "+m" (*(v)) \
+                    :"l" (v)                    \
+                    :"r0", "r1", "cc");         \
+  __old;                                        \
+})
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
@@ -0,0 +1,69 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/arch/armv7m/cycle.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  ARMv7-M Cycle Counter
+ */
+#ifndef _ARMV7M_CYCLE_H_
+#define _ARMV7M_CYCLE_H_
+
+#include <arch/armv7m/types.h>
+#include <arch/armv7m/scs.h>
+
+/**
+ * @brief Start the cycle counter
+ *
+ * Enables the DWT cycle counter, which counts core clock
+ * cycles. Must be called in privileged mode.
+ */
+void ArchCycleInit (void);
+
+/**
+ * @brief Frequency of the cycle counter
+ *
+ * @return
+ *   Core clock frequency in Hz
+ */
+uint32_t ArchCycleFreq (void);
+
+/**
+ * @def ARCH_CYCLE_PRIVILEGED
+ * @brief The cycle counter can only be read in privileged mode
+ *
+ * DWT is in the Private Peripheral Bus, so unprivileged
+ * tasks read the cycle counter with a system call.
+ */
+#define ARCH_CYCLE_PRIVILEGED
+
+/**
+ * @def ArchCycleCount
+ * @brief Read the cycle counter
+ *
+ * DWT registers are only accessible in privileged mode.
+ *
+ * @return
+ *   Free running 32-bit core cycle count
+ */
+#define ArchCycleCount()      (DWT->CYCCNT)
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
@@ -154,9 +154,11 @@ while (0)
   __attribute__ ((section("\"." #vector "\""))) =    \
   (code_addr_t *) vector##_impl;                     \
   static void vector##_impl (void) {                 \
+    TRACE (TRACE_ISR_ENTER, 1, 0, vector##_impl);    \
     uatomic_inc (&NestedISRs);                       \
     vector##_user_impl ();                           \
     uatomic_dec (&NestedISRs);                       \
+    TRACE (TRACE_ISR_EXIT, 1, 0, vector##_impl);     \
     return;                                          \
   }                                                  \
   static void vector##_user_impl (void)
@@ -184,9 +186,13 @@ while (0)
   __attribute__ ((section("\"." #vector "\""))) =    \
   (code_addr_t *) vector##_impl;                     \
   static void NOINLINE _##vector##_impl (void) {     \
+    TRACE (TRACE_ISR_ENTER, 2, 0, vector##_impl);    \
+    LATENCY_ISR_ENTER ();                            \
+    TICKLESS_ISR_ENTER ();                           \
     uatomic_inc (&NestedISRs);                       \
     vector##_user_impl ();                           \
     uatomic_dec (&NestedISRs);                       \
+    TRACE (TRACE_ISR_EXIT, 2, 0, vector##_impl);     \
     CheckPreemption (PREEMPT_ISR);                   \
   }                                                  \
   static void vector##_impl (void) {                 \
@@ -94,6 +94,12 @@
 #define SysTick_CALIB_SKEW          ((uint32_t)0x40000000)
 #define SysTick_CALIB_NOREF         ((uint32_t)0x80000000)
 
+/* Bit definition for CoreDebug DEMCR register */
+#define CoreDebug_DEMCR_TRCENA      ((uint32_t)0x01000000)
+
+/* Bit definition for DWT_CTRL register */
+#define DWT_CTRL_CYCCNTENA          ((uint32_t)0x00000001)
+
 #ifdef __USE_FPU__
 /* Floating-Point Context Control Register */
 #define FPU_FPCCR_ASPEN             (1UL << 31)
@@ -286,6 +292,17 @@ typedef struct
   volatile uint32_t CALIB;
 } SysTick_Type;
 
+/**
+ * Memory mapping struct for Data Watchpoint and Trace
+ */
+typedef struct
+{
+  /** DWT Control Register */
+  volatile uint32_t CTRL;
+  /** DWT Cycle Count Register */
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+
 /**
  * Memory mapped struct for Interrupt Type
  */
@@ -334,6 +351,9 @@ typedef struct
 /** System Control Block Base Address */
 #define SCB_BASE      (SCS_BASE + 0x0D00)
 
+/** Data Watchpoint and Trace Base Address */
+#define DWT_BASE      (0xE0001000)
+
 /** Interrupt Type Register */
 #define InterruptType  ((InterruptType_Type *) SCS_BASE)
 /** SCB configuration struct */
@@ -342,6 +362,10 @@ typedef struct
 #define SysTick        ((SysTick_Type *) SysTick_BASE)
 /** NVIC configuration struct */
 #define NVIC           ((NVIC_Type *) NVIC_BASE)
+/** DWT configuration struct */
+#define DWT            ((DWT_Type *) DWT_BASE)
+/** Debug Exception and Monitor Control Register */
+#define CoreDebug_DEMCR (*((volatile uint32_t *) 0xE000EDFC))
 
 #ifdef __USE_FPU__
 /** Floating Point Unit */
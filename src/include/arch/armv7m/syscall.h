@@ -25,57 +25,62 @@
 #ifndef _ARMV7M_SYSCALL_H_
 #define _ARMV7M_SYSCALL_H_
 
-#if defined (SCHEDTBL_SYNC)
-#define NUM_SYSCALLS          0x26
-#elif defined (USE_SCHEDTBL)
-#define NUM_SYSCALLS          0x23
-#else
-#define NUM_SYSCALLS          0x1E
-#endif
+/* Optional services are numbered after the schedule table ones */
+#define NUM_SYSCALLS          0x2F
 
-#define SVC_MAX_NO_PREEMPT    0x06
+#define SVC_MAX_NO_PREEMPT    0x0A
 
-/* The first six cause preemption at the end of service */
+/* The first ten cause preemption or block the caller */
 #define SVC_NO_ACTIVATETASK                      0x01
 #define SVC_NO_SCHEDULE                          0x02
 #define SVC_NO_RELEASERESOURCE                   0x03
 #define SVC_NO_SETEVENT                          0x04
 #define SVC_NO_WAITEVENT                         0x05
 #define SVC_NO_INCREMENTCOUNTER                  0x06
+#define SVC_NO_INCREMENTCOUNTERBY                0x07
+#define SVC_NO_WAITEVENTTIMEOUT                  0x08
+#define SVC_NO_SLEEPTICKS                        0x09
+#define SVC_NO_ACTIVATETASKSET                   0x0A
 /* The following two trigger context switch (not preemption) */
-#define SVC_NO_TERMINATETASK                     0x07
-#define SVC_NO_CHAINTASK                         0x08
+#define SVC_NO_TERMINATETASK                     0x0B
+#define SVC_NO_CHAINTASK                         0x0C
 /* The rest are "normal" system services */
-#define SVC_NO_GETTASKID                         0x09
-#define SVC_NO_GETTASKSTATE                      0x0A
-#define SVC_NO_DISABLEALLINTERRUPTS              0x0B
-#define SVC_NO_ENABLEALLINTERRUPTS               0x0C
-#define SVC_NO_SUSPENDALLINTERRUPTS              0x0D
-#define SVC_NO_RESUMEALLINTERRUPTS               0x0E
-#define SVC_NO_SUSPENDOSINTERRUPTS               0x0F
-#define SVC_NO_RESUMEOSINTERRUPT                 0x10
-#define SVC_NO_GETRESOURCE                       0x11
-#define SVC_NO_CLEAREVENT                        0x12
-#define SVC_NO_GETEVENT                          0x13
-#define SVC_NO_GETALARMBASE                      0x14
-#define SVC_NO_GETALARM                          0x15
-#define SVC_NO_SETRELALARM                       0x16
-#define SVC_NO_SETABSALARM                       0x17
-#define SVC_NO_CANCELALARM                       0x18
-#define SVC_NO_GETACTIVEAPPLICATIONMODE          0x19
-#define SVC_NO_STARTOS                           0x1A
-#define SVC_NO_SHUTDOWNOS                        0x1B
-#define SVC_NO_GETCOUNTERVALUE                   0x1C
-#define SVC_NO_GETELAPSEDVALUE                   0x1D
+#define SVC_NO_GETTASKID                         0x0D
+#define SVC_NO_GETTASKSTATE                      0x0E
+#define SVC_NO_DISABLEALLINTERRUPTS              0x0F
+#define SVC_NO_ENABLEALLINTERRUPTS               0x10
+#define SVC_NO_SUSPENDALLINTERRUPTS              0x11
+#define SVC_NO_RESUMEALLINTERRUPTS               0x12
+#define SVC_NO_SUSPENDOSINTERRUPTS               0x13
+#define SVC_NO_RESUMEOSINTERRUPT                 0x14
+#define SVC_NO_GETRESOURCE                       0x15
+#define SVC_NO_CLEAREVENT                        0x16
+#define SVC_NO_GETEVENT                          0x17
+#define SVC_NO_GETALARMBASE                      0x18
+#define SVC_NO_GETALARM                          0x19
+#define SVC_NO_SETRELALARM                       0x1A
+#define SVC_NO_SETABSALARM                       0x1B
+#define SVC_NO_CANCELALARM                       0x1C
+#define SVC_NO_GETACTIVEAPPLICATIONMODE          0x1D
+#define SVC_NO_STARTOS                           0x1E
+#define SVC_NO_SHUTDOWNOS                        0x1F
+#define SVC_NO_GETCOUNTERVALUE                   0x20
+#define SVC_NO_GETELAPSEDVALUE                   0x21
+
+#define SVC_NO_STARTSCHEDULETABLEREL             0x22
+#define SVC_NO_STARTSCHEDULETABLEABS             0x23
+#define SVC_NO_STOPSCHEDULETABLE                 0x24
+#define SVC_NO_NEXTSCHEDULETABLE                 0x25
+#define SVC_NO_GETSCHEDULETABLESTATUS            0x26
+#define SVC_NO_STARTSCHEDULETABLESYNCHRON        0x27
+#define SVC_NO_SYNCSCHEDULETABLE                 0x28
+#define SVC_NO_SETSCHEDULETABLEASYNC             0x29
 
-#define SVC_NO_STARTSCHEDULETABLEREL             0x1E
-#define SVC_NO_STARTSCHEDULETABLEABS             0x1F
-#define SVC_NO_STOPSCHEDULETABLE                 0x20
-#define SVC_NO_NEXTSCHEDULETABLE                 0x21
-#define SVC_NO_GETSCHEDULETABLESTATUS            0x22
-#define SVC_NO_STARTSCHEDULETABLESYNCHRON        0x23
-#define SVC_NO_SYNCSCHEDULETABLE                 0x24
-#define SVC_NO_SETSCHEDULETABLEASYNC             0x25
+#define SVC_NO_GETTASKSTATS                      0x2A
+#define SVC_NO_GETLATENCYHIST                    0x2B
+#define SVC_NO_GETCYCLECOUNT                     0x2C
+#define SVC_NO_GETSYSPROF                        0x2D
+#define SVC_NO_GETSTACKUSAGE                     0x2E
 
 #endif
 
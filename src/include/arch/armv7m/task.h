@@ -77,6 +77,25 @@ InitContext (TCB * task)
   task->sp = (data_addr_t) stk;
 }
 
+/**
+ * @brief Set the return value of a blocked service
+ *
+ * A task blocked in a system service is resumed through
+ * exception return and the kernel stack of the service is
+ * discarded. The service returns r0 of the exception frame
+ * at the saved PSP.
+ *
+ * @param[in] task
+ *   Reference to the TCB of a waiting task
+ * @param[in] ret
+ *   Return value of the blocked service
+ */
+static inline void
+SetWaitReturn (TCB * task, StatusType ret)
+{
+  ((data_addr_t *) task->sp)[0] = (data_addr_t) ret;
+}
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
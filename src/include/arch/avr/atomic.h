@@ -163,6 +163,27 @@ uatomic_t uatomic_read (uatomic_t * v);
  */
 #define uatomic_set atomic_set
 
+/**
+ * @def uatomic_fetch_inc32
+ * @brief Atomic 32-bit fetch and increase
+ *
+ * Atomically increase the 32-bit unsigned integer stored
+ * at v and return its value before the increment.
+ *
+ * @param[in] v
+ *   Reference to a uint32_t
+ *
+ * @return
+ *   Value stored at v before the increment
+ */
+#define uatomic_fetch_inc32(v) ({ \
+  uint32_t __old;                 \
+  EnterExcl ();                   \
+  __old = (*(v))++;               \
+  ExitExcl ();                    \
+  __old;                          \
+})
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
@@ -0,0 +1,60 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/arch/avr/cycle.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  AVR Cycle Counter
+ */
+#ifndef _AVR_CYCLE_H_
+#define _AVR_CYCLE_H_
+
+#include <arch/avr/types.h>
+
+/**
+ * @def ArchCycleInit
+ * @brief Start the cycle counter
+ *
+ * AVR has no cycle counter. Cycles are counted by Timer 1,
+ * which is set up with the system tick.
+ */
+#define ArchCycleInit()
+
+/**
+ * @brief Frequency of the cycle counter
+ *
+ * @return
+ *   Timer 1 clock (F_CPU / prescaler) in Hz
+ */
+uint32_t ArchCycleFreq (void);
+
+/**
+ * @brief Read the cycle counter
+ *
+ * Combines the ticks handled so far with the current
+ * Timer 1 count.
+ *
+ * @return
+ *   Free running 32-bit count of Timer 1 clock cycles
+ */
+uint32_t ArchCycleCount (void);
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
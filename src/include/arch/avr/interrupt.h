@@ -77,9 +77,13 @@
   void vector (void) ISR_ATTR;    \
   void vector##_impl (void);      \
   void vector (void) {            \
+    TRACE (TRACE_ISR_ENTER, 1, 0, \
+           (code_addr_t) vector); \
     NestedISRs++;                 \
     vector##_impl ();             \
     NestedISRs--;                 \
+    TRACE (TRACE_ISR_EXIT, 1, 0,  \
+           (code_addr_t) vector); \
   }                               \
   void vector##_impl (void)
 
@@ -104,9 +108,14 @@
   void vector##_impl (void);                 \
   void vector (void) {                       \
     IRQSaveContext ();                       \
+    TRACE (TRACE_ISR_ENTER, 2, 0,            \
+           (code_addr_t) vector);            \
+    LATENCY_ISR_ENTER ();                    \
     NestedISRs++;                            \
     vector##_impl ();                        \
     NestedISRs--;                            \
+    TRACE (TRACE_ISR_EXIT, 2, 0,             \
+           (code_addr_t) vector);            \
     CheckPreemption (PREEMPT_ISR);           \
     IRQRestoreContext ();                    \
     __asm__ volatile ("reti");               \
@@ -64,6 +64,26 @@ void sdvos_memcpy (void * dst, void * src, udata_word_t count);
 void sdvos_memset (void * dst, udata_word_t ch,
                    udata_word_t count);
 
+/* Ready bitmap word. Each word covers 16 priorities. */
+typedef uint16_t PrioMapType;
+/* log2 of the number of bits in PrioMapType */
+#define PRIO_MAP_SHIFT  4
+
+/**
+ * @brief Find the most significant set bit.
+ *
+ * Return the index of the most significant bit set in a
+ * ready bitmap word. AVR has no count leading zeros
+ * instruction, so a nibble lookup table is used. The result
+ * is undefined if map is 0.
+ *
+ * @param[in] map
+ *   Non-zero ready bitmap word
+ * @return
+ *   Bit index in [0, 15]
+ */
+uint8_t HighestBit (PrioMapType map);
+
 #ifdef WITH_FLASH_UTILITY
 /**
  * @brief Load one byte from flash.
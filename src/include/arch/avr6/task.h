@@ -202,6 +202,15 @@ InitContext (TCB * task)
   task->context.regs.sreg |= (0 << 7);
 }
 
+/**
+ * @def SetWaitReturn
+ * @brief Set the return value of a blocked service
+ *
+ * A blocked service returns when the task is dispatched
+ * again and computes its return value itself.
+ */
+#define SetWaitReturn(task, ret)
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
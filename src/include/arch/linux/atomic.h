@@ -28,6 +28,11 @@
 #include <arch/linux/types.h>
 #include <cc.h>
 
+/*
+ * Atomic data types are 32-bit on both i386 and x86-64,
+ * which is what the l-suffixed instructions below operate
+ * on. Never use them to hold pointers.
+ */
 /* Signed atomic data type */
 typedef int32_t ALIGNED (4) atomic_t;
 /* Unsigned atomic data type */
@@ -140,6 +145,62 @@ typedef uint32_t ALIGNED (4) uatomic_t;
  */
 #define uatomic_set atomic_set
 
+/**
+ * @def uatomic_or
+ * @brief Unsigned atomic bitwise or
+ *
+ * Atomically set the bits of i in the unsigned value
+ * stored at v.
+ *
+ * @param[in] v
+ *   Reference to an uatomic type data
+ * @param[in] i
+ *   Bits to be set
+ */
+#define uatomic_or(v, i)                        \
+  __asm__ volatile ("lock; orl %1, %0\n\t"      \
+                    :"+m" (*(v))                \
+                    :"ir" ((uint32_t) (i)))
+
+/**
+ * @def uatomic_and
+ * @brief Unsigned atomic bitwise and
+ *
+ * Atomically clear the bits not in i of the unsigned
+ * value stored at v.
+ *
+ * @param[in] v
+ *   Reference to an uatomic type data
+ * @param[in] i
+ *   Bits to be kept
+ */
+#define uatomic_and(v, i)                       \
+  __asm__ volatile ("lock; andl %1, %0\n\t"     \
+                    :"+m" (*(v))                \
+                    :"ir" ((uint32_t) (i)))
+
+/**
+ * @def uatomic_fetch_inc32
+ * @brief Atomic 32-bit fetch and increase
+ *
+ * Atomically increase the 32-bit unsigned integer stored
+ * at v and return its value before the increment.
+ *
+ * @param[in] v
+ *   Reference to a uint32_t
+ *
+ * @return
+ *   Value stored at v before the increment
+ */
+#define uatomic_fetch_inc32(v) ({                \
+  uint32_t __old = 1;                           \
+  __asm__ volatile ("lock; xaddl %0, %1\n\t"    \
+                    :"+r" (__old), "+m" (*(v))  \
+                    :                           \
+                    :"memory");                 \
+  __old;                                        \
+})
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
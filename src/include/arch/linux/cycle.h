@@ -0,0 +1,66 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/arch/linux/cycle.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Linux Cycle Counter
+ */
+#ifndef _LINUX_CYCLE_H_
+#define _LINUX_CYCLE_H_
+
+#include <arch/linux/types.h>
+#include <time.h>
+
+/**
+ * @def ArchCycleInit
+ * @brief Start the cycle counter
+ *
+ * Nothing to do, CLOCK_MONOTONIC_RAW is used as the
+ * counter. It is not slewed by NTP and is read through the
+ * vDSO, without a system call.
+ */
+#define ArchCycleInit()
+
+/**
+ * @def ArchCycleFreq
+ * @brief Frequency of the cycle counter
+ *
+ * The Linux cycle counter counts nanoseconds.
+ */
+#define ArchCycleFreq()       (1000000000UL)
+
+/**
+ * @brief Read the cycle counter
+ *
+ * @return
+ *   Free running 32-bit count of CLOCK_MONOTONIC_RAW in ns
+ */
+static inline uint32_t
+ArchCycleCount (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC_RAW, &ts);
+  return (uint32_t) ts.tv_sec * 1000000000UL + (uint32_t) ts.tv_nsec;
+}
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
@@ -26,6 +26,7 @@
 #define _LINUX_INTERRUPT_H_
 
 #include <arch/linux/task.h>
+#include <arch/linux/timer.h>
 #include <sdvos.h>
 #include <signal.h>
 #include <stdio.h>
@@ -38,6 +39,52 @@
  */
 #define CONSTRUCTOR_ATTR     __attribute__((constructor))
 
+/**
+ * @def LINUX_NUM_VECTORS
+ * @brief Number of signals usable as interrupt vectors
+ *
+ * Pending interrupts are kept as bits of a 32-bit word, so
+ * only the standard signals (1 to 31) are supported.
+ */
+#define LINUX_NUM_VECTORS    32
+
+/**
+ * Interrupts in Linux are masked virtually. Instead of
+ * changing the signal mask of the process with a system
+ * call, a flag tells the signal handler that interrupts
+ * are disabled. Signals arriving in that state are only
+ * recorded in linux_irq_pending and delivered when the
+ * flag is cleared, in ascending signal number order.
+ */
+
+/** TRUE while interrupts are (virtually) disabled */
+extern volatile bool linux_irq_disabled;
+/** Signals received while interrupts were disabled */
+extern volatile uatomic_t linux_irq_pending;
+
+/**
+ * @brief Register an interrupt entry for a signal
+ *
+ * Installs the common signal handler for vector. entry is
+ * called with interrupts disabled when the signal is
+ * delivered.
+ *
+ * @param[in] vector
+ *   Interrupt vector (POSIX signal number)
+ * @param[in] entry
+ *   Interrupt entry function
+ */
+void LinuxInstallVector (int vector, void (* entry) (int));
+
+/**
+ * @brief Deliver pending interrupts
+ *
+ * Runs the interrupt entries of all the signals recorded
+ * while interrupts were disabled. It is called with
+ * interrupts enabled.
+ */
+void LinuxReplayInterrupts (void);
+
 /**
  * @def ISR_CAT1
  * @brief Definition macro for Category 1 ISR
@@ -57,22 +104,15 @@
   void vector##_handler_impl (int signo);      \
   void vector##_handler (int signo);           \
   void vector##_init (void) {                  \
-    struct sigaction act;                      \
-    act.sa_handler = vector##_handler;         \
-    sigemptyset (&act.sa_mask);                \
-    act.sa_flags = 0;                          \
-    if (sigaction (vector, &act, NULL) < 0) {  \
-      panic ();                                \
-    }                                          \
+    LinuxInstallVector (vector,                \
+                        vector##_handler);     \
   }                                            \
   void vector##_handler (int signo) {          \
-    sigset_t set, oset;                        \
-    sigfillset (&set);                         \
-    sigprocmask (SIG_SETMASK, &set, &oset);    \
+    TRACE (TRACE_ISR_ENTER, 1, 0, signo);      \
     uatomic_inc (&NestedISRs);                 \
     vector##_handler_impl (signo);             \
     uatomic_dec (&NestedISRs);                 \
-    sigprocmask (SIG_SETMASK, &oset, NULL);    \
+    TRACE (TRACE_ISR_EXIT, 1, 0, signo);       \
   }                                            \
   void vector##_handler_impl (int signo)
 
@@ -88,6 +128,9 @@
  * GetAlarm, SetRelAlarm, SetAbsAlarm, CancelAlarm
  * GetActiveApplicationMode, ShutdownOS
  *
+ * The system tick ISR (LINUX_TICK_VECTOR) leaves tickless
+ * idle in TickHandler, other ISRs before their body.
+ *
  * @param[in] vector
  *   Interrupt vector (POSIX signal number)
  */
@@ -96,34 +139,36 @@
   void vector##_handler_impl (int signo);      \
   void vector##_handler (int signo);           \
   void vector##_init (void) {                  \
-    struct sigaction act;                      \
-    act.sa_handler = vector##_handler;         \
-    sigemptyset (&act.sa_mask);                \
-    act.sa_flags = 0;                          \
-    if (sigaction (vector, &act, NULL) < 0) {  \
-      panic ();                                \
-    }                                          \
+    LinuxInstallVector (vector,                \
+                        vector##_handler);     \
   }                                            \
   void vector##_handler (int signo) {          \
-    sigset_t set, oset;                        \
-    sigfillset (&set);                         \
-    sigprocmask (SIG_SETMASK, &set, &oset);    \
+    TRACE (TRACE_ISR_ENTER, 2, 0, signo);      \
+    LATENCY_ISR_ENTER ();                      \
+    if (vector != LINUX_TICK_VECTOR) {         \
+      TICKLESS_ISR_ENTER ();                   \
+    }                                          \
     uatomic_inc (&NestedISRs);                 \
     vector##_handler_impl (signo);             \
     uatomic_dec (&NestedISRs);                 \
+    TRACE (TRACE_ISR_EXIT, 2, 0, signo);       \
     CheckPreemption (PREEMPT_ISR);             \
-    sigprocmask (SIG_SETMASK, &oset, NULL);    \
   }                                            \
   void vector##_handler_impl (int signo)
 
 /**
  * @def ArchEnableAllInterrupts
  * @brief Internal macro used by EnableAllInterrupts().
+ *
+ * Signals recorded while interrupts were disabled are
+ * delivered right away.
  */
 #define ArchEnableAllInterrupts() do {       \
-  sigset_t sigset;                           \
-  sigemptyset (&sigset);                     \
-  sigprocmask (SIG_SETMASK, &sigset, NULL);  \
+  __asm__ volatile ("" ::: "memory");        \
+  linux_irq_disabled = FALSE;                \
+  if (linux_irq_pending) {                   \
+    LinuxReplayInterrupts ();                \
+  }                                          \
 } while (0)
 
 /**
@@ -131,9 +176,8 @@
  * @brief Internal macro used by DisableAllInterrupts().
  */
 #define ArchDisableAllInterrupts() do {      \
-  sigset_t sigset;                           \
-  sigfillset (&sigset);                      \
-  sigprocmask (SIG_SETMASK, &sigset, NULL);  \
+  linux_irq_disabled = TRUE;                 \
+  __asm__ volatile ("" ::: "memory");        \
 } while (0)
 
 /*
@@ -28,14 +28,57 @@
 #include <arch/linux/types.h>
 #include <arch/linux/utils.h>
 #include <task.h>
-#include <ucontext.h>
-#include <signal.h>
 #include <stdlib.h>
+#ifdef LINUX_UCONTEXT
+#include <ucontext.h>
+#endif
+
+#if defined __x86_64__
+/* rbp, rbx, r12 - r15, return address and its padding */
+#define LINUX_START_FRAME_WORDS    8
+#else
+/* ebp, ebx, esi, edi, return address and its padding */
+#define LINUX_START_FRAME_WORDS    6
+#endif
+
+/**
+ * @brief Entry point of all the task contexts
+ *
+ * Enables interrupts, which are always disabled when the
+ * kernel switches to a task, and jumps to the task entry
+ * point.
+ */
+void LinuxTaskEntry (void);
+
+#ifdef LINUX_UCONTEXT
+/** Initial contexts of all the tasks (see LinuxInitContexts) */
+extern ucontext_t linux_start_contexts[NUM_TASKS];
+
+/**
+ * @brief Build the initial contexts of all the tasks
+ *
+ * Called once by McuInit after the task stacks are set up.
+ * getcontext and makecontext are only used here, InitContext
+ * copies the result.
+ */
+void LinuxInitContexts (void);
+#else
+/**
+ * @brief Initial stack frame of all the tasks
+ *
+ * Zeroed callee saved registers followed by the address of
+ * LinuxTaskEntry, popped by SwitchTask when a task is
+ * dispatched for the first time.
+ */
+extern const uintptr_t linux_start_frame[LINUX_START_FRAME_WORDS];
+#endif
 
 /**
  * @brief Initialize Processor Context
  *
- * Initialize Linux process context for a given task.
+ * Initialize Linux process context for a given task. The
+ * initial context is built only once and copied here, so
+ * that no system call is involved in task activation.
  *
  * @param[in] task
  *   Reference to the TCB of the task whose context will
@@ -46,20 +89,28 @@
 static inline void
 InitContext (TCB * task)
 {
-  extern void panic (void);
-  if (getcontext (&(task->context.context)) == -1) {
-    panic ();
-  }
-  task->context.context.uc_stack.ss_sp = (void *) task->sp_end;
-  task->context.context.uc_stack.ss_size = (task->bp - task->sp_end);
-  task->context.context.uc_stack.ss_flags = 0;
-  task->context.context.uc_link = (void *) 0;
-  /* Clear the signal mask */
-  sigemptyset (&(task->context.context.uc_sigmask));
-  makecontext (&(task->context.context),
-               (void (*) (void)) (task->start), 0);
+#ifdef LINUX_UCONTEXT
+  task->context.context = linux_start_contexts[task->tid];
+#else
+  /* Keep the stack 16-byte aligned at LinuxTaskEntry */
+  uintptr_t * stk = (uintptr_t *) ((task->bp & ~((data_addr_t) 0xF)) -
+                                   sizeof (linux_start_frame));
+
+  sdvos_memcpy ((void *) stk, (void *) linux_start_frame,
+                sizeof (linux_start_frame));
+  task->context.regs.sp = (void *) stk;
+#endif
 }
 
+/**
+ * @def SetWaitReturn
+ * @brief Set the return value of a blocked service
+ *
+ * A blocked service returns when the task is dispatched
+ * again and computes its return value itself.
+ */
+#define SetWaitReturn(task, ret)
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
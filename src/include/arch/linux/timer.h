@@ -0,0 +1,73 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/arch/linux/timer.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Linux Timer/Counter
+ */
+#ifndef _LINUX_TIMER_H_
+#define _LINUX_TIMER_H_
+
+#include <signal.h>
+
+/** Signal used as the system tick interrupt */
+#define LINUX_TICK_VECTOR    SIGALRM
+
+#ifdef LINUX_VIRTUAL_TIME
+#ifndef TICKLESS
+#error "LINUX_VIRTUAL_TIME requires TICKLESS"
+#endif
+
+/*
+ * In virtual time, IdleLoop never sleeps. The tickless
+ * one-shot period expires at once, so the system counter
+ * jumps straight to its next event whenever all the tasks
+ * are idle. While tasks run, every periodic tick advances
+ * the system counter by the time dilation factor read from
+ * the environment variable SDVOS_TIME_DILATION: a number
+ * (default 1), or "max" to stop the periodic tick
+ * altogether. In "max" mode, time only advances when the
+ * system is idle, which makes the task interleaving
+ * independent of the host. Tasks busy waiting on the
+ * system counter (Delay) never finish in that mode.
+ */
+
+/**
+ * @brief Account for a system tick interrupt
+ *
+ * Called by the tick ISR before TickHandler to keep track
+ * of the simulated time.
+ */
+void LinuxVirtualTick (void);
+
+/**
+ * @brief Skip to the next tick while idle
+ *
+ * Called by IdleLoop with interrupts disabled after
+ * TicklessIdle. If TicklessIdle did not skip ahead because
+ * the next tick is already due, and no interrupt is
+ * pending, that tick is raised right away.
+ */
+void LinuxVirtualIdle (void);
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
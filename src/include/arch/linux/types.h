@@ -25,17 +25,28 @@
 #ifndef _LINUX_TYPES_H_
 #define _LINUX_TYPES_H_
 
+#ifndef LINUX_UCONTEXT
+/* Field offsets in processor context structure */
+#if defined __x86_64__
+#define CONTEXT_OFFSET                             0x10
+#else
+#define CONTEXT_OFFSET                             0x08
+#endif
+#endif
+
 #ifndef __ASSEMBLER__
 
 #include <assert.h>
 #include <stdint.h>
 #include <stdbool.h>
+#ifdef LINUX_UCONTEXT
 #include <ucontext.h>
+#endif
 
 /* Integer with the same length as code pointer */
-typedef uint32_t code_addr_t;
+typedef uintptr_t code_addr_t;
 /* Integer with the same length as data pointer */
-typedef uint32_t data_addr_t;
+typedef uintptr_t data_addr_t;
 
 /* Platform default signed data type */
 typedef int32_t data_word_t;
@@ -46,6 +57,7 @@ typedef uint8_t FlagType;
 /* Type for OS service parameter (in debug structure) */
 typedef data_addr_t ParamType;
 
+#ifdef LINUX_UCONTEXT
 /**
  * @union task_context
  * @brief Linux process context
@@ -54,6 +66,21 @@ typedef union {
   ucontext_t context;                /**< Linux ucontext context */
   uint8_t raw[sizeof (ucontext_t)];  /**< Raw byte array */
 } task_context;
+#else
+/**
+ * @union task_context
+ * @brief Linux process context
+ *
+ * SwitchTask pushes the callee saved registers on the task
+ * stack. Only the stack pointer is kept in the context.
+ */
+typedef union {
+  struct {
+    void * sp;                       /**< Saved stack pointer */
+  } regs;                            /**< Linux registers */
+  uint8_t raw[sizeof (void *)];      /**< Raw byte array */
+} task_context;
+#endif
 
 #endif  /* __ASSEMBLER__ */
 
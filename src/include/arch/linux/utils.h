@@ -64,6 +64,24 @@ void sdvos_memcpy (void * dst, void * src, udata_word_t count);
 void sdvos_memset (void * dst, udata_word_t ch,
                    udata_word_t count);
 
+/* Ready bitmap word. Each word covers 32 priorities. */
+typedef uint32_t PrioMapType;
+/* log2 of the number of bits in PrioMapType */
+#define PRIO_MAP_SHIFT  5
+
+/**
+ * @def HighestBit
+ * @brief Find the most significant set bit.
+ *
+ * Return the index of the most significant bit set in a
+ * ready bitmap word. The result is undefined if map is 0.
+ *
+ * @param[in] map
+ *   Non-zero ready bitmap word
+ */
+#define HighestBit(map)                         \
+  ((uint8_t) (31 - __builtin_clz (map)))
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
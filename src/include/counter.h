@@ -29,27 +29,107 @@
 
 #include <osek/types.h>
 #include <osek/alarm.h>
+#include <osek/task.h>
 #include <autosar/schedtbl.h>
 
 struct counter_t;
 
-/** Flag for alarm overflow */
-#define ALARM_STATUS_OVF       (0x1U << 0)
+/**
+ * @brief This data type represents counter time
+ *
+ * Counter time is the TickType unless a counter needs more
+ * than half of the TickType range (see TICK_WINDOW). sdvgen
+ * defines WIDE_COUNTER_TIME for such counters, which doubles
+ * the width of counter time.
+ */
+#ifdef WIDE_COUNTER_TIME
+#if defined __ARCH_AVR5__ || defined __ARCH_AVR6__
+typedef uint32_t CounterTimeType;
+#else
+typedef uint64_t CounterTimeType;
+#endif
+#else
+typedef TickType CounterTimeType;
+#endif
+
 /** Flag for alarm activity */
-#define ALARM_STATUS_ACTIVE    (0x1U << 1)
+#define ALARM_STATUS_ACTIVE    (0x1U << 0)
+/** Flag for alarms queued behind a peer with the same expiration */
+#define ALARM_STATUS_PEER      (0x1U << 1)
+
+#ifdef TASK_TIMERS
+/** Number of task timers, kept after the OIL alarms */
+#define NUM_TASK_TIMERS        NUM_TASKS
+/**
+ * @def TaskTimer
+ * @brief Alarm ID of the timer of a task
+ *
+ * Every task owns a kernel alarm used for timed waits. It
+ * is armed on the counter given to the service and never
+ * visible to the application.
+ *
+ * @param[in] tid
+ *   Task ID
+ */
+#define TaskTimer(tid)         ((AlarmType) (NUM_ALARMS + (tid)))
+#else
+#define NUM_TASK_TIMERS        0
+#endif
 
-/** This data type represents an alarm object in alarm queue */
+/**
+ * @brief This data type represents an alarm object in alarm queue
+ *
+ * Alarms of a counter expiring at the same tick share one
+ * node of the alarm queue. The first of them is linked into
+ * the queue with next and prev, the others hang off it in
+ * the order they were set through peer. They are marked
+ * with ALARM_STATUS_PEER, and their prev points to the alarm
+ * before them in the node.
+ */
 typedef struct alarm_queue_t {
   AlarmType id;                /**< Alarm ID */
   struct counter_t * counter;  /**< Counter object */
   FlagType status;             /**< Status flag */
   TickType cycle;              /**< Period of alarm */
-  TickType exp;                /**< Next alarm expiration*/
+  CounterTimeType exp;         /**< Next expiration (counter time) */
   AlarmActionType action;      /**< Alarm expiration action */
   struct alarm_queue_t * next; /**< Next alarm in queue */
   struct alarm_queue_t * prev; /**< Previous alarm in queue */
+  struct alarm_queue_t * peer; /**< Next alarm of the same node */
+#ifdef USE_TIMING_WHEEL
+  uint32_t wexp;               /**< Timing wheel expiration */
+#endif
 } AlarmQueueType;
 
+#ifdef USE_TIMING_WHEEL
+/** Number of wheel time bits resolved by each wheel level */
+#define WHEEL_SLOT_BITS        4
+/** Number of slots in each wheel level */
+#define WHEEL_SLOTS            (0x1UL << WHEEL_SLOT_BITS)
+
+/**
+ * @brief This data type represents a hierarchical timing wheel
+ *
+ * A timing wheel replaces the sorted alarm queue of a counter
+ * selected with TIMINGWHEEL in OIL. Each level has
+ * WHEEL_SLOTS slots and resolves WHEEL_SLOT_BITS bits of the
+ * wheel time. An alarm is kept at the level of the highest
+ * digit in which its expiration differs from the current
+ * wheel time, and moved down a level each time that digit of
+ * the wheel time catches up. Slots are circular double linked
+ * lists kept in insertion order.
+ *
+ * The number of levels is computed by the system generator
+ * from maxallowedvalue and ticksperbase of the counter.
+ */
+typedef struct timing_wheel_t {
+  AlarmQueueType ** slots;     /**< Slots, WHEEL_SLOTS per level */
+  udata_word_t levels;         /**< Number of levels */
+  uint32_t now;                /**< Wheel time in counter ticks */
+  TickType lag;                /**< Counter ticks not yet processed */
+} TimingWheelType;
+#endif
+
 /* Schedule table flags */
 
 /* Schedule table synchronization strategy */
@@ -58,8 +138,6 @@ typedef struct alarm_queue_t {
 /** The schedule table is explicitly synchronized */
 #define SCHEDULETABLE_SYNC_EXPLICIT       (0x1U << 1)
 
-/** The schedule table next event tick overflow flag */
-#define SCHEDULETABLE_OVF                 (0x1U << 2)
 /**
  * The schedule table processing is started. This is
  * different from "RUNNING". This flag will be set when
@@ -74,19 +152,20 @@ typedef struct alarm_queue_t {
  * offset. When next_tick is reached, this flag will be set
  * for the schedule table.
  */
-#define SCHEDULETABLE_PROCESSING          (0x1U << 3)
+#define SCHEDULETABLE_PROCESSING          (0x1U << 2)
 /** The schedule table is in final delay */
-#define SCHEDULETABLE_DELAYING            (0x1U << 4)
+#define SCHEDULETABLE_DELAYING            (0x1U << 3)
 /** The schedule table is repeating */
-#define SCHEDULETABLE_REPEATING           (0x1U << 5)
+#define SCHEDULETABLE_REPEATING           (0x1U << 4)
 /** The schedule table is deviation sign bit (0 +, 1 -) */
-#define SCHEDULETABLE_DEVIATION_SIGN      (0x1U << 6)
+#define SCHEDULETABLE_DEVIATION_SIGN      (0x1U << 5)
 /** The schedule table need synchronization */
-#define SCHEDULETABLE_SYNCING             (0x1U << 7)
+#define SCHEDULETABLE_SYNCING             (0x1U << 6)
 
 /**
  * This data type represents an event list of a schedule
- * table expiry point
+ * table expiry point. sdvgen merges the events of a task
+ * into a single entry.
  */
 typedef struct expiry_point_event_list {
   TaskType tid;                          /**< Task ID */
@@ -96,9 +175,8 @@ typedef struct expiry_point_event_list {
 /** This data type represents a schedule table expiry point */
 typedef struct expiry_point_t {
   TickType offset;                /**< Expiry point offset */
-  TaskType * tasks;               /**< Expiry point tasks */
-  udata_word_t num_tasks;         /**< Number of tasks */
-  ExpiryPointEventList * events;  /**< Expiry point events */
+  TaskSetType tasks;              /**< Expiry point tasks */
+  const ExpiryPointEventList * events; /**< Expiry point events */
   udata_word_t num_events;        /**< Number of events */
 #ifdef SCHEDTBL_SYNC
   TickType max_shorten;           /**< Max tick can be substracted */
@@ -115,7 +193,7 @@ typedef struct sched_tbl_struct_t {
   struct counter_t * counter;     /**< Counter object */
   ScheduleTableStatusType status; /**< Schedule table status */
   FlagType flag;                  /**< Schedule table flag */
-  TickType next_tick;             /**< Schedule table next event tick */
+  CounterTimeType next_tick;      /**< Next event (counter time) */
   TickType delay;                 /**< Schedule table final delay */
   ExpiryPointType * exps;         /**< Schedule table expiry points */
   udata_word_t next_exp;          /**< Next expiry points index */
@@ -181,18 +259,52 @@ typedef struct sched_tbl_autostart_t {
   AppModeType appmode;              /**< AppMode */
 } ScheduleTableAutoStartType;
 
-/** Flag for counter overflow */
-#define COUNTER_STATUS_OVF     (0x1U << 0)
+/**
+ * @def TICK_WINDOW
+ * @brief Half of the counter time range
+ *
+ * Alarm expirations and schedule table event ticks are
+ * kept in counter time, which wraps around at the range of
+ * CounterTimeType instead of maxallowedvalue. A pending event is at
+ * most maxallowedvalue + 1 ticks ahead of the counter time,
+ * or ticksperbase - 1 ticks behind it before it gets
+ * processed. sdvgen keeps both below TICK_WINDOW, so that
+ * the window of TickType range starting TICK_WINDOW - 1
+ * ticks before the counter time holds all of them.
+ */
+#define TICK_WINDOW                                            \
+  ((CounterTimeType) ((((CounterTimeType) ~0ULL) >> 1) + 1))
 
 /** This data type represents a counter object */
 typedef struct counter_t {
   TickType count;                     /**< Counter count */
   AlarmBaseType properties;           /**< Counter properties */
-  FlagType status;                    /**< Counter status flag */
+  /**
+   * @brief Counter time
+   *
+   * Moves forward with count, but wraps around at the
+   * CounterTimeType range. All the counter events are
+   * expressed in counter time, see TICK_WINDOW.
+   */
+  CounterTimeType ticks;
   AlarmQueueType * alarms;            /**< Alarm queue */
+#ifdef USE_TIMING_WHEEL
+  TimingWheelType * wheel;            /**< Timing wheel (optional) */
+#endif
 #ifdef USE_SCHEDTBL
   ScheduleTableStructType * schedtbl; /**< Schedule table(s) */
 #endif
+  /**
+   * @brief Next event tick
+   *
+   * Earliest expiration among the alarms in the alarm queue
+   * and the running schedule tables of the counter in
+   * counter time. It may be earlier than the actual next
+   * event (e.g. after CancelAlarm) but never later. Counter
+   * updates before this tick do not need to check alarms or
+   * schedule tables.
+   */
+  CounterTimeType next_tick;
 } Counter;
 
 /**
@@ -209,129 +321,81 @@ typedef struct counter_t {
   ((alarms[alarm].status & ALARM_STATUS_ACTIVE) ? 1 : 0)
 
 /**
- * @def CouterOVF
- * @brief Retrieves the OVF bit of a counter
+ * @def TickPos
+ * @brief Position of an event tick in the window of a counter
  *
- * Retrieves the value of OVF bit in status flag of a
- * counter.
+ * Returns the offset of tick from the start of the counter
+ * window (see TICK_WINDOW). Pending events of a counter are
+ * ordered by their position.
  *
  * @param[in] counter
  *   Reference to a counter object
+ * @param[in] tick
+ *   Event tick in counter time
  */
-#define CounterOVF(counter)                    \
-  ((counter->status & COUNTER_STATUS_OVF) ? 1 : 0)
+#define TickPos(counter, tick)                                 \
+  ((CounterTimeType) ((tick) - (counter)->ticks + (TICK_WINDOW - 1)))
 
 /**
- * @def AlarmOVF
- * @brief Retrieves the OVF bit of an alarm
+ * @def TickDue
+ * @brief Check whether a counter reached an event tick
  *
- * Retrieves the value of OVF bit in status flag of an
- * alarm.
- *
- * @param[in] alarm
- *   Alarm ID of type AlarmType
- */
-#define AlarmOVF(alarm)                        \
-  ((alarms[alarm].status & ALARM_STATUS_OVF) ? 1 : 0)
-
-/**
- * @def ScheduleTableOVF
- * @brief Retrieves the OVF bit of a schedule table
- *
- * Retrieves the value of OVF bit in flag of a schedule
- * table.
- *
- * @param[in] tbl
- *   Schedule table ID of type ScheduleTableType
- */
-#define ScheduleTableOVF(tbl)                  \
-  ((schedtbls[tbl].flag & SCHEDULETABLE_OVF) ? 1 : 0)
-
-/**
- * @def ToggleCounterOVF
- * @brief Toggles the OVF bit of a counter
- *
- * Toggles the OVF bit in the status flag of a counter.
- * The OVF bit of a counter will be toggled every time
- * its count overflows.
+ * Returns 1 if the counter time is not before tick, that
+ * is the event is in the first half of the counter window.
  *
  * @param[in] counter
  *   Reference to a counter object
+ * @param[in] tick
+ *   Event tick in counter time
  */
-#define ToggleCounterOVF(counter)                            \
-  ((counter->status & COUNTER_STATUS_OVF) ?                  \
-  (counter->status &= (~((FlagType) COUNTER_STATUS_OVF))) :  \
-  (counter->status |= COUNTER_STATUS_OVF))
-
-/**
- * @def ToggleAlarmOVF
- * @brief Toggles the OVF bit of an alarm based on its
- * counter OVF status
- *
- * Toggles the OVF bit in the status flag of an alarm
- * according to its counter OVF status.
- *
- * @param[in] alarm
- *   Alarm ID of type AlarmType
- */
-#define ToggleAlarmOVF(alarm)                                   \
-  ((alarms[alarm].counter->status & COUNTER_STATUS_OVF) ?       \
-  (alarms[alarm].status &= (~((FlagType) ALARM_STATUS_OVF))) :  \
-  (alarms[alarm].status |= ALARM_STATUS_OVF))
+#define TickDue(counter, tick)                                 \
+  (((CounterTimeType) ((counter)->ticks - (tick)) <             \
+    TICK_WINDOW) ? 1 : 0)
 
 /**
- * @def SetAlarmOVF
- * @brief Set the OVF bit of an alarm to its counter
- * OVF status
- *
- * Sets the OVF bit in the status flag of an alarm to its
- * counter OVF value.
+ * @def CounterEventDue
+ * @brief Check whether a counter reached its next event tick
  *
- * @param[in] alarm
- *   Alarm ID of type AlarmType
+ * @param[in] counter
+ *   Reference to a counter object
  */
-#define SetAlarmOVF(alarm)                                      \
-  ((alarms[alarm].counter->status & COUNTER_STATUS_OVF) ?       \
-  (alarms[alarm].status |= ALARM_STATUS_OVF) :                  \
-  (alarms[alarm].status &= (~((FlagType) ALARM_STATUS_OVF))))   \
+#define CounterEventDue(counter)                               \
+  TickDue ((counter), (counter)->next_tick)
 
 /**
- * @def ToggleScheduleTableOVF
- * @brief Toggles the OVF bit of a schedule table based on
- * its counter OVF status
+ * @brief This service increments a software counter.
  *
- * Toggles the OVF bit in the flag of a schedule table
- * according to its counter OVF status.
+ * @param[in] CounterID
+ *   The counter to be incremented
  *
- * @param[in] tbl
- *   Schedule table ID of type ScheduleTableType
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_ID
+ *   (Extended) CounterID not valid or counter is implemented
+ *   in hardware and can not be incremented by software
  */
-#define ToggleScheduleTableOVF(tbl)                             \
-  ((schedtbls[tbl].counter->status & COUNTER_STATUS_OVF) ?      \
-  (schedtbls[tbl].flag &= (~((FlagType) SCHEDULETABLE_OVF))) :  \
-  (schedtbls[tbl].flag |= SCHEDULETABLE_OVF))
+StatusType IncrementCounter (CounterType CounterID);
 
 /**
- * @def SetScheduleTableOVF
- * @brief Set the OVF bit of a schedule table to its counter
- * OVF status
+ * @brief
+ * This service increments a software counter several times
+ * in one call.
  *
- * Sets the OVF bit in the flag of a schedule table to its
- * counter OVF value.
+ * The effect is the same as calling IncrementCounter
+ * Increments times in a row: all the alarms and schedule
+ * table expiry points inside the window are processed in
+ * chronological order, including cyclic alarms expiring
+ * more than once. Rescheduling only happens once, at the
+ * end of the service.
  *
- * @param[in] tbl
- *   Schedule table ID of type ScheduleTableType
- */
-#define SetScheduleTableOVF(tbl)                                \
-  ((schedtbls[tbl].counter->status & COUNTER_STATUS_OVF) ?      \
-  (schedtbls[tbl].flag |= SCHEDULETABLE_OVF) :                  \
-  (schedtbls[tbl].flag &= (~((FlagType) SCHEDULETABLE_OVF))))   \
-
-/**
- * @brief This service increments a software counter.
+ * Increments may span several counter cycles, in standard
+ * as well as extended status. Zero increments leave the
+ * counter untouched.
  *
  * @param[in] CounterID
  *   The counter to be incremented
+ * @param[in] Increments
+ *   Number of increments
  *
  * @retval E_OK
  *   (Standard) No error
@@ -339,7 +403,8 @@ typedef struct counter_t {
  *   (Extended) CounterID not valid or counter is implemented
  *   in hardware and can not be incremented by software
  */
-StatusType IncrementCounter (CounterType CounterID);
+StatusType IncrementCounterBy (CounterType CounterID,
+                               TickType Increments);
 
 /**
  * @brief
@@ -407,6 +472,69 @@ StatusType GetElapsedValue (CounterType CounterID,
  */
 StatusType Delay (CounterType CounterID, TickType Counts);
 
+#ifdef TASK_TIMERS
+/**
+ * @brief Wait for events with a timeout
+ *
+ * Same as WaitEvent, except that the calling task is also
+ * released when Ticks ticks of a counter elapse before any
+ * of the events in Mask is set. Unlike Delay, the task does
+ * not consume the processor while waiting.
+ *
+ * @param[in] Mask
+ *   Mask of the events waited for
+ * @param[in] CounterID
+ *   Counter the timeout is relative to
+ * @param[in] Ticks
+ *   Timeout in ticks of the counter
+ *
+ * @retval E_OK
+ *   (Standard) At least one of the events is set
+ * @retval E_OS_SYS_TIMEOUT
+ *   (Standard) The timeout expired first
+ * @retval E_OS_ACCESS
+ *   (Extended) Calling task is not an extended task
+ * @retval E_OS_RESOURCE
+ *   (Extended) Calling task occupies resource
+ * @retval E_OS_CALLEVEL
+ *   (Extended) Call at interrupt level
+ * @retval E_OS_ID
+ *   (Extended) CounterID not valid
+ * @retval E_OS_VALUE
+ *   (Extended) Ticks is 0 or greater than maxallowedvalue
+ */
+StatusType WaitEventTimeout (EventMaskType Mask,
+                             CounterType CounterID,
+                             TickType Ticks);
+
+/**
+ * @brief Sleep for a number of counter ticks
+ *
+ * The calling task is put in the waiting state until Ticks
+ * ticks of a counter elapse. Events set meanwhile do not
+ * release it.
+ *
+ * @param[in] CounterID
+ *   Counter the sleep is relative to
+ * @param[in] Ticks
+ *   Sleep time in ticks of the counter
+ *
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_ACCESS
+ *   (Extended) Calling task is not an extended task
+ * @retval E_OS_RESOURCE
+ *   (Extended) Calling task occupies resource
+ * @retval E_OS_CALLEVEL
+ *   (Extended) Call at interrupt level
+ * @retval E_OS_ID
+ *   (Extended) CounterID not valid
+ * @retval E_OS_VALUE
+ *   (Extended) Ticks is 0 or greater than maxallowedvalue
+ */
+StatusType SleepTicks (CounterType CounterID, TickType Ticks);
+#endif
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
@@ -0,0 +1,99 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/cycle.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  High Resolution Cycle Counter
+ *
+ * The cycle counter is a free running 32-bit counter
+ * started by StartOS:
+ *
+ *   ARMv7-M: DWT CYCCNT (core clock)
+ *   AVR: Timer 1 extended by the system tick interrupt
+ *   Linux: CLOCK_MONOTONIC_RAW in nanoseconds
+ *
+ * Durations are computed as the difference of two counts,
+ * which is correct across a wrap around as long as they are
+ * less than 2^32 cycles apart.
+ */
+#ifndef _CYCLE_H_
+#define _CYCLE_H_
+
+#include <osek/types.h>
+
+/** This data type represents a cycle counter value */
+typedef uint32_t CycleType;
+
+#ifdef ARCH_CYCLE_PRIVILEGED
+/**
+ * @brief Read the cycle counter
+ *
+ * The cycle counter of this architecture can only be read
+ * in privileged mode. The kernel and ISRs read it directly,
+ * tasks go through a system call.
+ *
+ * @return
+ *   Current cycle count
+ */
+CycleType GetCycleCount (void);
+
+/**
+ * @brief Internal service implementation for GetCycleCount
+ *
+ * @return
+ *   Current cycle count
+ */
+CycleType Sys_GetCycleCount (void);
+#else
+/**
+ * @def GetCycleCount
+ * @brief Read the cycle counter
+ *
+ * @return
+ *   Current cycle count
+ */
+#define GetCycleCount()         ((CycleType) ArchCycleCount ())
+#endif
+
+/**
+ * @def GetCycleFreq
+ * @brief Frequency of the cycle counter
+ *
+ * Derived from the board clock setup.
+ *
+ * @return
+ *   Cycles per second
+ */
+#define GetCycleFreq()          ((uint32_t) ArchCycleFreq ())
+
+/**
+ * @brief Convert cycles to nanoseconds
+ *
+ * @param[in] cycles
+ *   Number of cycles (e.g. difference of two counts)
+ *
+ * @return
+ *   Nanoseconds
+ */
+uint64_t CyclesToNs (uint64_t cycles);
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
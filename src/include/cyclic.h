@@ -0,0 +1,87 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/cyclic.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Cyclic Executive Dispatcher
+ *
+ * The cyclic executive is only built when CYCLIC_EXECUTIVE
+ * is defined (CYCLICEXECUTIVE = TRUE in OIL). The system
+ * generator compiles all the cyclic SYS_COUNTER alarms
+ * into one dispatch table per application mode. A table
+ * covers one hyperperiod and lists the ticks at which
+ * tasks are activated. The tick ISR walks the table
+ * instead of processing alarms.
+ */
+#ifndef _CYCLIC_H_
+#define _CYCLIC_H_
+
+#include <osek/types.h>
+#include <osek/task.h>
+
+#ifdef CYCLIC_EXECUTIVE
+
+#if defined TICKLESS || defined TASK_TIMERS
+#error "CYCLIC_EXECUTIVE does not support TICKLESS or TASK_TIMERS!"
+#endif
+
+/** This data type represents a slot of a dispatch table */
+typedef struct cyclic_slot_t {
+  TickType tick;               /**< Tick in hyperperiod (from 1) */
+  TaskSetType tasks;           /**< Tasks activated at tick */
+} CyclicSlotType;
+
+/** This data type represents a dispatch table */
+typedef struct cyclic_table_t {
+  const CyclicSlotType * slots;  /**< Slots in tick order */
+  TickType num_slots;            /**< Number of slots */
+  TickType hyperperiod;          /**< Table length in ticks */
+} CyclicTableType;
+
+/** Dispatch table of each application mode */
+extern const CyclicTableType cyclic_tables[];
+
+/**
+ * @brief Start the dispatch table of an application mode
+ *
+ * Internal use only. Called by AlarmInit before the
+ * system tick is started.
+ *
+ * @param[in] mode
+ *   Application mode
+ */
+void CyclicInit (AppModeType mode);
+
+/**
+ * @brief Activate the tasks due at the current tick
+ *
+ * Internal use only. Called by TickHandler once per system
+ * tick after the system counter is updated. Activations
+ * are the same as ActivateTaskSet, a task still running
+ * from its previous slot is reported to ErrorHook with
+ * E_OS_LIMIT.
+ */
+void CyclicTick (void);
+
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
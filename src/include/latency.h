@@ -0,0 +1,187 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/latency.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Release to Dispatch Latency Histograms
+ *
+ * Latencies are only recorded when LATENCY_HIST is defined
+ * (LATENCYHIST = TRUE in OIL). A task released by an ISR2,
+ * an alarm or SetEvent is marked with the time of the
+ * release, and the latency is recorded when the task is
+ * dispatched. Latencies are in cycles of the architecture
+ * cycle counter and counted in log2 buckets.
+ */
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+#include <osek/types.h>
+
+/** Type of a latency histogram */
+typedef uint8_t LatencyType;
+
+/** No release pending */
+#define LATENCY_NONE           0
+/**
+ * ISR2 entry to dispatch of the task it activated or
+ * released. With nested ISRs, from the outermost entry.
+ */
+#define LATENCY_ISR            1
+/** Alarm expiry to dispatch of the task it activated or released */
+#define LATENCY_ALARM          2
+/** SetEvent at task level to dispatch of the waiting task */
+#define LATENCY_EVENT          3
+/** Number of latency histograms */
+#define NUM_LATENCY            3
+
+/**
+ * Number of buckets. Bucket n counts latencies from
+ * 2^n to 2^(n+1) - 1 cycles (bucket 0 also counts 0).
+ */
+#define LATENCY_BUCKETS        32
+
+#ifdef LATENCY_HIST
+
+/** This data type represents a latency histogram */
+typedef struct latency_hist {
+  uint32_t count;                       /**< Number of samples */
+  uint32_t min;                         /**< Min latency */
+  uint32_t max;                         /**< Max latency */
+  uint32_t buckets[LATENCY_BUCKETS];    /**< log2 buckets */
+} LatencyHistType;
+
+/** Reference to LatencyHistType */
+typedef LatencyHistType * LatencyHistRefType;
+
+/** Release pending dispatch, kept in the TCB */
+typedef struct latency_release {
+  uint32_t stamp;              /**< Time of the release */
+  LatencyType type;            /**< LATENCY_NONE if none */
+} LatencyReleaseType;
+
+/** Cycle count at the entry of the outermost ISR2 */
+extern uint32_t latency_isr;
+
+/**
+ * @brief Get a latency histogram
+ *
+ * The histogram is copied and optionally cleared in one
+ * step, so no sample is lost between the two.
+ *
+ * @param[in] Type
+ *   LATENCY_ISR, LATENCY_ALARM or LATENCY_EVENT
+ * @param[out] Hist
+ *   Reference to the copy of the histogram
+ * @param[in] Reset
+ *   Clear the histogram after copying it
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid Type)
+ */
+StatusType GetLatencyHist (LatencyType Type, LatencyHistRefType Hist,
+                           bool Reset);
+
+/**
+ * @brief Internal service implementation for GetLatencyHist
+ *
+ * @param[in] Type
+ *   LATENCY_ISR, LATENCY_ALARM or LATENCY_EVENT
+ * @param[out] Hist
+ *   Reference to the copy of the histogram
+ * @param[in] Reset
+ *   Clear the histogram after copying it
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid Type)
+ */
+StatusType Sys_GetLatencyHist (LatencyType Type,
+                               LatencyHistRefType Hist, bool Reset);
+
+/**
+ * @brief Initialize latency histograms
+ *
+ * Internal use only.
+ */
+void LatencyInit (void);
+
+/**
+ * @brief Mark a task released
+ *
+ * Internal use only. Called before the task state changes.
+ * The source of the release is the alarm being fired, else
+ * the ISR2 being served, else SetEvent at task level if
+ * event is set. Only the first release before a dispatch
+ * is kept and queued activations are ignored.
+ *
+ * @param[in] tid
+ *   Task activated or released from waiting
+ * @param[in] event
+ *   Released by SetEvent
+ */
+void LatencyRelease (TaskType tid, bool event);
+
+/**
+ * @brief Record the latency of a task being dispatched
+ *
+ * Internal use only.
+ *
+ * @param[in] tid
+ *   Task being dispatched
+ */
+void LatencyDispatch (TaskType tid);
+
+/**
+ * @brief Set or clear the alarm expiry context
+ *
+ * Internal use only. Releases between LatencyAlarm (TRUE)
+ * and LatencyAlarm (FALSE) are accounted to the alarm.
+ *
+ * @param[in] on
+ *   TRUE when entering an alarm action
+ */
+void LatencyAlarm (bool on);
+
+/**
+ * @def LATENCY_ISR_ENTER
+ * @brief Take the ISR2 entry time
+ *
+ * Used in the ISR2 entry before NestedISRs is incremented.
+ */
+#define LATENCY_ISR_ENTER() do {                           \
+  if (!NestedISRs) latency_isr = ArchCycleCount ();        \
+} while (0)
+#define LATENCY_RELEASE(tid, event)  LatencyRelease (tid, event)
+#define LATENCY_DISPATCH(tid)        LatencyDispatch (tid)
+#define LATENCY_ALARM_ACTION(on)     LatencyAlarm (on)
+
+#else
+
+#define LATENCY_ISR_ENTER()
+#define LATENCY_RELEASE(tid, event)
+#define LATENCY_DISPATCH(tid)
+#define LATENCY_ALARM_ACTION(on)
+
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
@@ -35,6 +35,8 @@
 #define ALARM_ACTION_SETEVENT      0x0U
 #define ALARM_ACTION_ACTIVATETASK  0x1U
 #define ALARM_ACTION_CALLBACK      0x2U
+/* Task timer expiration (internal, see TaskTimer) */
+#define ALARM_ACTION_TIMEOUT       0x3U
 
 /** This data type represents types of alarm actions */
 typedef udata_word_t ActionType;
@@ -38,6 +38,9 @@
 #define E_OS_STATE       0x7
 #define E_OS_VALUE       0x8
 
+/* Implementation specific errors */
+#define E_OS_SYS_TIMEOUT 0x20
+
 #endif
 
 /* vi: set et ai sw=2 sts=2: */
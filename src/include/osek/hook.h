@@ -393,6 +393,108 @@ extern struct OSErrorService_t OSErrorService;
   ((TickRefType) OSErrorService.param2)
 #endif
 
+/** Service ID of IncrementCounterBy */
+#define OSServiceId_IncrementCounterBy          0x23u
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service IncrementCounterBy */
+#define OSError_IncrementCounterBy_CounterID()    \
+  ((CounterType) OSErrorService.param1)
+/** Macro to access parameter of service IncrementCounterBy */
+#define OSError_IncrementCounterBy_Increments()    \
+  ((TickType) OSErrorService.param2)
+#endif
+
+/** Service ID of WaitEventTimeout */
+#define OSServiceId_WaitEventTimeout            0x24u
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service WaitEventTimeout */
+#define OSError_WaitEventTimeout_Mask()    \
+  ((EventMaskType) OSErrorService.param1)
+/** Macro to access parameter of service WaitEventTimeout */
+#define OSError_WaitEventTimeout_CounterID()    \
+  ((CounterType) OSErrorService.param2)
+/** Macro to access parameter of service WaitEventTimeout */
+#define OSError_WaitEventTimeout_Ticks()    \
+  ((TickType) OSErrorService.param3)
+#endif
+
+/** Service ID of SleepTicks */
+#define OSServiceId_SleepTicks                  0x25u
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service SleepTicks */
+#define OSError_SleepTicks_CounterID()    \
+  ((CounterType) OSErrorService.param1)
+/** Macro to access parameter of service SleepTicks */
+#define OSError_SleepTicks_Ticks()    \
+  ((TickType) OSErrorService.param2)
+#endif
+
+/** Service ID of ActivateTaskSet */
+#define OSServiceId_ActivateTaskSet             0x26u
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service ActivateTaskSet */
+#define OSError_ActivateTaskSet_TaskSet()    \
+  ((TaskSetRefType) OSErrorService.param1)
+#endif
+
+/** Service ID of GetTaskStats */
+#define OSServiceId_GetTaskStats                0x27u
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service GetTaskStats */
+#define OSError_GetTaskStats_TaskID()    \
+  ((TaskType) OSErrorService.param1)
+/** Macro to access parameter of service GetTaskStats */
+#define OSError_GetTaskStats_Stats()    \
+  ((TaskStatsRefType) OSErrorService.param2)
+#endif
+
+/** Service ID of GetLatencyHist */
+#define OSServiceId_GetLatencyHist              0x28u
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service GetLatencyHist */
+#define OSError_GetLatencyHist_Type()    \
+  ((LatencyType) OSErrorService.param1)
+/** Macro to access parameter of service GetLatencyHist */
+#define OSError_GetLatencyHist_Hist()    \
+  ((LatencyHistRefType) OSErrorService.param2)
+/** Macro to access parameter of service GetLatencyHist */
+#define OSError_GetLatencyHist_Reset()    \
+  ((bool) OSErrorService.param3)
+#endif
+
+/** Service ID of GetSysProf */
+#define OSServiceId_GetSysProf                  0x29u
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service GetSysProf */
+#define OSError_GetSysProf_ServiceID()    \
+  ((OSServiceIdType) OSErrorService.param1)
+/** Macro to access parameter of service GetSysProf */
+#define OSError_GetSysProf_Prof()    \
+  ((SysProfRefType) OSErrorService.param2)
+/** Macro to access parameter of service GetSysProf */
+#define OSError_GetSysProf_Reset()    \
+  ((bool) OSErrorService.param3)
+#endif
+
+/** Service ID of GetStackUsage */
+#define OSServiceId_GetStackUsage               0x2Au
+
+#if defined(USEPARAMETERACCESS) && (USEPARAMETERACCESS == 0x1)
+/** Macro to access parameter of service GetStackUsage */
+#define OSError_GetStackUsage_StackID()    \
+  ((TaskType) OSErrorService.param1)
+/** Macro to access parameter of service GetStackUsage */
+#define OSError_GetStackUsage_Usage()    \
+  ((StackUsageRefType) OSErrorService.param2)
+#endif
+
 /*
  * Macros for hook routines. When not configured, they
  * become empty statements.
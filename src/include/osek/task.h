@@ -102,6 +102,58 @@
  */
 StatusType ActivateTask (TaskType tid);
 
+/** This data type represents a set of tasks activated at once */
+typedef struct task_set_t {
+  const TaskType * tasks;   /**< Tasks in activation order */
+  udata_word_t num_tasks;   /**< Number of tasks */
+} TaskSetType;
+
+/** This data type points to a TaskSetType */
+typedef const TaskSetType * TaskSetRefType;
+
+/**
+ * @def DeclareTaskSet(name, ...)
+ * @brief Defines a constant task set
+ *
+ * @param[in] name
+ *   Name of the TaskSetType object
+ * @param[in] ...
+ *   Tasks of the set, in activation order
+ */
+#define DeclareTaskSet(name, ...)                            \
+  static const TaskType name##_tasks[] = { __VA_ARGS__ };   \
+  static const TaskSetType name = {                          \
+    name##_tasks, sizeof (name##_tasks) / sizeof (TaskType)  \
+  }
+
+/**
+ * @brief
+ * SDVOS extension. Activates all tasks of TaskSet in one
+ * system call. The result is the same as calling
+ * ActivateTask for each task in order, but rescheduling
+ * takes place only once after the last activation.
+ *
+ * In extended status, the whole set is validated first and
+ * no task is activated if any ID is invalid. A task that
+ * reached its activation limit is skipped and reported to
+ * ErrorHook as a failed ActivateTask of that task, the
+ * other tasks are still activated.
+ *
+ * Conformance:
+ *   BCC1, BCC2, ECC1, ECC2
+ *
+ * @param[in] TaskSet
+ *   Reference to the task set
+ *
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_LIMIT
+ *   (Standard) Too many activations of at least one task
+ * @retval E_OS_ID
+ *   (Extended) The set contains an invalid task
+ */
+StatusType ActivateTaskSet (TaskSetRefType TaskSet);
+
 /**
  * @brief
  * This service causes the termination of the calling task.
@@ -38,14 +38,17 @@
 #include <arch/avr/mcu.h>
 #include <arch/avr/task.h>
 #include <arch/avr/atomic.h>
+#include <arch/avr/cycle.h>
 #elif defined __ARCH_ARMV7M__
 #include <arch/armv7m/mcu.h>
 #include <arch/armv7m/task.h>
 #include <arch/armv7m/atomic.h>
+#include <arch/armv7m/cycle.h>
 #elif defined __ARCH_LINUX__
 #include <arch/linux/mcu.h>
 #include <arch/linux/task.h>
 #include <arch/linux/atomic.h>
+#include <arch/linux/cycle.h>
 #else
 /* Use i386 simulation as default */
 #include <arch/i386/mcu.h>
@@ -53,6 +56,13 @@
 #include <arch/i386/atomic.h>
 #endif
 
+#include <cycle.h>
+#include <stats.h>
+#include <trace.h>
+#include <sysprof.h>
+#include <stackmon.h>
+#include <cyclic.h>
+
 #ifndef NULL
 #define NULL ((void *)0)
 #endif
@@ -217,6 +227,9 @@ extern IRQType isr2_list[NUM_ISR2];
  * This will make the specified task the "newest" task
  * in its priority queue and get it scheduled last.
  *
+ * With EDF_SCHEDULER, the task is inserted by deadline
+ * behind the tasks with an earlier or equal deadline.
+ *
  * @param[in] tid
  *   Task to be enqueued.
  * @return
@@ -230,6 +243,9 @@ void EnqueueTaskTail (TaskType tid);
  * This will make the specified task the "oldest" task
  * in its priority queue and get it scheduled first.
  *
+ * With EDF_SCHEDULER, this is only used for a preempted
+ * task, which is pushed on the preemption stack.
+ *
  * @param[in] tid
  *   Task to be enqueued.
  * @return
@@ -299,6 +315,12 @@ void SwitchTask (TCB * src, TCB * dst);
  * queue. Use [0, MAX_PRIO] as the segment if next highest
  * priority ready task is needed.
  *
+ * With EDF_SCHEDULER, priorities are preemption levels and
+ * the task with the earliest deadline in the segment is
+ * returned. A segment with min above 0 only returns tasks
+ * with an earlier deadline than the running task. See
+ * task.c for the stack resource policy rules.
+ *
  * @param[out] tid_ref
  *   Reference to the current highest priority ready task.
  *   INVALID_TASK if there is no ready task.
@@ -371,6 +393,9 @@ void Dispatch (TaskType tid, FlagType flag);
  * is higher priority ready task, current task will be
  * preempted. Otherwise, CheckPreemption will simply return.
  *
+ * With TIME_SLICING, a task whose time slice expired is
+ * also moved behind the other ready tasks of its priority.
+ *
  * PREEMPT_ISR or PREEMPT_SCHED must be specified as the
  * calling context. If PREEMPT_ISR is specified, source
  * task's context might not be preserved since the ISR
@@ -384,6 +409,17 @@ void Dispatch (TaskType tid, FlagType flag);
  */
 void CheckPreemption (FlagType flag);
 
+#ifdef TIME_SLICING
+/**
+ * @brief Charge one system tick to the running task's slice
+ *
+ * Called from TickHandler. When the time slice of the
+ * running task expires, the task is marked and the
+ * following CheckPreemption does the rotation.
+ */
+void TimeSliceTick (void);
+#endif
+
 /**
  * @brief Interrupt Management Initialization.
  */
@@ -432,6 +468,62 @@ StatusType Sys_ActivateTask (TaskType tid);
  */
 StatusType Sys_ActivateTask_Preempt (TaskType tid);
 
+/**
+ * @brief Internal service implementation for ActivateTaskSet
+ *
+ * Should only be called in kernel context. See syscall.c
+ * for actual service interface.
+ *
+ * @param[in] TaskSet
+ *   Reference to the task set
+ *
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_LIMIT
+ *   (Standard) Too many activations of at least one task
+ * @retval E_OS_ID
+ *   (Extended) The set contains an invalid task
+ */
+StatusType Sys_ActivateTaskSet (TaskSetRefType TaskSet);
+
+/**
+ * @brief
+ * Internal service implementation for ActivateTaskSet with
+ * preemption.
+ *
+ * Should only be called in kernel context. See syscall.c
+ * for actual service interface.
+ *
+ * @param[in] TaskSet
+ *   Reference to the task set
+ *
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_LIMIT
+ *   (Standard) Too many activations of at least one task
+ * @retval E_OS_ID
+ *   (Extended) The set contains an invalid task
+ */
+StatusType Sys_ActivateTaskSet_Preempt (TaskSetRefType TaskSet);
+
+/**
+ * @brief Activate a validated task set
+ *
+ * All task IDs in set must be valid. Each task that
+ * reached its activation limit is reported to ErrorHook as
+ * a failed ActivateTask and skipped. No rescheduling is
+ * done here.
+ *
+ * @param[in] set
+ *   Task set to activate
+ *
+ * @retval E_OK
+ *   All tasks activated
+ * @retval E_OS_LIMIT
+ *   At least one task was not activated
+ */
+StatusType DoActivateTaskSet (TaskSetRefType set);
+
 /**
  * @brief Internal service implementation for TerminateTask
  *
@@ -651,6 +743,24 @@ StatusType Sys_SetEvent (TaskType tid, EventMaskType mask);
  */
 StatusType Sys_SetEvent_Preempt (TaskType tid, EventMaskType mask);
 
+#ifdef USE_SCHEDTBL
+/**
+ * @brief Set the events of a schedule table expiry point
+ *
+ * The list is generated by sdvgen, so task IDs and access
+ * are not checked again. Setting events of a suspended task
+ * is reported to ErrorHook as a failed SetEvent in extended
+ * status. No rescheduling is done here.
+ *
+ * @param[in] events
+ *   Event list, one entry per task
+ * @param[in] num
+ *   Number of entries
+ */
+void DoSetEventList (const ExpiryPointEventList * events,
+                     udata_word_t num);
+#endif
+
 /**
  * @brief Internal service implementation for ClearEvent
  *
@@ -902,6 +1012,39 @@ void Sys_ShutdownOS (StatusType error);
  */
 void ArchTimerInit (void);
 
+#ifdef TICKLESS
+/**
+ * @brief Program the system timer for a single long period
+ *
+ * ArchTimerOneShot stops the periodic system tick and
+ * programs the timer to expire once at the tick boundary
+ * "ticks" ticks from now. The interval is clamped to what
+ * the hardware timer can cover. Must be called with
+ * interrupts disabled.
+ *
+ * @param[in] ticks
+ *   Number of ticks to suppress. 0 means as long as the
+ *   hardware timer allows.
+ * @return
+ *   Number of ticks actually programmed. 0 if a tick is
+ *   already pending and the periodic tick was kept.
+ */
+TickType ArchTimerOneShot (TickType ticks);
+
+/**
+ * @brief Restart the periodic system tick
+ *
+ * ArchTimerResume cancels the period programmed by
+ * ArchTimerOneShot and restarts the periodic tick aligned
+ * to the original tick boundaries.
+ *
+ * @return
+ *   Number of tick boundaries passed since the call to
+ *   ArchTimerOneShot
+ */
+TickType ArchTimerResume (void);
+#endif
+
 /**
  * @brief Internal service implementation for IncrementCounter
  *
@@ -938,6 +1081,48 @@ StatusType Sys_IncrementCounter (CounterType CounterID);
  */
 StatusType Sys_IncrementCounter_Preempt (CounterType CounterID);
 
+/**
+ * @brief Internal service implementation for IncrementCounterBy
+ *
+ * Should only be called in kernel context. See syscall.c
+ * for actual service interface.
+ *
+ * @param[in] CounterID
+ *   Counter to be updated
+ * @param[in] Increments
+ *   Number of increments
+ *
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_ID
+ *   (Extended) CounterID not valid or counter is implemented
+ *   in hardware and can not be incremented by software
+ */
+StatusType Sys_IncrementCounterBy (CounterType CounterID,
+                                   TickType Increments);
+
+/**
+ * @brief
+ * Internal service implementation for IncrementCounterBy
+ * with preemption
+ *
+ * Should only be called in kernel context. See syscall.c
+ * for actual service interface.
+ *
+ * @param[in] CounterID
+ *   Counter to be updated
+ * @param[in] Increments
+ *   Number of increments
+ *
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_ID
+ *   (Extended) CounterID not valid or counter is implemented
+ *   in hardware and can not be incremented by software
+ */
+StatusType Sys_IncrementCounterBy_Preempt (CounterType CounterID,
+                                           TickType Increments);
+
 /**
  * @brief Internal service implementation for GetCounterValue
  *
@@ -990,6 +1175,179 @@ StatusType Sys_GetElapsedValue (CounterType CounterID,
  */
 void TickHandler (void);
 
+/**
+ * @brief Offer an event tick to a counter
+ *
+ * UpdateNextEvent makes "tick" the next event tick of a
+ * counter if it is earlier than the current one. It is
+ * called whenever an alarm or a schedule table is armed
+ * outside of the counter update, so that the next event
+ * tick is never later than the actual next event.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ * @param[in] tick
+ *   Event tick in counter time
+ */
+void UpdateNextEvent (Counter * counter, CounterTimeType tick);
+
+/**
+ * @brief Number of counter updates until an event is due
+ *
+ * CounterTicksTo returns how many more increments of a
+ * counter are needed before an alarm or schedule table
+ * event at "tick" is processed.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ * @param[in] tick
+ *   Event tick in counter time
+ * @return
+ *   Number of counter updates (at least 1, at most
+ *   maxallowedvalue)
+ */
+TickType CounterTicksTo (Counter * counter,
+                         CounterTimeType tick);
+
+#ifdef TASK_TIMERS
+/**
+ * @brief Internal service implementation for WaitEventTimeout
+ *
+ * Should only be called in kernel context. See syscall.c
+ * for actual service interface.
+ *
+ * @param[in] mask
+ *   Mask of the events waited for
+ * @param[in] CounterID
+ *   Counter the timeout is relative to
+ * @param[in] ticks
+ *   Timeout in ticks of the counter
+ *
+ * @retval E_OK
+ *   (Standard) At least one of the events is set
+ * @retval E_OS_SYS_TIMEOUT
+ *   (Standard) The timeout expired first
+ * @retval E_OS_ACCESS
+ *   (Extended) Calling task is not an extended task
+ * @retval E_OS_RESOURCE
+ *   (Extended) Calling task occupies resource
+ * @retval E_OS_CALLEVEL
+ *   (Extended) Call at interrupt level
+ * @retval E_OS_ID
+ *   (Extended) CounterID not valid
+ * @retval E_OS_VALUE
+ *   (Extended) ticks is 0 or greater than maxallowedvalue
+ */
+StatusType Sys_WaitEventTimeout (EventMaskType mask,
+                                 CounterType CounterID,
+                                 TickType ticks);
+
+/**
+ * @brief Internal service implementation for SleepTicks
+ *
+ * Should only be called in kernel context. See syscall.c
+ * for actual service interface.
+ *
+ * @param[in] CounterID
+ *   Counter the sleep is relative to
+ * @param[in] ticks
+ *   Sleep time in ticks of the counter
+ *
+ * @retval E_OK
+ *   (Standard) No error
+ * @retval E_OS_ACCESS
+ *   (Extended) Calling task is not an extended task
+ * @retval E_OS_RESOURCE
+ *   (Extended) Calling task occupies resource
+ * @retval E_OS_CALLEVEL
+ *   (Extended) Call at interrupt level
+ * @retval E_OS_ID
+ *   (Extended) CounterID not valid
+ * @retval E_OS_VALUE
+ *   (Extended) ticks is 0 or greater than maxallowedvalue
+ */
+StatusType Sys_SleepTicks (CounterType CounterID, TickType ticks);
+
+/**
+ * @brief Arm the timer of a task
+ *
+ * The timer of task tid expires ticks ticks of the counter
+ * from now and calls TaskTimeout. It is processed with the
+ * alarms of the counter.
+ *
+ * @param[in] tid
+ *   Task ID
+ * @param[in] CounterID
+ *   Counter to arm the timer on
+ * @param[in] ticks
+ *   Relative expiration in ticks
+ */
+void StartTaskTimer (TaskType tid, CounterType CounterID,
+                     TickType ticks);
+
+/**
+ * @brief Disarm the timer of a task
+ *
+ * Does nothing if the timer is not armed.
+ *
+ * @param[in] tid
+ *   Task ID
+ */
+void StopTaskTimer (TaskType tid);
+
+/**
+ * @brief Release a task whose timer expired
+ *
+ * Called when the timer of a task expires. A task still
+ * waiting is transferred to the ready state and its
+ * blocked service returns E_OS_SYS_TIMEOUT, or E_OK if it
+ * was not waiting for any event.
+ *
+ * @param[in] tid
+ *   Task ID
+ */
+void TaskTimeout (TaskType tid);
+#endif
+
+#ifdef TICKLESS
+/** TRUE while the periodic system tick is suppressed */
+extern volatile bool tickless_idle;
+
+/**
+ * @brief Suppress the system tick while idle
+ *
+ * TicklessIdle finds the earliest alarm or schedule table
+ * expiry on SYS_COUNTER and programs the system timer to
+ * fire only then. It is called by IdleLoop with interrupts
+ * disabled, right before the processor is put to sleep.
+ */
+void TicklessIdle (void);
+
+/**
+ * @brief Leave tickless idle
+ *
+ * TicklessResume restarts the periodic system tick and
+ * brings SYS_COUNTER up to date with the ticks suppressed
+ * while idle. It is called from TickHandler when the
+ * one-shot period expires and at the entry of any other
+ * ISR2 (TICKLESS_ISR_ENTER) waking the system up early.
+ */
+void TicklessResume (void);
+
+/**
+ * @def TICKLESS_ISR_ENTER
+ * @brief Leave tickless idle at the entry of an ISR2
+ *
+ * SYS_COUNTER is up to date before the ISR body runs. Not
+ * used by the system tick ISR, see TickHandler.
+ */
+#define TICKLESS_ISR_ENTER() do {                          \
+  if (tickless_idle) TicklessResume ();                    \
+} while (0)
+#else
+#define TICKLESS_ISR_ENTER()
+#endif
+
 /**
  * @brief Process running schedule tables of a counter
  *
@@ -1004,6 +1362,18 @@ void TickHandler (void);
  */
 void CheckScheduleTables (Counter * counter);
 
+/**
+ * @brief Offer schedule table events to a counter
+ *
+ * ScheduleTableNextEvent calls UpdateNextEvent with the
+ * next event tick of every running schedule table of a
+ * counter.
+ *
+ * @param[in] counter
+ *   Reference to a counter
+ */
+void ScheduleTableNextEvent (Counter * counter);
+
 /**
  * @brief
  * Internal service implementation for StartScheduleTableRel
@@ -42,9 +42,10 @@ void sdvos_init_printf (void (*putc) (char));
  * @brief Simple printf
  *
  * Simplified version of printf. Supported content types
- * are %u, %d, %x, %X, %c and %s. Only int is supported.
- * No support for long and long long yet. Field width is
- * supported but extra space will be padded with ' ' only.
+ * are %u, %d, %x, %X, %c and %s. The l modifier is supported
+ * for %lu, %lx and %lX. No support for long long yet. Field
+ * width is supported but extra space will be padded with ' '
+ * only.
  *
  * @param[in] fmt
  *   Printf format string
@@ -0,0 +1,105 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file   src/include/stackmon.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Stack High-watermark Monitor
+ *
+ * Stacks are only monitored when STACK_MONITOR is defined
+ * (STACKMONITOR = TRUE in OIL). StartOS paints every task
+ * stack, including the idle task, and the kernel stack
+ * with STACK_PAINT. The peak usage of a stack is the part
+ * of it no longer holding the pattern. All stacks grow
+ * downwards.
+ */
+#ifndef _STACKMON_H_
+#define _STACKMON_H_
+
+#include <osek/types.h>
+
+/** Pattern painted on unused stack */
+#define STACK_PAINT        0xA5
+
+/**
+ * Bytes below the current stack pointer left unpainted
+ * when StartOS runs on the stack being painted
+ */
+#define STACK_PAINT_GUARD  0x20
+
+/** Stack ID of the kernel stack, tasks use their TaskType */
+#define KERNEL_STACK_ID    ((TaskType) NUM_TASKS)
+
+#ifdef STACK_MONITOR
+
+/** This data type represents the usage of a stack */
+typedef struct stack_usage {
+  uint32_t size;               /**< Stack size in bytes */
+  uint32_t peak;               /**< Peak usage in bytes */
+} StackUsageType;
+
+/** Reference to StackUsageType */
+typedef StackUsageType * StackUsageRefType;
+
+/**
+ * @brief Get the peak usage of a stack
+ *
+ * The size of the kernel stack is 0 on architectures
+ * where the kernel runs on task stacks.
+ *
+ * @param[in] StackID
+ *   Task ID (the idle task is 0) or KERNEL_STACK_ID
+ * @param[out] Usage
+ *   Reference to the usage of the stack
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid StackID)
+ */
+StatusType GetStackUsage (TaskType StackID, StackUsageRefType Usage);
+
+/**
+ * @brief Internal service implementation for GetStackUsage
+ *
+ * @param[in] StackID
+ *   Task ID (the idle task is 0) or KERNEL_STACK_ID
+ * @param[out] Usage
+ *   Reference to the usage of the stack
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid StackID)
+ */
+StatusType Sys_GetStackUsage (TaskType StackID,
+                              StackUsageRefType Usage);
+
+/**
+ * @brief Paint all the stacks
+ *
+ * Internal use only. Called by StartOS after McuInit has
+ * set up the stacks and before any task runs.
+ */
+void StackMonInit (void);
+
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
@@ -0,0 +1,62 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/stats.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Kernel Statistics
+ *
+ * Kernel statistics are only collected when KERNEL_STATS
+ * is defined (STATS = TRUE in OIL).
+ */
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <osek/types.h>
+
+#ifdef KERNEL_STATS
+
+/** This data type represents kernel statistics */
+typedef struct kernel_stats_t {
+  uatomic_t counter_ticks;     /**< Counter updates */
+  uatomic_t fast_ticks;        /**< Counter updates with nothing due */
+  uatomic_t slice_expiries;    /**< Expired time slices */
+} KernelStatsType;
+
+/** Global kernel statistics */
+extern KernelStatsType kernel_stats;
+
+/**
+ * @def STATS_INC
+ * @brief Increment a kernel statistics counter
+ *
+ * @param[in] field
+ *   Field name in KernelStatsType
+ */
+#define STATS_INC(field)       (kernel_stats.field++)
+
+#else
+
+#define STATS_INC(field)
+
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
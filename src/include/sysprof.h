@@ -0,0 +1,171 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/sysprof.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  System Service Profiler
+ *
+ * System services are only profiled when SYSCALL_PROF is
+ * defined (SYSCALLPROF = TRUE in OIL). Calls are recorded
+ * at the arch system call entry points and keyed by the
+ * OSServiceId_* of the service. A call is timed from the
+ * entry until it returns to the caller or until the kernel
+ * dispatches another task, whichever comes first. Calls
+ * made while another call is being timed (e.g. from
+ * ErrorHook) are counted but not timed. Activations and
+ * events of alarms and schedule table expiry points are
+ * counted as calls of the service, so that activations
+ * dropped with E_OS_LIMIT show up. Times are in cycles of
+ * the cycle counter.
+ */
+#ifndef _SYSPROF_H_
+#define _SYSPROF_H_
+
+#include <osek/types.h>
+
+/** Service ID of services not profiled */
+#define INVALID_SERVICE    ((OSServiceIdType) ~(0UL))
+
+/** Number of service IDs, all OSServiceId_* are below */
+#define NUM_SERVICE_IDS    0x2B
+
+#ifdef SYSCALL_PROF
+
+/** This data type represents the profile of a service */
+typedef struct sys_prof {
+  uint64_t cycles;             /**< Total cycles of timed calls */
+  uint32_t calls;              /**< Number of calls */
+  uint32_t timed;              /**< Number of timed calls */
+  uint32_t max;                /**< Max cycles of a timed call */
+  uint32_t errors;             /**< Calls not returning E_OK */
+  StatusType last_error;       /**< Status of the last failed call */
+} SysProfType;
+
+/** Reference to SysProfType */
+typedef SysProfType * SysProfRefType;
+
+/**
+ * @brief Get the profile of a system service
+ *
+ * The profile is copied and optionally cleared in one step,
+ * so no call is lost between the two.
+ *
+ * @param[in] ServiceID
+ *   OSServiceId_* of the service
+ * @param[out] Prof
+ *   Reference to the copy of the profile
+ * @param[in] Reset
+ *   Clear the profile after copying it
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid ServiceID)
+ */
+StatusType GetSysProf (OSServiceIdType ServiceID, SysProfRefType Prof,
+                       bool Reset);
+
+/**
+ * @brief Internal service implementation for GetSysProf
+ *
+ * @param[in] ServiceID
+ *   OSServiceId_* of the service
+ * @param[out] Prof
+ *   Reference to the copy of the profile
+ * @param[in] Reset
+ *   Clear the profile after copying it
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid ServiceID)
+ */
+StatusType Sys_GetSysProf (OSServiceIdType ServiceID,
+                           SysProfRefType Prof, bool Reset);
+
+/**
+ * @brief Initialize service profiles
+ *
+ * Internal use only.
+ */
+void SysProfInit (void);
+
+/**
+ * @brief Record the entry of a system service
+ *
+ * Internal use only. Called with interrupts disabled.
+ *
+ * @param[in] id
+ *   OSServiceId_* of the service, or INVALID_SERVICE
+ *
+ * @return
+ *   TRUE if the call is timed
+ */
+bool SysProfEnter (OSServiceIdType id);
+
+/**
+ * @brief Record the return of a system service
+ *
+ * Internal use only. Called with interrupts disabled.
+ *
+ * @param[in] id
+ *   OSServiceId_* of the service, or INVALID_SERVICE
+ * @param[in] ret
+ *   Status returned by the service
+ * @param[in] timed
+ *   Return value of the matching SysProfEnter
+ */
+void SysProfExit (OSServiceIdType id, StatusType ret, bool timed);
+
+/**
+ * @brief Count a service performed by the kernel
+ *
+ * Internal use only. Used for alarm and expiry point
+ * actions, which are not timed.
+ *
+ * @param[in] id
+ *   OSServiceId_* of the service
+ * @param[in] ret
+ *   Status returned by the service
+ */
+void SysProfCount (OSServiceIdType id, StatusType ret);
+
+/**
+ * @brief Stop timing the current call on a task switch
+ *
+ * Internal use only. Called by Dispatch.
+ */
+void SysProfSwitch (void);
+
+#define SYSPROF_ENTER(id)       bool sysprof_timed = SysProfEnter (id)
+#define SYSPROF_EXIT(id, ret)   SysProfExit (id, ret, sysprof_timed)
+#define SYSPROF_COUNT(id, ret)  SysProfCount (id, ret)
+#define SYSPROF_SWITCH()        SysProfSwitch ()
+
+#else
+
+#define SYSPROF_ENTER(id)
+#define SYSPROF_EXIT(id, ret)
+#define SYSPROF_COUNT(id, ret)  ((void) (ret))
+#define SYSPROF_SWITCH()
+
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
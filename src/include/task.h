@@ -33,12 +33,39 @@
 #define TASK_EXTENDED       (0x1 << 2)
 /** Flag for privileged task */
 #define TASK_PRIVILEGED     (0x1 << 3)
+/** Flag for task context to be initialized at dispatch */
+#define TASK_INIT_CTX       (0x1 << 4)
+/** Flag for expired time slice */
+#define TASK_SLICE_EXP      (0x1 << 5)
 
 #ifndef __ASSEMBLER__
 
+#if defined EDF_SCHEDULER && !defined MULTI_TASK_PER_PRIO
+#error "EDF_SCHEDULER requires MULTI_TASK_PER_PRIO!"
+#endif
+
+#if defined EDF_SCHEDULER && defined SHARED_STACK
+#error "SHARED_STACK is not supported with EDF_SCHEDULER!"
+#endif
+
+#if defined EDF_SCHEDULER && defined MULTI_ACTIVATION
+#error "MULTI_ACTIVATION is not supported with EDF_SCHEDULER!"
+#endif
+
+#if defined TIME_SLICING && \
+    (!defined MULTI_TASK_PER_PRIO || defined EDF_SCHEDULER)
+#error "TIME_SLICING requires MULTI_TASK_PER_PRIO without EDF!"
+#endif
+
+#if defined TIME_SLICING && defined SHARED_STACK
+#error "SHARED_STACK is not supported with TIME_SLICING!"
+#endif
+
 #include <osek/types.h>
 /* Auto generated configuration header */
 #include <config/config.h>
+#include <taskstats.h>
+#include <latency.h>
 #include <assert.h>
 #include <cc.h>
 
@@ -70,6 +97,20 @@ typedef struct task_struct {
 #ifdef MULTI_TASK_PER_PRIO
   struct task_struct * next;   /**< Next Task */
 #endif
+#ifdef EDF_SCHEDULER
+  TickType deadline;           /**< Relative deadline */
+  TickType abs_deadline;       /**< Absolute deadline */
+  PrioType ceiling;            /**< System ceiling when preempted */
+#endif
+#ifdef TIME_SLICING
+  TickType slice;              /**< Ticks left in time slice */
+#endif
+#ifdef TASK_STATS
+  TaskStatsType stats;         /**< CPU time accounting */
+#endif
+#ifdef LATENCY_HIST
+  LatencyReleaseType latency;  /**< Pending release */
+#endif
 } ALIGNED(sizeof(udata_word_t)) TCB;
 
 /**
@@ -108,6 +149,18 @@ CASSERT (sizeof (TCB) ==
 #endif
 #ifdef MULTI_TASK_PER_PRIO
          sizeof (struct task_struct *) +
+#endif
+#ifdef EDF_SCHEDULER
+         sizeof (TickType) * 2 + sizeof (PrioType) +
+#endif
+#ifdef TIME_SLICING
+         sizeof (TickType) +
+#endif
+#ifdef TASK_STATS
+         sizeof (TaskStatsType) +
+#endif
+#ifdef LATENCY_HIST
+         sizeof (LatencyReleaseType) +
 #endif
          sizeof (task_context) +
          sizeof (udata_word_t) - 1) &
@@ -126,11 +179,22 @@ CASSERT (sizeof (TCB) ==
  *
  * In case multiple task per priority is not configured,
  * priority queue becomes an array of TCBs.
+ *
+ * The EDF scheduler does not use the priority queue. Its
+ * ready queue is a list ordered by deadline (see task.c).
+ *
+ * With TIME_SLICING, each priority has a time slice in
+ * system ticks. The running task of a priority with a
+ * non-zero slice is rotated to the tail of its queue when
+ * the slice expires.
  */
 #ifdef MULTI_TASK_PER_PRIO
 typedef struct prio_queue {
   TCB * head;
   TCB * tail;
+#ifdef TIME_SLICING
+  TickType slice;              /**< Time slice, 0 if not sliced */
+#endif
 } prio_queue_t;
 #else
 typedef TCB * prio_queue_t;
@@ -0,0 +1,153 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/taskstats.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Per-task CPU Time Accounting
+ *
+ * Per-task statistics are only collected when TASK_STATS
+ * is defined (TASKSTATS = TRUE in OIL). All times are in
+ * cycles of the architecture cycle counter, see
+ * GetTaskStatsFreq. Time spent in ISRs is charged to the
+ * task they interrupted.
+ */
+#ifndef _TASKSTATS_H_
+#define _TASKSTATS_H_
+
+#include <osek/types.h>
+
+#ifdef TASK_STATS
+
+/** This data type represents the statistics of a task */
+typedef struct task_stats {
+  uint64_t cpu_time;           /**< Total CPU time */
+  uint64_t exec_total;         /**< Sum of completed execution times */
+  uint64_t exec;               /**< CPU time of the current activation */
+  uint64_t release;            /**< Time of the current activation */
+  uint32_t activations;        /**< Number of activations */
+  uint32_t completions;        /**< Number of completed activations */
+  uint32_t exec_min;           /**< Min execution time per activation */
+  uint32_t exec_max;           /**< Max execution time per activation */
+  uint32_t wcrt;               /**< Worst activation to termination time */
+  uint32_t slice_expiries;     /**< Expired time slices */
+} TaskStatsType;
+
+/** Reference to TaskStatsType */
+typedef TaskStatsType * TaskStatsRefType;
+
+/**
+ * @brief Get the statistics of a task
+ *
+ * The CPU time of the calling task includes its current
+ * time slice. Average execution time is
+ * exec_total / completions. With multiple activations, the
+ * response time of a queued activation is measured from the
+ * termination of the previous one.
+ *
+ * @param[in] TaskID
+ *   Task ID (the idle task is 0)
+ * @param[out] Stats
+ *   Reference to the statistics of the task
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid TaskID)
+ */
+StatusType GetTaskStats (TaskType TaskID, TaskStatsRefType Stats);
+
+/**
+ * @brief Internal service implementation for GetTaskStats
+ *
+ * @param[in] TaskID
+ *   Task ID (the idle task is 0)
+ * @param[out] Stats
+ *   Reference to the statistics of the task
+ *
+ * @return
+ *   Standard: E_OK (No error)
+ *   Extended: E_OS_ID (Invalid TaskID)
+ */
+StatusType Sys_GetTaskStats (TaskType TaskID, TaskStatsRefType Stats);
+
+/**
+ * @brief Get the frequency of the statistics time base
+ *
+ * @return
+ *   Cycles per second
+ */
+uint32_t GetTaskStatsFreq (void);
+
+/**
+ * @brief Initialize per-task statistics
+ *
+ * Internal use only. Called after the cycle counter is
+ * started.
+ */
+void TaskStatsInit (void);
+
+/**
+ * @brief Account the activation of a task
+ *
+ * Internal use only. Called before the activation changes
+ * the task state.
+ *
+ * @param[in] tid
+ *   Task being activated
+ */
+void TaskStatsActivate (TaskType tid);
+
+/**
+ * @brief Account a task switch
+ *
+ * Internal use only. Charges the time since the last switch
+ * to the running task, and completes its activation if it
+ * terminated.
+ *
+ * @param[in] flag
+ *   DISPATCH_DISCARD if the running task terminated
+ */
+void TaskStatsSwitch (FlagType flag);
+
+/**
+ * @brief Account a system tick
+ *
+ * Internal use only. Called from TickHandler. Charges the
+ * time since the last switch to the running task, so that
+ * the 32-bit cycle counter never wraps around between two
+ * charges.
+ */
+void TaskStatsTick (void);
+
+/**
+ * @brief Max ticks the system tick may be suppressed
+ *
+ * Internal use only. With TICKLESS, TickHandler must still
+ * run within half of the cycle counter range.
+ *
+ * @return
+ *   Max number of system ticks between two TaskStatsTick
+ */
+TickType TaskStatsMaxTicks (void);
+
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
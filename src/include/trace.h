@@ -0,0 +1,159 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/include/trace.h
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Kernel Event Trace
+ *
+ * Kernel events are only recorded when KERNEL_TRACE is
+ * defined (TRACE = TRUE in OIL). Records are written into
+ * a fixed size ring buffer which can be decoded on the
+ * host with tools/sdvtrace. The layout of the buffer is
+ * part of the dump format and must be kept in sync with
+ * the decoder.
+ */
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <osek/types.h>
+
+/** Magic number at the beginning of a trace buffer ("SDVT") */
+#define TRACE_MAGIC            0x54564453UL
+/** Version of the trace buffer layout */
+#define TRACE_VERSION          1
+
+/*
+ * Event types. For each type, the meaning of the id, arg
+ * and data fields of a record is given below.
+ */
+/** Unused record */
+#define TRACE_NONE             0
+/** Task switch. id: new task, arg: dispatch flag, data: old task */
+#define TRACE_TASK_SWITCH      1
+/** ISR entry. arg: category, data: vector */
+#define TRACE_ISR_ENTER        2
+/** ISR exit. arg: category, data: vector */
+#define TRACE_ISR_EXIT         3
+/** Alarm expiry. id: alarm, data: counter value */
+#define TRACE_ALARM            4
+/** Schedule table expiry point. id: table, data: expiry point */
+#define TRACE_SCHEDTBL         5
+/** Resource acquired. id: resource, data: task */
+#define TRACE_RES_GET          6
+/** Resource released. id: resource, data: task */
+#define TRACE_RES_RELEASE      7
+
+/** Task id used when no task was running */
+#define TRACE_NO_TASK          0xFFFFFFFFUL
+
+#ifdef KERNEL_TRACE
+
+#include <config/config.h>
+
+#if (TRACE_BUF_SIZE & (TRACE_BUF_SIZE - 1)) != 0
+#error "TRACE_BUF_SIZE must be a power of 2!"
+#endif
+
+/** This data type represents a trace record (12 bytes) */
+typedef struct trace_record {
+  uint32_t timestamp;          /**< Cycle counter value */
+  uint32_t data;               /**< Event specific data */
+  uint16_t id;                 /**< Event specific object id */
+  uint8_t type;                /**< Event type */
+  uint8_t arg;                 /**< Event specific argument */
+} TraceRecordType;
+
+/** This data type represents the trace ring buffer */
+typedef struct trace_buffer {
+  uint32_t magic;              /**< TRACE_MAGIC */
+  uint16_t version;            /**< TRACE_VERSION */
+  uint16_t size;               /**< Number of records */
+  uint32_t freq;               /**< Cycle counter frequency in Hz */
+  volatile uint32_t head;      /**< Total records written */
+  TraceRecordType records[TRACE_BUF_SIZE];
+} TraceBufferType;
+
+/** Global kernel trace buffer */
+extern TraceBufferType kernel_trace;
+
+/**
+ * @brief Initialize kernel trace
+ *
+ * Record the frequency of the cycle counter in the trace
+ * buffer.
+ */
+void TraceInit (void);
+
+/**
+ * @brief Append a record to the trace buffer
+ *
+ * The slot is reserved atomically so that a record can
+ * be written from any context, including Category 1 ISRs.
+ * The type is written last, which marks the record valid.
+ *
+ * @param[in] type
+ *   Event type
+ * @param[in] arg
+ *   Event specific argument
+ * @param[in] id
+ *   Event specific object id
+ * @param[in] data
+ *   Event specific data
+ */
+static inline void
+TraceRecord (uint8_t type, uint8_t arg, uint16_t id, uint32_t data)
+{
+  TraceRecordType * rec = &kernel_trace.records[
+    uatomic_fetch_inc32 (&kernel_trace.head) & (TRACE_BUF_SIZE - 1)];
+
+  rec->timestamp = ArchCycleCount ();
+  rec->data = data;
+  rec->id = id;
+  rec->arg = arg;
+  __asm__ volatile ("" ::: "memory");
+  rec->type = type;
+}
+
+/**
+ * @def TRACE
+ * @brief Record a kernel event
+ *
+ * @param[in] type
+ *   Event type
+ * @param[in] arg
+ *   Event specific argument
+ * @param[in] id
+ *   Event specific object id
+ * @param[in] data
+ *   Event specific data
+ */
+#define TRACE(type, arg, id, data)                          \
+  TraceRecord ((type), (uint8_t) (arg), (uint16_t) (id),    \
+               (uint32_t) (data))
+
+#else
+
+#define TRACE(type, arg, id, data)
+
+#endif
+
+#endif
+
+/* vi: set et ai sw=2 sts=2: */
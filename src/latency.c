@@ -0,0 +1,145 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/latency.c
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Release to Dispatch Latency Histograms
+ */
+#include <osek/osek.h>
+#include <config/config.h>
+#include <sdvos.h>
+
+uint32_t latency_isr = 0;
+
+/** Histograms, indexed by type - 1 */
+static LatencyHistType latency_hist[NUM_LATENCY];
+/** Set while an alarm action is performed */
+static bool latency_in_alarm = FALSE;
+/** Expiry time of the alarm being fired */
+static uint32_t latency_alarm = 0;
+
+/**
+ * @brief Clear a histogram
+ *
+ * @param[in] hist
+ *   Histogram to be cleared
+ */
+static void
+LatencyClear (LatencyHistType * hist)
+{
+  int i = 0;
+
+  hist->count = 0;
+  hist->min = 0xFFFFFFFFUL;
+  hist->max = 0;
+  for (i = 0; i < LATENCY_BUCKETS; i++) {
+    hist->buckets[i] = 0;
+  }
+}
+
+void
+LatencyInit ()
+{
+  int i = 0;
+
+  for (i = 0; i < NUM_LATENCY; i++) {
+    LatencyClear (&latency_hist[i]);
+  }
+}
+
+void
+LatencyAlarm (bool on)
+{
+  latency_in_alarm = on;
+  /* The expiry of a hardware counter is its interrupt */
+  if (on) {
+    latency_alarm = NestedISRs ? latency_isr : ArchCycleCount ();
+  }
+}
+
+void
+LatencyRelease (TaskType tid, bool event)
+{
+  LatencyReleaseType * rel = &tasks[tid].latency;
+
+  if (rel->type != LATENCY_NONE) return;
+  /* Queued activations are not measured */
+  if (!event && (tasks[tid].state != SUSPENDED)) return;
+
+  if (latency_in_alarm) {
+    rel->type = LATENCY_ALARM;
+    rel->stamp = latency_alarm;
+  } else if (NestedISRs) {
+    rel->type = LATENCY_ISR;
+    rel->stamp = latency_isr;
+  } else if (event) {
+    rel->type = LATENCY_EVENT;
+    rel->stamp = ArchCycleCount ();
+  }
+}
+
+void
+LatencyDispatch (TaskType tid)
+{
+  LatencyReleaseType * rel = &tasks[tid].latency;
+  LatencyHistType * hist = NULL;
+  uint32_t lat = 0, v = 0;
+  uint8_t bucket = 0;
+
+  if (rel->type == LATENCY_NONE) return;
+
+  lat = ArchCycleCount () - rel->stamp;
+  hist = &latency_hist[rel->type - 1];
+  rel->type = LATENCY_NONE;
+
+  v = lat;
+  while (v >>= 1) bucket++;
+
+  hist->count++;
+  hist->buckets[bucket]++;
+  if (lat < hist->min) hist->min = lat;
+  if (lat > hist->max) hist->max = lat;
+}
+
+StatusType
+Sys_GetLatencyHist (LatencyType Type, LatencyHistRefType Hist,
+                    bool Reset)
+{
+  StatusType ret = E_OK;
+
+#ifdef OSEK_EXTENDED
+  if ((Type == LATENCY_NONE) || (Type > NUM_LATENCY)) {
+    ret = E_OS_ID;
+    goto std_ret;
+  }
+#endif
+
+  *Hist = latency_hist[Type - 1];
+  if (Reset) LatencyClear (&latency_hist[Type - 1]);
+
+#ifdef OSEK_EXTENDED
+std_ret:
+#endif
+  SaveOSErrorService (OSServiceId_GetLatencyHist, Type, Hist, Reset);
+  ERRORHOOK (ret);
+  return ret;
+}
+
+/* vi: set et ai sw=2 sts=2: */
@@ -52,8 +52,9 @@ TaskAutoStart (AppModeType mode)
 
   /* Activate all auto start tasks for this appmode */
   for (i = 0; i < NUM_TASKS; i++) {
+    /* Entries of tasks not started in this mode are invalid */
     if ((tid = auto_tasks[sdvos_appmode][i]) ==
-        INVALID_TASK) break;
+        INVALID_TASK) continue;
     Sys_ActivateTask (tid);
     DEBUG_PRINTFV ("Task %d auto started!\n", tid);
   }
@@ -100,6 +101,28 @@ StartOS (AppModeType mode)
    */
   BoardInit ();
 
+  /* Start the cycle counter, the board clock is set up */
+  ArchCycleInit ();
+
+#ifdef KERNEL_TRACE
+  TraceInit ();
+#endif
+#ifdef TASK_STATS
+  /* Start CPU time accounting before tasks are activated */
+  TaskStatsInit ();
+#endif
+#ifdef LATENCY_HIST
+  /* Clear latency histograms before tasks are activated */
+  LatencyInit ();
+#endif
+#ifdef SYSCALL_PROF
+  SysProfInit ();
+#endif
+#ifdef STACK_MONITOR
+  /* Paint stacks before any task runs on them */
+  StackMonInit ();
+#endif
+
   /* Initialize Interrupt Handling */
   InterruptInit ();
 
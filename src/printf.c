@@ -25,8 +25,8 @@
 #include <sdvos_printf.h>
 
 /* NUM_DIGITS - 1 is the max number of digits we can print */
-/* 12 is enough for 32-bit numbers */
-#define NUM_DIGITS  12
+/* 12 is enough for 32-bit numbers, 22 for 64-bit numbers */
+#define NUM_DIGITS  (sizeof (unsigned long) > 4 ? 22 : 12)
 
 #ifndef NULL
 #define NULL  ((void *) 0)
@@ -71,11 +71,11 @@ static const char udigitarray[] = "0123456789ABCDEF";
  *   Buffer for the result string
  */
 static void
-sdvos_uitoa (unsigned int value, unsigned int radix,
+sdvos_uitoa (unsigned long value, unsigned int radix,
              unsigned char upper, char * buf)
 {
   unsigned char ndigits = 1;
-  unsigned int tmp_value = value / radix;
+  unsigned long tmp_value = value / radix;
 
   while (tmp_value != 0) {
     tmp_value /= radix;
@@ -239,12 +239,15 @@ sdvos_vprintf (void (* putc_fun) (char **, char), char ** out_buf,
   char buf[NUM_DIGITS];
   char ch = 0;
   int width = 0;
+  unsigned char is_long = 0;
 
   while ((ch = *(fmt++))) {
     if (ch != '%') {
       putc_fun (out_buf, ch);
     } else {
       ch = *(fmt++);
+      width = 0;
+      is_long = 0;
 
       if (ch >= '0' && ch <= '9') {
         /* Only fldwidth is supported */
@@ -253,9 +256,15 @@ sdvos_vprintf (void (* putc_fun) (char **, char), char ** out_buf,
         ch = *(fmt++);
       }
 
+      if (ch == 'l') {
+        is_long = 1;
+        ch = *(fmt++);
+      }
+
       switch (ch) {
         case 'u' :
-          sdvos_uitoa (va_arg (va, unsigned int), 10, 0, buf);
+          sdvos_uitoa (is_long ? va_arg (va, unsigned long) :
+                       va_arg (va, unsigned int), 10, 0, buf);
           put_buf (putc_fun, out_buf, buf, width);
           break;
         case 'd' :
@@ -264,7 +273,8 @@ sdvos_vprintf (void (* putc_fun) (char **, char), char ** out_buf,
           break;
         case 'x' :
         case 'X' :
-          sdvos_uitoa (va_arg (va, unsigned int), 16,
+          sdvos_uitoa (is_long ? va_arg (va, unsigned long) :
+                       va_arg (va, unsigned int), 16,
                        ((ch == 'X') ? 1 : 0), buf);
           put_buf (putc_fun, out_buf, buf, width);
           break;
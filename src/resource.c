@@ -123,6 +123,7 @@ Sys_GetResource (ResourceType rid)
   PushResource (res);
   /* Change task's priority to resource ceiling priority */
   cur_task->priority = res->cprio;
+  TRACE (TRACE_RES_GET, 0, rid, cur_task->tid);
 
 #ifdef OSEK_EXTENDED
 std_ret:
@@ -182,6 +183,7 @@ Sys_ReleaseResource (ResourceType rid)
      */
     cur_task->priority = cur_task->orig_prio;
   }
+  TRACE (TRACE_RES_RELEASE, 0, rid, cur_task->tid);
 
 #ifdef OSEK_EXTENDED
 std_ret:
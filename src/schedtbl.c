@@ -46,31 +46,30 @@ extern ScheduleTableAutoStartType
  * @param[in] stid
  *   Schedule table ID
  * @param[in] tick
- *   Next event tick
+ *   Next event tick (counter count)
  */
 static void
 SetScheduleTableNextTick (ScheduleTableType stid, TickType tick)
 {
   Counter * counter = schedtbls[stid].counter;
+  TickType max = counter->properties.maxallowedvalue;
 
   if (tick <= counter->count) {
-    /* Next tick is an overflow of the current counter count */
-    ToggleScheduleTableOVF (stid);
+    /* Next tick is in the next counter cycle */
+    schedtbls[stid].next_tick = counter->ticks +
+                                (max - counter->count) + tick + 1;
   } else {
-    /* Next tick is not an overflow */
-    SetScheduleTableOVF (stid);
+    schedtbls[stid].next_tick = counter->ticks +
+                                (tick - counter->count);
   }
-
-  /* Set next event tick */
-  schedtbls[stid].next_tick = tick;
 }
 
 /**
  * @brief Increment schedule table next event tick
  *
  * IncScheduleTableNextTick increments schedule table next
- * event tick by inc. Overflow will be handled properly.
- * This function is similar to IncAlarm in alarm.c.
+ * event tick by inc. This function is similar to IncAlarm
+ * in alarm.c.
  *
  * @param[in] stid
  *   Schedule table ID
@@ -80,19 +79,8 @@ SetScheduleTableNextTick (ScheduleTableType stid, TickType tick)
 static void
 IncScheduleTableNextTick (ScheduleTableType stid, TickType inc)
 {
-  Counter * counter = schedtbls[stid].counter;
-  TickType max = counter->properties.maxallowedvalue;
-
-  if (inc) {
-    /* Update next event tick */
-    if ((max - inc) < schedtbls[stid].next_tick) {
-      schedtbls[stid].next_tick =
-        inc - (max - schedtbls[stid].next_tick) - 1;
-      ToggleScheduleTableOVF (stid);
-    } else {
-      schedtbls[stid].next_tick += inc;
-    }
-  }
+  /* Counter time wraps around at the TickType range */
+  schedtbls[stid].next_tick += inc;
 }
 
 #ifdef SCHEDTBL_SYNC
@@ -100,7 +88,7 @@ IncScheduleTableNextTick (ScheduleTableType stid, TickType inc)
  * @brief Decrement schedule table next event tick
  *
  * DecScheduleTableNextTick decrements schedule table next
- * event tick by dec. Overflow will be handled properly.
+ * event tick by dec.
  *
  * @param[in] stid
  *   Schedule table ID
@@ -110,19 +98,7 @@ IncScheduleTableNextTick (ScheduleTableType stid, TickType inc)
 static void
 DecScheduleTableNextTick (ScheduleTableType stid, TickType dec)
 {
-  Counter * counter = schedtbls[stid].counter;
-  TickType max = counter->properties.maxallowedvalue;
-
-  if (dec) {
-    /* Update next event tick */
-    if (schedtbls[stid].next_tick >= dec) {
-      schedtbls[stid].next_tick -= dec;
-    } else {
-      schedtbls[stid].next_tick =
-        max - (dec - schedtbls[stid].next_tick - 1);
-      ToggleScheduleTableOVF (stid);
-    }
-  }
+  schedtbls[stid].next_tick -= dec;
 }
 #endif
 
@@ -130,9 +106,8 @@ DecScheduleTableNextTick (ScheduleTableType stid, TickType dec)
  * @brief Update schedule table next event tick
  *
  * UpdateScheduleTableNextTick updates schedule table next
- * event tick according to current counter count and inc.
- * Overflow will be handled properly. This function is
- * similar to UpdateAlarm in alarm.c.
+ * event tick according to current counter time and inc.
+ * This function is similar to UpdateAlarm in alarm.c.
  *
  * @param[in] stid
  *   Schedule table ID
@@ -142,20 +117,7 @@ DecScheduleTableNextTick (ScheduleTableType stid, TickType dec)
 static void
 UpdateScheduleTableNextTick (ScheduleTableType stid, TickType inc)
 {
-  Counter * counter = schedtbls[stid].counter;
-  TickType max = counter->properties.maxallowedvalue;
-
-  SetScheduleTableOVF (stid);
-
-  if (inc) {
-    /* Update next event tick */
-    if ((max - inc) < counter->count) {
-      schedtbls[stid].next_tick = inc - (max - counter->count) - 1;
-      ToggleScheduleTableOVF (stid);
-    } else {
-      schedtbls[stid].next_tick = inc + counter->count;
-    }
-  }
+  schedtbls[stid].next_tick = schedtbls[stid].counter->ticks + inc;
 }
 
 /*
@@ -177,7 +139,7 @@ UpdateScheduleTableNextTick (ScheduleTableType stid, TickType inc)
   (tbl)->flag |= SCHEDULETABLE_PROCESSING;            \
   /* Set next_exp to the first expiry point */        \
   (tbl)->next_exp = 0;                                \
-  /* Update next_tick and OVF */                      \
+  /* Update next_tick */                              \
   if (next) {                                         \
     UpdateScheduleTableNextTick ((tbl)->id,           \
       (tbl)->exps[0].offset);                         \
@@ -327,9 +289,8 @@ RemoveScheduleTable (ScheduleTableStructType * sched_tbl)
       next_tbl->status = SCHEDULETABLE_RUNNING;
       next_tbl->flag |= SCHEDULETABLE_PROCESSING;
       next_tbl->next_exp = 0;
-      /* Set next_tick and OVF to current */
-      SetScheduleTableOVF (next_tbl->id);
-      next_tbl->next_tick = next_tbl->counter->count;
+      /* Set next_tick to current */
+      next_tbl->next_tick = next_tbl->counter->ticks;
     } else {
       StartTable (next_tbl, SCHEDULETABLE_RUNNING, TRUE);
     }
@@ -399,26 +360,18 @@ static void
 DoScheduleTableActions (ScheduleTableStructType * sched_tbl,
                         udata_word_t epid)
 {
-  int i = 0;
-  TaskType * tasks = NULL;
-  ExpiryPointEventList * events = NULL;
+  ExpiryPointType * exp = &sched_tbl->exps[epid];
+
+  TRACE (TRACE_SCHEDTBL, 0, sched_tbl - schedtbls, epid);
 
   /*
    * Task activations will be processed before setting
-   * events. [SWS_Os_00412]
+   * events. [SWS_Os_00412] Both lists were checked by
+   * sdvgen, so no service level validation is repeated
+   * here. Rescheduling is left to the caller.
    */
-  tasks = sched_tbl->exps[epid].tasks;
-  events = sched_tbl->exps[epid].events;
-
-  /* Process all task activations */
-  for (i = 0; i < sched_tbl->exps[epid].num_tasks; i++) {
-    Sys_ActivateTask (tasks[i]);
-  }
-
-  /* Set all events */
-  for (i = 0; i < sched_tbl->exps[epid].num_events; i++) {
-    Sys_SetEvent (events[i].tid, events[i].mask);
-  }
+  DoActivateTaskSet (&exp->tasks);
+  DoSetEventList (exp->events, exp->num_events);
 }
 
 /**
@@ -441,26 +394,10 @@ DoScheduleTableActions (ScheduleTableStructType * sched_tbl,
 static void
 ProcessScheduleTable (ScheduleTableStructType * sched_tbl)
 {
-  Counter * cur_counter = sched_tbl->counter;
-  TickType max = cur_counter->properties.maxallowedvalue;
-  TickType tpb = cur_counter->properties.ticksperbase;
-  TickType ntick = sched_tbl->next_tick;
   udata_word_t epid = INVALID_EP;
 
-  /* Have we arrived at next_tick? */
-  if (CounterOVF (cur_counter) ==
-      ScheduleTableOVF (sched_tbl->id)) {
-    if (cur_counter->count >= ntick) {
-      /* Next event arrived */
-      goto handle_next_event;
-    }
-  } else if (max - ntick + cur_counter->count + 1 < tpb) {
-      /* Next event arrived */
-      goto handle_next_event;
-  }
-
   /* Next event in the future, no processing needed */
-  return;
+  if (!TickDue (sched_tbl->counter, sched_tbl->next_tick)) return;
 
 handle_next_event:
   /*
@@ -481,7 +418,7 @@ handle_next_event:
 
     if ((epid + 1) < sched_tbl->num_exps) {
       /* We have a next expiry point */
-      /* Update next_tick and OVF bit */
+      /* Update next_tick */
       IncScheduleTableNextTick (sched_tbl->id,
                                 sched_tbl->exps[epid + 1].offset -
                                 sched_tbl->exps[epid].offset);
@@ -496,7 +433,7 @@ handle_next_event:
       if (sched_tbl->delay) {
         /* Final delay needed, set DELAYING flag */
         sched_tbl->flag |= SCHEDULETABLE_DELAYING;
-        /* Update next_tick and OVF */
+        /* Update next_tick */
         IncScheduleTableNextTick (sched_tbl->id, sched_tbl->delay);
         /* Clear next_exp */
         sched_tbl->next_exp = INVALID_EP;
@@ -548,8 +485,8 @@ handle_next_event:
 
         /*
          * Go back to event handling entry point. Next tick
-         * and OVF do not need to be updated since they
-         * should be "current". Endless loop would not
+         * does not need to be updated since it should be
+         * "current". Endless loop would not
          * happen here since a final delay must exist for
          * repeating schedule table.
          */
@@ -603,6 +540,23 @@ CheckScheduleTables (Counter * counter)
 #endif
 }
 
+void
+ScheduleTableNextEvent (Counter * counter)
+{
+  ScheduleTableStructType * sched_tbl = counter->schedtbl;
+
+#ifdef MULTI_SCHEDTBL_PER_CNTR
+  while (sched_tbl) {
+    UpdateNextEvent (counter, sched_tbl->next_tick);
+    sched_tbl = sched_tbl->next;
+  }
+#else
+  if (sched_tbl) {
+    UpdateNextEvent (counter, sched_tbl->next_tick);
+  }
+#endif
+}
+
 /*
  * Internal macro used to initialize part of the schedule
  * table flags and fields.
@@ -691,6 +645,9 @@ LinkTable (ScheduleTableStructType * sched_tbl,
 
   cur_counter->schedtbl = sched_tbl;
 #endif
+
+  /* Table might start before the counter next event */
+  UpdateNextEvent (cur_counter, sched_tbl->next_tick);
 }
 
 StatusType
@@ -1123,14 +1080,14 @@ Sys_SyncScheduleTable (ScheduleTableType ScheduleTableID,
       /* Schedule table is still in initial or final delay */
       /* Duration is max table offset + delay */
       pos_on_table = sched_tbl->duration -
-        (sched_tbl->next_tick - cur_counter->count);
+        (TickType) (sched_tbl->next_tick - cur_counter->ticks);
     } else {
       /* Schedule table is already up and running */
 #if defined DEBUG_SDVOS || defined DEBUG_SDVOS_VERBOSE
       ASSERT (sched_tbl->next_exp != INVALID_EP);
 #endif
       pos_on_table = sched_tbl->exps[sched_tbl->next_exp].offset -
-        (sched_tbl->next_tick - cur_counter->count);
+        (TickType) (sched_tbl->next_tick - cur_counter->ticks);
     }
 
     /*
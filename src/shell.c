@@ -95,8 +95,23 @@ typedef enum cmd_t {
   CMD_CLEAR = 0,
   CMD_EXIT,
   CMD_HELP,
+#ifdef LATENCY_HIST
+  CMD_LAT,
+#endif
+#ifdef SYSCALL_PROF
+  CMD_PROF,
+#endif
+#ifdef STACK_MONITOR
+  CMD_STACK,
+#endif
+#ifdef KERNEL_STATS
+  CMD_STATS,
+#endif
   CMD_TICK,
   CMD_TASK,
+#ifdef TASK_STATS
+  CMD_TOP,
+#endif
   CMD_UNAME,
 } CmdType;
 
@@ -105,14 +120,37 @@ static char * cmd_names[] = {
   "clear",
   "exit",
   "help",
+#ifdef LATENCY_HIST
+  "lat",
+#endif
+#ifdef SYSCALL_PROF
+  "prof",
+#endif
+#ifdef STACK_MONITOR
+  "stack",
+#endif
+#ifdef KERNEL_STATS
+  "stats",
+#endif
   "tick",
   "task",
+#ifdef TASK_STATS
+  "top",
+#endif
   "uname"
 };
 
 /** Command string array */
 static char command_string[MAX_CMD_LEN];
 
+#ifdef TASK_STATS
+/** System counter ticks between two top refreshes (1s) */
+#define TOP_TICKS      (1000000UL / TICKPERIOD_US)
+
+/** CPU time of each task at the last top refresh */
+static uint64_t top_cpu_time[NUM_TASKS];
+#endif
+
 /**
  * @brief Convert character to digit
  *
@@ -189,6 +227,252 @@ strncmp (const char * s1, const char * s2, unsigned int n)
   return 0;
 }
 
+#ifdef TASK_STATS
+/**
+ * @brief Convert cycles to microseconds
+ *
+ * @param[in] cycles
+ *   Number of cycles of the task statistics time base
+ *
+ * @return
+ *   Microseconds
+ */
+static unsigned long
+shell_cycles_to_us (uint64_t cycles)
+{
+  return (unsigned long) (CyclesToNs (cycles) / 1000);
+}
+
+/**
+ * @brief Print the task statistics table
+ *
+ * CPU usage is computed over the time since the previous
+ * refresh (since start up for the first one). The shell
+ * busy waits for input, so it takes most of the idle time.
+ */
+static void
+shell_top_refresh ()
+{
+  TaskStatsType stats;
+  uint64_t delta[NUM_TASKS], total = 0;
+  unsigned long avg = 0;
+  int i = 0;
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    GetTaskStats ((TaskType) i, &stats);
+    delta[i] = stats.cpu_time - top_cpu_time[i];
+    top_cpu_time[i] = stats.cpu_time;
+    total += delta[i];
+  }
+  if (!total) total = 1;
+
+  /* Task 0 is the idle task */
+  sdvos_printf ("CPU load: %3u%%\n",
+                (unsigned int) (100 - delta[0] * 100 / total));
+  sdvos_printf ("%4s%8s%5s%10s%10s%10s%10s%10s\n", "TID", "ACT",
+                "CPU%", "TIME(ms)", "MIN(us)", "AVG(us)",
+                "MAX(us)", "WCRT(us)");
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    GetTaskStats ((TaskType) i, &stats);
+    avg = stats.completions ?
+          shell_cycles_to_us (stats.exec_total / stats.completions) : 0;
+    sdvos_printf ("%4u%8lu%5u%10lu%10lu%10lu%10lu%10lu\n", i,
+                  (unsigned long) stats.activations,
+                  (unsigned int) (delta[i] * 100 / total),
+                  shell_cycles_to_us (stats.cpu_time) / 1000,
+                  shell_cycles_to_us (stats.exec_min), avg,
+                  shell_cycles_to_us (stats.exec_max),
+                  shell_cycles_to_us (stats.wcrt));
+  }
+}
+
+/**
+ * @brief Show task statistics periodically
+ *
+ * @param[in] count
+ *   Number of refreshes, one every second
+ */
+static void
+shell_top (int count)
+{
+  TickType value = 0, elapsed = 0;
+  unsigned long ticks = 0;
+
+  while (count-- > 0) {
+    if (ticks) {
+      CLEAR_SCREEN ();
+      MOVE_CURSOR_HOME ();
+    }
+    shell_top_refresh ();
+    if (!count) break;
+
+    GetCounterValue (SYS_COUNTER, &value);
+    for (ticks = 0; ticks < TOP_TICKS; ticks += elapsed) {
+      GetElapsedValue (SYS_COUNTER, &value, &elapsed);
+    }
+  }
+}
+#endif
+
+#ifdef LATENCY_HIST
+/** Names of the latency histograms */
+static char * lat_names[NUM_LATENCY] = {
+  "ISR -> task",
+  "Alarm -> task",
+  "SetEvent -> task"
+};
+
+/**
+ * @brief Convert cycle counter cycles to nanoseconds
+ *
+ * @param[in] cycles
+ *   Number of cycles
+ *
+ * @return
+ *   Nanoseconds
+ */
+static unsigned long
+shell_lat_ns (uint64_t cycles)
+{
+  return (unsigned long) CyclesToNs (cycles);
+}
+
+/**
+ * @brief Print the latency histograms
+ *
+ * Only the non-empty buckets are printed, each with the
+ * lower bound of its range.
+ *
+ * @param[in] reset
+ *   Clear the histograms after printing them
+ */
+static void
+shell_lat (bool reset)
+{
+  LatencyHistType hist;
+  LatencyType type = 0;
+  int i = 0;
+
+  for (type = LATENCY_ISR; type <= NUM_LATENCY; type++) {
+    GetLatencyHist (type, &hist, reset);
+    sdvos_printf ("%s: %lu samples", lat_names[type - 1],
+                  (unsigned long) hist.count);
+    if (!hist.count) {
+      sdvos_printf ("\n");
+      continue;
+    }
+    sdvos_printf (", min %lu ns, max %lu ns\n", shell_lat_ns (hist.min),
+                  shell_lat_ns (hist.max));
+    for (i = 0; i < LATENCY_BUCKETS; i++) {
+      if (!hist.buckets[i]) continue;
+      sdvos_printf ("  >= %10lu ns: %lu\n",
+                    i ? shell_lat_ns (1ULL << i) : 0UL,
+                    (unsigned long) hist.buckets[i]);
+    }
+  }
+}
+#endif
+
+#ifdef SYSCALL_PROF
+/** Names of the profiled services, indexed by service ID */
+static char * prof_names[NUM_SERVICE_IDS] = {
+  [OSServiceId_ActivateTask] = "ActivateTask",
+  [OSServiceId_TerminateTask] = "TerminateTask",
+  [OSServiceId_ChainTask] = "ChainTask",
+  [OSServiceId_Schedule] = "Schedule",
+  [OSServiceId_GetTaskID] = "GetTaskID",
+  [OSServiceId_GetTaskState] = "GetTaskState",
+  [OSServiceId_GetResource] = "GetResource",
+  [OSServiceId_ReleaseResource] = "ReleaseResource",
+  [OSServiceId_SetEvent] = "SetEvent",
+  [OSServiceId_ClearEvent] = "ClearEvent",
+  [OSServiceId_GetEvent] = "GetEvent",
+  [OSServiceId_WaitEvent] = "WaitEvent",
+  [OSServiceId_GetAlarmBase] = "GetAlarmBase",
+  [OSServiceId_GetAlarm] = "GetAlarm",
+  [OSServiceId_SetRelAlarm] = "SetRelAlarm",
+  [OSServiceId_SetAbsAlarm] = "SetAbsAlarm",
+  [OSServiceId_CancelAlarm] = "CancelAlarm",
+  [OSServiceId_GetActiveApplicationMode] = "GetActiveApplicationMode",
+  [OSServiceId_StartScheduleTableRel] = "StartScheduleTableRel",
+  [OSServiceId_StartScheduleTableAbs] = "StartScheduleTableAbs",
+  [OSServiceId_StopScheduleTable] = "StopScheduleTable",
+  [OSServiceId_NextScheduleTable] = "NextScheduleTable",
+  [OSServiceId_StartScheduleTableSynchron] = "StartScheduleTableSynchron",
+  [OSServiceId_SyncScheduleTable] = "SyncScheduleTable",
+  [OSServiceId_SetScheduleTableAsync] = "SetScheduleTableAsync",
+  [OSServiceId_GetScheduleTableStatus] = "GetScheduleTableStatus",
+  [OSServiceId_IncrementCounter] = "IncrementCounter",
+  [OSServiceId_GetCounterValue] = "GetCounterValue",
+  [OSServiceId_GetElapsedValue] = "GetElapsedValue",
+  [OSServiceId_IncrementCounterBy] = "IncrementCounterBy",
+  [OSServiceId_WaitEventTimeout] = "WaitEventTimeout",
+  [OSServiceId_SleepTicks] = "SleepTicks",
+  [OSServiceId_ActivateTaskSet] = "ActivateTaskSet"
+};
+
+/**
+ * @brief Print the system service profiles
+ *
+ * Only services called at least once are printed. LAST is
+ * the status of the last failed call.
+ *
+ * @param[in] reset
+ *   Clear the profiles after printing them
+ */
+static void
+shell_prof (bool reset)
+{
+  SysProfType prof;
+  OSServiceIdType id = 0;
+
+  sdvos_printf ("%8s%8s%5s%10s%10s  %s\n", "CALLS", "ERRORS", "LAST",
+                "AVG(ns)", "MAX(ns)", "SERVICE");
+  for (id = 0; id < NUM_SERVICE_IDS; id++) {
+    if (!prof_names[id]) continue;
+    GetSysProf (id, &prof, reset);
+    if (!prof.calls) continue;
+    sdvos_printf ("%8lu%8lu%5d%10lu%10lu  %s\n",
+                  (unsigned long) prof.calls,
+                  (unsigned long) prof.errors, (int) prof.last_error,
+                  prof.timed ?
+                  (unsigned long) CyclesToNs (prof.cycles / prof.timed) : 0UL,
+                  (unsigned long) CyclesToNs (prof.max), prof_names[id]);
+  }
+}
+#endif
+
+#ifdef STACK_MONITOR
+/**
+ * @brief Print the peak stack usage
+ *
+ * One line per task (the idle task is 0) and one for the
+ * kernel stack if it is separate. The output can be saved
+ * and fed to "sdvgen -w" for stack size recommendations.
+ */
+static void
+shell_stack (void)
+{
+  StackUsageType usage;
+  TaskType id = 0;
+
+  sdvos_printf ("%4s%10s%10s%10s\n", "TID", "SIZE", "PEAK", "FREE");
+  for (id = 0; id <= KERNEL_STACK_ID; id++) {
+    GetStackUsage (id, &usage);
+    if (id == KERNEL_STACK_ID) {
+      if (!usage.size) break;
+      sdvos_printf ("%4s", "KERN");
+    } else {
+      sdvos_printf ("%4lu", (unsigned long) id);
+    }
+    sdvos_printf ("%10lu%10lu%10lu\n", (unsigned long) usage.size,
+                  (unsigned long) usage.peak,
+                  (unsigned long) (usage.size - usage.peak));
+  }
+}
+#endif
+
 /**
  * @brief Simple getline function used by shell
  *
@@ -335,6 +619,31 @@ TASK (shell)
         }
         continue;
       }
+#ifdef LATENCY_HIST
+      case CMD_LAT :
+      {
+        shell_lat ((argc == 1) && (strncmp (argv[0], "reset", 6) == 0));
+        continue;
+      }
+#endif
+#ifdef SYSCALL_PROF
+      case CMD_PROF :
+      {
+        shell_prof ((argc == 1) && (strncmp (argv[0], "reset", 6) == 0));
+        continue;
+      }
+#endif
+#ifdef TASK_STATS
+      case CMD_TOP :
+      {
+        int count = 1;
+        if (argc == 1) {
+          shell_atoi (argv[0], 10, &count);
+        }
+        shell_top (count);
+        continue;
+      }
+#endif
       case CMD_TICK :
       {
         TickType v;
@@ -342,6 +651,27 @@ TASK (shell)
         sdvos_printf ("%d\n", v);
         continue;
       }
+#ifdef STACK_MONITOR
+      case CMD_STACK :
+      {
+        shell_stack ();
+        continue;
+      }
+#endif
+#ifdef KERNEL_STATS
+      case CMD_STATS :
+      {
+        sdvos_printf ("Counter updates: %u\n",
+                      kernel_stats.counter_ticks);
+        sdvos_printf ("  Nothing due:   %u\n",
+                      kernel_stats.fast_ticks);
+#ifdef TIME_SLICING
+        sdvos_printf ("Slice expiries:  %u\n",
+                      kernel_stats.slice_expiries);
+#endif
+        continue;
+      }
+#endif
       case CMD_UNAME :
       {
         sdvos_printf ("SDVOS %d.%d.%d " XSTR(BOARDNAME) "\n",
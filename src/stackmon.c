@@ -0,0 +1,124 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file   src/stackmon.c
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Stack High-watermark Monitor
+ */
+#include <osek/osek.h>
+#include <config/config.h>
+#include <sdvos.h>
+
+/**
+ * @brief Paint a stack
+ *
+ * If StartOS is running on the stack, the part above the
+ * current stack pointer (and a guard below it) is left
+ * alone. It is released when the first task is dispatched.
+ *
+ * @param[in] end
+ *   Lowest address of the stack
+ * @param[in] base
+ *   Address above the top of the stack
+ */
+static void
+StackPaint (data_addr_t end, data_addr_t base)
+{
+  uint8_t here = 0;
+  data_addr_t sp = (data_addr_t) &here;
+  uint8_t * p = NULL;
+
+  if ((sp >= end) && (sp < base)) {
+    if (sp - end <= STACK_PAINT_GUARD) return;
+    base = sp - STACK_PAINT_GUARD;
+  }
+
+  for (p = (uint8_t *) end; p < (uint8_t *) base; p++) {
+    *p = STACK_PAINT;
+  }
+}
+
+/**
+ * @brief Get the peak usage of a painted stack
+ *
+ * @param[in] end
+ *   Lowest address of the stack
+ * @param[in] base
+ *   Address above the top of the stack
+ *
+ * @return
+ *   Bytes from the top of the stack down to the lowest
+ *   byte not holding the pattern
+ */
+static uint32_t
+StackPeak (data_addr_t end, data_addr_t base)
+{
+  uint8_t * p = (uint8_t *) end;
+
+  while ((p < (uint8_t *) base) && (*p == STACK_PAINT)) p++;
+
+  return (uint32_t) (base - (data_addr_t) p);
+}
+
+void
+StackMonInit ()
+{
+  int i = 0;
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    StackPaint (tasks[i].sp_end, tasks[i].bp);
+  }
+  StackPaint (KERN_STACK_END, KERN_STACK);
+}
+
+StatusType
+Sys_GetStackUsage (TaskType StackID, StackUsageRefType Usage)
+{
+  StatusType ret = E_OK;
+  data_addr_t end = 0, base = 0;
+
+#ifdef OSEK_EXTENDED
+  if (StackID > KERNEL_STACK_ID) {
+    ret = E_OS_ID;
+    goto std_ret;
+  }
+#endif
+
+  if (StackID == KERNEL_STACK_ID) {
+    end = KERN_STACK_END;
+    base = KERN_STACK;
+  } else {
+    end = tasks[StackID].sp_end;
+    base = tasks[StackID].bp;
+  }
+
+  Usage->size = (uint32_t) (base - end);
+  Usage->peak = StackPeak (end, base);
+
+#ifdef OSEK_EXTENDED
+std_ret:
+#endif
+  SaveOSErrorService (OSServiceId_GetStackUsage, StackID, Usage, 0);
+  ERRORHOOK (ret);
+  return ret;
+}
+
+/* vi: set et ai sw=2 sts=2: */
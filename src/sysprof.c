@@ -0,0 +1,158 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file   src/sysprof.c
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  System Service Profiler
+ */
+#include <osek/osek.h>
+#include <config/config.h>
+#include <sdvos.h>
+
+/** Profiles, indexed by service ID */
+static SysProfType sysprof[NUM_SERVICE_IDS];
+/** Service of the call being timed, INVALID_SERVICE if none */
+static OSServiceIdType sysprof_service = INVALID_SERVICE;
+/** Entry time of the call being timed */
+static CycleType sysprof_stamp = 0;
+
+/**
+ * @brief Clear a profile
+ *
+ * @param[in] prof
+ *   Profile to be cleared
+ */
+static void
+SysProfClear (SysProfType * prof)
+{
+  prof->cycles = 0;
+  prof->calls = 0;
+  prof->timed = 0;
+  prof->max = 0;
+  prof->errors = 0;
+  prof->last_error = E_OK;
+}
+
+/**
+ * @brief Account the call being timed
+ *
+ * @param[in] now
+ *   End of the call
+ */
+static void
+SysProfStop (CycleType now)
+{
+  SysProfType * prof = &sysprof[sysprof_service];
+  uint32_t cycles = now - sysprof_stamp;
+
+  sysprof_service = INVALID_SERVICE;
+
+  prof->timed++;
+  prof->cycles += cycles;
+  if (cycles > prof->max) prof->max = cycles;
+}
+
+void
+SysProfInit ()
+{
+  int i = 0;
+
+  for (i = 0; i < NUM_SERVICE_IDS; i++) {
+    SysProfClear (&sysprof[i]);
+  }
+  sysprof_service = INVALID_SERVICE;
+}
+
+bool
+SysProfEnter (OSServiceIdType id)
+{
+  if (id >= NUM_SERVICE_IDS) return FALSE;
+
+  sysprof[id].calls++;
+  /* Nested call, e.g. from ErrorHook */
+  if (sysprof_service != INVALID_SERVICE) return FALSE;
+
+  sysprof_service = id;
+  sysprof_stamp = ArchCycleCount ();
+  return TRUE;
+}
+
+void
+SysProfExit (OSServiceIdType id, StatusType ret, bool timed)
+{
+  CycleType now = ArchCycleCount ();
+
+  if (id >= NUM_SERVICE_IDS) return;
+
+  /* Not timed any more if a task switch happened */
+  if (timed && (sysprof_service != INVALID_SERVICE)) {
+    SysProfStop (now);
+  }
+
+  if (ret != E_OK) {
+    sysprof[id].errors++;
+    sysprof[id].last_error = ret;
+  }
+}
+
+void
+SysProfCount (OSServiceIdType id, StatusType ret)
+{
+  sysprof[id].calls++;
+  if (ret != E_OK) {
+    sysprof[id].errors++;
+    sysprof[id].last_error = ret;
+  }
+}
+
+void
+SysProfSwitch ()
+{
+  if (sysprof_service != INVALID_SERVICE) {
+    SysProfStop (ArchCycleCount ());
+  }
+}
+
+StatusType
+Sys_GetSysProf (OSServiceIdType ServiceID, SysProfRefType Prof,
+                bool Reset)
+{
+  StatusType ret = E_OK;
+
+#ifdef OSEK_EXTENDED
+  if (ServiceID >= NUM_SERVICE_IDS) {
+    ret = E_OS_ID;
+    goto std_ret;
+  }
+#endif
+
+  *Prof = sysprof[ServiceID];
+  if (Reset) SysProfClear (&sysprof[ServiceID]);
+
+#ifdef OSEK_EXTENDED
+std_ret:
+#endif
+  SaveOSErrorService (OSServiceId_GetSysProf, ServiceID, Prof, Reset);
+  ERRORHOOK (ret);
+  return ret;
+}
+
+/* vi: set et ai sw=2 sts=2: */
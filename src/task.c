@@ -33,6 +33,136 @@ IdleTask (void)
   IdleLoop ();
 }
 
+#ifdef EDF_SCHEDULER
+/** Global queue for all counters in the system */
+extern Counter counters[NUM_COUNTERS];
+
+/*
+ * EDF ready queue. Ready tasks that have not been preempted
+ * are kept in edf_ready ordered by absolute deadline.
+ * Preempted tasks are pushed on edf_stack. Under the stack
+ * resource policy, preempted tasks resume in the reverse
+ * order of preemption.
+ */
+static TCB * edf_ready = NULL;
+static TCB * edf_stack = NULL;
+
+/*
+ * Absolute deadline rel ticks from now on SYS_COUNTER. With
+ * TICKLESS, the count may lag behind while the system tick
+ * is suppressed, which only makes the deadline earlier.
+ */
+static inline TickType
+EdfDeadline (TickType rel)
+{
+  Counter * counter = &counters[SYS_COUNTER];
+  TickType max = counter->properties.maxallowedvalue;
+
+  if (rel > (max - counter->count)) {
+    return rel - (max - counter->count) - 1;
+  }
+  return counter->count + rel;
+}
+
+/*
+ * TRUE if task a has an earlier deadline than task b.
+ * Deadlines are compared modulo the SYS_COUNTER range, so
+ * pending deadlines must be less than half of the range
+ * apart (checked by sdvgen). The idle task (priority 0)
+ * never has the earlier deadline.
+ */
+static inline bool
+EdfEarlier (TCB * a, TCB * b)
+{
+  TickType max = counters[SYS_COUNTER].properties.maxallowedvalue;
+  TickType diff = 0;
+
+  if (!b->orig_prio) return (a->orig_prio != 0);
+  if (!a->orig_prio) return FALSE;
+
+  if (b->abs_deadline >= a->abs_deadline) {
+    diff = b->abs_deadline - a->abs_deadline;
+  } else {
+    diff = (max - a->abs_deadline) + b->abs_deadline + 1;
+  }
+
+  return (diff && (diff <= (max >> 1)));
+}
+
+void
+EnqueueTaskTail (TaskType tid)
+{
+  TCB * task = &tasks[tid];
+  TCB ** link = &edf_ready;
+
+  /* Behind all tasks with an earlier or equal deadline */
+  while (*link && !EdfEarlier (task, *link)) {
+    link = &((*link)->next);
+  }
+  task->next = *link;
+  *link = task;
+}
+
+void
+EnqueueTaskHead (TaskType tid)
+{
+  TCB * task = &tasks[tid];
+  PrioType ceiling = edf_stack ? edf_stack->ceiling : 0;
+
+  /*
+   * Only called for a preempted task. The system ceiling
+   * while it is preempted includes the ceiling of the
+   * resources it holds (task priority).
+   */
+  if ((task->res || (task->ires != INVALID_PRIO)) &&
+      (task->priority > ceiling)) {
+    ceiling = task->priority;
+  }
+  task->ceiling = ceiling;
+  task->next = edf_stack;
+  edf_stack = task;
+}
+#else
+/* Number of priority groups in the ready bitmap */
+#define PRIO_GROUPS     ((MAX_PRIO >> PRIO_MAP_SHIFT) + 1)
+/* Priority index within a group */
+#define PRIO_MAP_MASK   ((1 << PRIO_MAP_SHIFT) - 1)
+
+#if PRIO_GROUPS > (1 << PRIO_MAP_SHIFT)
+#error "Too many priorities for a two-level ready bitmap!"
+#endif
+
+/*
+ * Two-level ready bitmap. Bit (p & PRIO_MAP_MASK) of
+ * prio_map[p >> PRIO_MAP_SHIFT] is set iff prio_queue[p] is
+ * not empty. Bit g of prio_group_map is set iff prio_map[g]
+ * is not zero.
+ */
+static PrioMapType prio_group_map = 0;
+static PrioMapType prio_map[PRIO_GROUPS];
+
+/* Mark priority queue prio as not empty */
+static inline void
+SetPrioReady (PrioType prio)
+{
+  prio_map[prio >> PRIO_MAP_SHIFT] |=
+    (PrioMapType) 1 << (prio & PRIO_MAP_MASK);
+  prio_group_map |= (PrioMapType) 1 << (prio >> PRIO_MAP_SHIFT);
+}
+
+/* Mark priority queue prio as empty */
+static inline void
+ClearPrioReady (PrioType prio)
+{
+  PrioMapType * map = &prio_map[prio >> PRIO_MAP_SHIFT];
+
+  *map &= ~((PrioMapType) 1 << (prio & PRIO_MAP_MASK));
+  if (!(*map)) {
+    prio_group_map &=
+      ~((PrioMapType) 1 << (prio >> PRIO_MAP_SHIFT));
+  }
+}
+
 void
 EnqueueTaskTail (TaskType tid)
 {
@@ -51,6 +181,12 @@ EnqueueTaskTail (TaskType tid)
   }
 #else
   *queue = &tasks[tid];
+#endif
+  SetPrioReady (tasks[tid].priority);
+#ifdef TIME_SLICING
+  /* A task joining the tail of its queue gets a new slice */
+  tasks[tid].slice = prio_queue[tasks[tid].orig_prio].slice;
+  tasks[tid].flag &= (~((FlagType) TASK_SLICE_EXP));
 #endif
 }
 
@@ -72,8 +208,11 @@ EnqueueTaskHead (TaskType tid)
 #else
   *queue = &tasks[tid];
 #endif
+  SetPrioReady (tasks[tid].priority);
 }
 
+#endif
+
 void
 MakeRunning (TCB * task)
 {
@@ -89,40 +228,104 @@ MakeRunning (TCB * task)
   }
 }
 
+#ifdef EDF_SCHEDULER
+/*
+ * Return the ready task with the earliest deadline whose
+ * preemption level (priority) is within [min, max] and
+ * remove it from the ready queue. With min above 0, the
+ * caller looks for a task to preempt the running task, so
+ * the deadline must also be earlier than cur_task's. With
+ * min 0, the running task gives up the processor. A ready
+ * task then has to be above the system ceiling and have an
+ * earlier deadline than the last preempted task, otherwise
+ * the latter resumes.
+ */
+void
+NextTask (TaskRefType tid_ref, PrioType max, PrioType min)
+{
+  TCB * ref = NULL;
+  TCB * task = NULL;
+  TCB ** link = &edf_ready;
+  bool resume = FALSE;
+  *tid_ref = INVALID_TASK;
+
+  if (max < min) return;
+
+  if (min) {
+    ref = cur_task;
+  } else if (edf_stack) {
+    ref = edf_stack;
+    min = ref->ceiling + 1;
+    resume = TRUE;
+  }
+
+  for (; (task = *link); link = &(task->next)) {
+    if (ref && !EdfEarlier (task, ref)) break;
+    if ((task->priority >= min) && (task->priority <= max)) {
+      *link = task->next;
+      *tid_ref = task->tid;
+      return;
+    }
+  }
+
+  if (resume) {
+    edf_stack = ref->next;
+    *tid_ref = ref->tid;
+  }
+}
+#else
 /*
  * Return the next highest priority ready task in the
- * priority queue and remove it from the queue.
+ * priority queue and remove it from the queue. The ready
+ * bitmap is used to locate the highest non-empty priority
+ * queue not above max, so the cost does not depend on the
+ * number of priority levels.
  */
 void
 NextTask (TaskRefType tid_ref, PrioType max, PrioType min)
 {
-  int i = 0;
+  PrioMapType map = 0;
+  udata_word_t grp = 0;
+  PrioType prio = 0;
   prio_queue_t * queue = NULL;
   *tid_ref = INVALID_TASK;
 
-  /* Find the next highest priority ready task */
-  for (i = max; i >= min; i--) {
-    queue = &prio_queue[i];
-    /* If task is found, remove it from the queue */
+  if (max < min) return;
+
+  /* Ready priorities not above max in the group of max */
+  grp = max >> PRIO_MAP_SHIFT;
+  map = prio_map[grp] & (PrioMapType)
+        (((PrioMapType) 2 << (max & PRIO_MAP_MASK)) - 1);
+
+  if (!map) {
+    /* Try the groups below */
+    map = prio_group_map &
+          (PrioMapType) (((PrioMapType) 1 << grp) - 1);
+    if (!map) return;
+    grp = HighestBit (map);
+    map = prio_map[grp];
+  }
+
+  prio = (PrioType) ((grp << PRIO_MAP_SHIFT) | HighestBit (map));
+  if (prio < min) return;
+
+  /* Remove the task from the queue */
+  queue = &prio_queue[prio];
 #ifdef MULTI_TASK_PER_PRIO
-    if (queue->head) {
-      *tid_ref = queue->head->tid;
-      queue->head = queue->head->next;
-      /* Is queue empty? */
-      if (!(queue->head)) {
-        queue->tail = NULL;
-      }
-      break;
-    }
+  *tid_ref = queue->head->tid;
+  queue->head = queue->head->next;
+  /* Is queue empty? */
+  if (!(queue->head)) {
+    queue->tail = NULL;
+    ClearPrioReady (prio);
+  }
 #else
-    if (*queue) {
-      *tid_ref = (*queue)->tid;
-      *queue = NULL;
-      break;
-    }
+  *tid_ref = (*queue)->tid;
+  *queue = NULL;
+  ClearPrioReady (prio);
 #endif
-  }
 }
+#endif
 
 /**
  * @brief Internal task activation.
@@ -135,6 +338,9 @@ NextTask (TaskRefType tid_ref, PrioType max, PrioType min)
 static inline void
 DoActivateTask (TaskType tid)
 {
+#ifdef TASK_STATS
+  TaskStatsActivate (tid);
+#endif
 #ifdef MULTI_ACTIVATION
   /* Increase activation count */
   tasks[tid].act++;
@@ -203,10 +409,68 @@ InitTask (TCB * task)
   /* Clear events */
   task->wevent = (EventMaskType) 0;
   task->cevent = (EventMaskType) 0;
+#ifdef EDF_SCHEDULER
+  /* Each activation starts a new deadline */
+  task->abs_deadline = EdfDeadline (task->deadline);
+#endif
+#ifdef SHARED_STACK
+  /*
+   * A basic task shares its stack with the other basic tasks
+   * of the same priority, one of which may still be running.
+   * Its context is initialized when it is dispatched. Only
+   * one task of a level can be started at a time (see the
+   * stack layout in sdvgen).
+   */
+  if (!(task->flag & TASK_EXTENDED)) {
+    task->flag |= TASK_INIT_CTX;
+    return;
+  }
+#endif
   /* Architectural dependent context initialization */
   InitContext (task);
 }
 
+#ifdef TIME_SLICING
+void
+TimeSliceTick ()
+{
+  if (!cur_task) return;
+
+  /* Priority without time slice (including idle task) */
+  if (!prio_queue[cur_task->orig_prio].slice) return;
+
+  if (cur_task->slice && (--(cur_task->slice))) return;
+
+  /* Rotation is left to CheckPreemption */
+  cur_task->flag |= TASK_SLICE_EXP;
+}
+
+/*
+ * Check whether the time slice of cur_task expired and it
+ * should give way to the next ready task of its priority.
+ * A task holding a resource (or an internal resource) runs
+ * above its priority and is only rotated once it is back
+ * at its original priority. The slice is restarted here,
+ * so the task continues with a new slice if no other task
+ * of its priority is ready.
+ */
+static inline bool
+TimeSliceExpired ()
+{
+  if (!(cur_task->flag & TASK_SLICE_EXP)) return FALSE;
+  if (cur_task->priority != cur_task->orig_prio) return FALSE;
+
+  cur_task->flag &= (~((FlagType) TASK_SLICE_EXP));
+  cur_task->slice = prio_queue[cur_task->orig_prio].slice;
+  STATS_INC (slice_expiries);
+#ifdef TASK_STATS
+  cur_task->stats.slice_expiries++;
+#endif
+
+  return TRUE;
+}
+#endif
+
 /*
  * CheckPreemption has to be called from ISR2 or scheduler
  * level. cur_task must be valid. If current task is
@@ -218,6 +482,9 @@ void
 CheckPreemption (FlagType flag)
 {
   TaskType tid = INVALID_TASK;
+#ifdef TIME_SLICING
+  bool rotate = FALSE;
+#endif
 
 #ifdef DEBUG_SDVOS
   if (!cur_task) panic ();
@@ -233,6 +500,14 @@ CheckPreemption (FlagType flag)
   /* Find ready task with higher priority than current task */
   NextTask (&tid, MAX_PRIO, cur_task->priority + 1);
 
+#ifdef TIME_SLICING
+  if ((tid == INVALID_TASK) && TimeSliceExpired ()) {
+    /* Round robin among tasks of the same priority */
+    NextTask (&tid, cur_task->priority, cur_task->priority);
+    rotate = TRUE;
+  }
+#endif
+
   /* If tid is valid, preempting task exists */
   if (tid != INVALID_TASK) {
     /*
@@ -241,6 +516,12 @@ CheckPreemption (FlagType flag)
      */
     POSTTASKHOOK ();
     cur_task->state = READY;
+#ifdef TIME_SLICING
+    if (rotate) {
+      /* Task with expired slice goes behind its peers */
+      EnqueueTaskTail (cur_task->tid);
+    } else
+#endif
     /* Put preempted task back to priority queue */
     /* A preempted task is considered to be the first task
      * in its priority queue. */
@@ -289,6 +570,14 @@ Dispatch (TaskType tid, FlagType flag)
     panic ();
   }
 
+  TRACE (TRACE_TASK_SWITCH, flag, tid,
+         cur_task ? cur_task->tid : TRACE_NO_TASK);
+#ifdef TASK_STATS
+  TaskStatsSwitch (flag);
+#endif
+  LATENCY_DISPATCH (tid);
+  SYSPROF_SWITCH ();
+
   switch (flag) {
     case DISPATCH_DISCARD :
       /* Handling task termination */
@@ -308,6 +597,12 @@ Dispatch (TaskType tid, FlagType flag)
    * after the transition of the task to the running state.
    */
   PRETASKHOOK ();
+#ifdef SHARED_STACK
+  if (cur_task->flag & TASK_INIT_CTX) {
+    cur_task->flag &= ~TASK_INIT_CTX;
+    InitContext (cur_task);
+  }
+#endif
   SwitchTask (src_task, &tasks[tid]);
 }
 
@@ -340,6 +635,7 @@ Sys_ActivateTask (TaskType tid)
   }
 #endif
 
+  LATENCY_RELEASE (tid, FALSE);
   DoActivateTask (tid);
 
 std_ret:
@@ -357,6 +653,73 @@ Sys_ActivateTask_Preempt (TaskType tid)
   return ret;
 }
 
+/**
+ * @def ActivationLimit(tid)
+ * @brief Check whether task tid can not take one more activation
+ */
+#ifdef MULTI_ACTIVATION
+#define ActivationLimit(tid)  (tasks[tid].act >= tasks[tid].max_act)
+#else
+#define ActivationLimit(tid)  (tasks[tid].state != SUSPENDED)
+#endif
+
+StatusType
+DoActivateTaskSet (TaskSetRefType set)
+{
+  StatusType ret = E_OK;
+  udata_word_t i = 0;
+  TaskType tid = INVALID_TASK;
+
+  for (i = 0; i < set->num_tasks; i++) {
+    tid = set->tasks[i];
+    if (ActivationLimit (tid)) {
+      DEBUG_PRINTFV ("Too many activations Task %d\n", tid);
+      ret = E_OS_LIMIT;
+      SaveOSErrorService (OSServiceId_ActivateTask, tid, 0, 0);
+      ERRORHOOK (ret);
+      continue;
+    }
+    LATENCY_RELEASE (tid, FALSE);
+    DoActivateTask (tid);
+  }
+
+  return ret;
+}
+
+StatusType
+Sys_ActivateTaskSet (TaskSetRefType TaskSet)
+{
+#ifdef OSEK_EXTENDED
+  StatusType ret = E_OK;
+  udata_word_t i = 0;
+
+  /* Validate the whole set before activating any task */
+  for (i = 0; i < TaskSet->num_tasks; i++) {
+    ValidateTaskID (TaskSet->tasks[i]);
+  }
+#endif
+
+  /* Failed activations are reported by DoActivateTaskSet */
+  return DoActivateTaskSet (TaskSet);
+
+#ifdef OSEK_EXTENDED
+std_ret:
+  SaveOSErrorService (OSServiceId_ActivateTaskSet, TaskSet, 0, 0);
+  ERRORHOOK (ret);
+  return ret;
+#endif
+}
+
+StatusType
+Sys_ActivateTaskSet_Preempt (TaskSetRefType TaskSet)
+{
+  StatusType ret = E_OK;
+  ret = Sys_ActivateTaskSet (TaskSet);
+  /* Tasks activated before a failed one may preempt too */
+  if (ret != E_OS_ID) CheckPreemption (PREEMPT_SCHED);
+  return ret;
+}
+
 StatusType
 Sys_TerminateTask (void)
 {
@@ -426,24 +789,30 @@ Sys_ChainTask (TaskType tid)
   ValidateTaskID (tid);
 #endif
 
-#ifdef MULTI_ACTIVATION
   /*
-   * If multiple activation is allowed, check whether the
-   * max activation count is reached.
+   * Chaining the current task does not result in another
+   * activation request, so the limit does not apply.
    */
-  if (tasks[tid].act >= tasks[tid].max_act) {
-    DEBUG_PRINTFV ("Too many activations Task %d\n", tid);
-    ret = E_OS_LIMIT;
-    goto std_ret;
-  }
+  if (tid != cur_task->tid) {
+#ifdef MULTI_ACTIVATION
+    /*
+     * If multiple activation is allowed, check whether the
+     * max activation count is reached.
+     */
+    if (tasks[tid].act >= tasks[tid].max_act) {
+      DEBUG_PRINTFV ("Too many activations Task %d\n", tid);
+      ret = E_OS_LIMIT;
+      goto std_ret;
+    }
 #else
-  /* Otherwise, check whether target task is suspended */
-  if (tasks[tid].state != SUSPENDED) {
-    DEBUG_PRINTFV ("Task not suspended\n");
-    ret = E_OS_LIMIT;
-    goto std_ret;
-  }
+    /* Otherwise, check whether target task is suspended */
+    if (tasks[tid].state != SUSPENDED) {
+      DEBUG_PRINTFV ("Task not suspended\n");
+      ret = E_OS_LIMIT;
+      goto std_ret;
+    }
 #endif
+  }
 
   if (tid == cur_task->tid) {
     /*
@@ -526,8 +895,14 @@ Sys_Schedule (void)
     cur_task->state = READY;
     /* Release internal resource */
     cur_task->priority = cur_task->orig_prio;
-    /* Put calling task back to priority queue */
-    EnqueueTaskTail (cur_task->tid);
+    /*
+     * Put calling task back to priority queue. As a
+     * preempted task, it is considered to be the first task
+     * in its priority queue. It must also resume before any
+     * peer task that has not started yet, which would
+     * otherwise reuse its frames on a shared stack.
+     */
+    EnqueueTaskHead (cur_task->tid);
     Dispatch (tid, DISPATCH_BLOCK);
   }
 
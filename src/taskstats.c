@@ -0,0 +1,168 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/taskstats.c
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Per-task CPU Time Accounting
+ */
+#include <osek/osek.h>
+#include <config/config.h>
+#include <sdvos.h>
+
+/** Cycle count at the last charge */
+static uint32_t last_switch = 0;
+/** Cycles since TaskStatsInit, extending the cycle counter */
+static uint64_t stats_clock = 0;
+/** Frequency of the cycle counter */
+static uint32_t stats_freq = 0;
+/** Ticks within half of the cycle counter range */
+static TickType stats_max_ticks = 0;
+
+void
+TaskStatsInit ()
+{
+  uint64_t ticks = 0;
+
+  stats_freq = ArchCycleFreq ();
+  last_switch = ArchCycleCount ();
+
+  /* OSTICKDURATION is in ns */
+  ticks = ((((uint64_t) 1) << 31) * 1000000000ULL / stats_freq) /
+          OSTICKDURATION;
+  if (ticks > (TickType) (~((TickType) 0))) {
+    ticks = (TickType) (~((TickType) 0));
+  }
+  stats_max_ticks = (ticks > 2) ? (TickType) ticks : 2;
+}
+
+/*
+ * Charge the time since the last charge to the running task
+ * and return the extended cycle count. Only correct if
+ * called within 2^32 cycles, see TaskStatsTick.
+ */
+static uint64_t
+TaskStatsCharge (void)
+{
+  uint32_t now = ArchCycleCount ();
+  uint32_t delta = now - last_switch;
+
+  last_switch = now;
+  stats_clock += delta;
+
+  /* No task before the first dispatch */
+  if (cur_task) {
+    cur_task->stats.cpu_time += delta;
+    cur_task->stats.exec += delta;
+  }
+
+  return stats_clock;
+}
+
+void
+TaskStatsActivate (TaskType tid)
+{
+  TaskStatsType * stats = &tasks[tid].stats;
+
+  stats->activations++;
+  /* Queued activations are released at termination */
+  if (tasks[tid].state == SUSPENDED) {
+    stats->release = TaskStatsCharge ();
+  }
+}
+
+void
+TaskStatsSwitch (FlagType flag)
+{
+  uint64_t now = TaskStatsCharge (), rt = 0;
+  uint32_t exec = 0;
+  TaskStatsType * stats = NULL;
+
+  if (!cur_task || (flag != DISPATCH_DISCARD)) return;
+
+  /* Current activation terminated */
+  stats = &cur_task->stats;
+  stats->exec_total += stats->exec;
+  /* Min, max and wcrt saturate at 32 bits */
+  exec = (stats->exec > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL :
+         (uint32_t) stats->exec;
+  if (!stats->completions || exec < stats->exec_min) {
+    stats->exec_min = exec;
+  }
+  if (exec > stats->exec_max) stats->exec_max = exec;
+  stats->completions++;
+  stats->exec = 0;
+
+  rt = now - stats->release;
+  if (rt > 0xFFFFFFFFULL) rt = 0xFFFFFFFFULL;
+  if (rt > stats->wcrt) stats->wcrt = (uint32_t) rt;
+
+  /* Pending activation (or ChainTask self) starts now */
+  if (cur_task->state == READY) stats->release = now;
+}
+
+void
+TaskStatsTick ()
+{
+  TaskStatsCharge ();
+}
+
+TickType
+TaskStatsMaxTicks ()
+{
+  return stats_max_ticks;
+}
+
+StatusType
+Sys_GetTaskStats (TaskType TaskID, TaskStatsRefType Stats)
+{
+  StatusType ret = E_OK;
+  uint32_t delta = 0;
+
+#ifdef OSEK_EXTENDED
+  if (TaskID >= NUM_TASKS) {
+    ret = E_OS_ID;
+    goto std_ret;
+  }
+#endif
+
+  *Stats = tasks[TaskID].stats;
+
+  /* Add the current time slice of the running task */
+  if (&tasks[TaskID] == cur_task) {
+    delta = ArchCycleCount () - last_switch;
+    Stats->cpu_time += delta;
+    Stats->exec += delta;
+  }
+
+#ifdef OSEK_EXTENDED
+std_ret:
+#endif
+  SaveOSErrorService (OSServiceId_GetTaskStats, TaskID, Stats, 0);
+  ERRORHOOK (ret);
+  return ret;
+}
+
+uint32_t
+GetTaskStatsFreq ()
+{
+  return stats_freq;
+}
+
+/* vi: set et ai sw=2 sts=2: */
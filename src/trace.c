@@ -0,0 +1,44 @@
+/*
+ *         Standard Dependable Vehicle Operating System
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   src/trace.c
+ * @author Ye Li (liye@sdvos.org)
+ * @brief  Kernel Event Trace
+ */
+#include <config/config.h>
+#include <sdvos.h>
+
+/*
+ * The header is filled statically so that a memory dump
+ * can be recognized even if TraceInit was never reached.
+ */
+TraceBufferType kernel_trace = {
+  .magic = TRACE_MAGIC,
+  .version = TRACE_VERSION,
+  .size = TRACE_BUF_SIZE,
+};
+
+void
+TraceInit ()
+{
+  kernel_trace.freq = ArchCycleFreq ();
+}
+
+/* vi: set et ai sw=2 sts=2: */
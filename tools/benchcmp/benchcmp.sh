@@ -0,0 +1,93 @@
+#!/bin/sh
+#
+#         Standard Dependable Vehicle Operating System
+#
+# Copyright (C) 2015 Ye Li (liye@sdvos.org)
+#
+# This program is free software: you can redistribute it and/or
+# modify it under the terms of the GNU General Public License as
+# published by the Free Software Foundation, either version 3 of
+# the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Compare two outputs of apps/bench. Exits with 1 if any
+# benchmark got slower than the threshold, 2 on usage errors.
+
+usage ()
+{
+  echo "Usage: $0 [-t percent] [-f min|avg|max] old.csv new.csv" >&2
+  exit 2
+}
+
+THRESHOLD=10
+FIELD=avg
+
+while getopts "t:f:h" opt; do
+  case $opt in
+    t) THRESHOLD=$OPTARG ;;
+    f) FIELD=$OPTARG ;;
+    *) usage ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+[ $# -eq 2 ] || usage
+[ -r "$1" ] && [ -r "$2" ] || usage
+
+case $FIELD in
+  min) COL=3 ;;
+  avg) COL=4 ;;
+  max) COL=5 ;;
+  *) usage ;;
+esac
+
+# Only result rows are compared, anything else in the
+# captured output (headers, debug messages) is skipped.
+awk -F, -v col=$COL -v th=$THRESHOLD -v field=$FIELD '
+  function row() {
+    return NF == 5 && $1 ~ /^[a-z_0-9]+$/ && $2 ~ /^[0-9]+$/
+  }
+  FNR == 1 { file++ }
+  file == 1 && row() { old[$1] = $col; next }
+  file == 2 && row() {
+    names[n++] = $1
+    new[$1] = $col
+  }
+  END {
+    printf "%-24s %12s %12s %9s\n", "name", "old_" field "_ns",
+           "new_" field "_ns", "delta"
+    for (i = 0; i < n; i++) {
+      name = names[i]
+      if (!(name in old)) {
+        printf "%-24s %12s %12d %9s  NEW\n", name, "-", new[name], "-"
+        continue
+      }
+      status = ""
+      if (old[name] > 0) {
+        delta = (new[name] - old[name]) * 100.0 / old[name]
+        if (delta > th) { status = "  REGRESSION"; bad++ }
+        else if (delta < -th) status = "  IMPROVED"
+        dstr = sprintf ("%+.1f%%", delta)
+      } else {
+        dstr = "-"
+      }
+      printf "%-24s %12d %12d %9s%s\n", name, old[name], new[name],
+             dstr, status
+      delete old[name]
+    }
+    for (name in old) {
+      printf "%-24s %12d %12s %9s  MISSING\n", name, old[name], "-", "-"
+    }
+    if (bad) {
+      printf "%d regression(s) above %s%%\n", bad, th
+      exit 1
+    }
+  }
+' "$1" "$2"
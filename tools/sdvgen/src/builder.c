@@ -54,9 +54,22 @@ uint32_t max_irq = 0;
 uint64_t masks = 0;
 bool rflag = FALSE, tflag = FALSE, dflag = FALSE;
 bool bflag = FALSE, mflag = FALSE;
+/* Stack watermark report and safety margin in percent */
+char * stack_report = NULL;
+int stack_margin = 25;
 bool mult_task_per_prio = FALSE, mult_activation = FALSE;
 bool with_sched_tbl_sync = FALSE, with_sched_tbl = FALSE;
 bool mult_schedtbl_per_cntr = FALSE;
+bool with_timing_wheel = FALSE;
+/* Counter time needs more than the TickType range */
+bool wide_counter_time = FALSE;
+/* Time slice of each priority, NULL without time slicing */
+uint32_t * prio_slices = NULL;
+/* Alarms compiled into the cyclic executive dispatch tables */
+oil_object_list_t * cyclic_alarms = NULL;
+/* Hyperperiod and number of table slots of each appmode */
+uint32_t * cyclic_periods = NULL;
+uint32_t * cyclic_slots = NULL;
 char * include_path = NULL;
 char * include_path_list[MAX_INCLUDE_PATH];
 char * sdvos_root = NULL;
@@ -389,6 +402,68 @@ object_add_param (generic_oil_object_t * object,
           if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
           os->shell = value->v.b;
           break;
+        case ATTR_TICKLESS :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->tickless = value->v.b;
+          break;
+        case ATTR_STATS :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->stats = value->v.b;
+          break;
+        case ATTR_TASKSTATS :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->task_stats = value->v.b;
+          break;
+        case ATTR_LATENCYHIST :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->latency_hist = value->v.b;
+          break;
+        case ATTR_SYSCALLPROF :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->syscall_prof = value->v.b;
+          break;
+        case ATTR_STACKMONITOR :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->stack_monitor = value->v.b;
+          break;
+        case ATTR_SHAREDSTACK :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->shared_stack = value->v.b;
+          break;
+        case ATTR_TASKTIMERS :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->task_timers = value->v.b;
+          break;
+        case ATTR_EDFSCHEDULER :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->edf_scheduler = value->v.b;
+          break;
+        case ATTR_CYCLICEXECUTIVE :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->cyclic_executive = value->v.b;
+          break;
+        case ATTR_TICKPERIOD_US :
+          if (value->value_type != VALUE_TYPE_INT) goto os_err;
+          if (!CHK_RANGE2 (value->v.s8b, 1, MAX_TICKPERIOD_US)) {
+            sderror ("OS TICKPERIOD_US out of range!", value->lineno);
+            return ERR_ATTRIBUTE;
+          }
+          os->tick_period_us = value->v.s4b;
+          break;
+        case ATTR_TRACE :
+          if (value->value_type != VALUE_TYPE_BOOL) goto os_err;
+          os->trace = value->v.b;
+          break;
+        case ATTR_TRACEBUFSIZE :
+          if (value->value_type != VALUE_TYPE_INT) goto os_err;
+          if (!CHK_RANGE2 (value->v.s8b, 1, MAX_TRACEBUFSIZE) ||
+              (value->v.s4b & (value->v.s4b - 1))) {
+            sderror ("OS TRACEBUFSIZE has to be a power of 2 "
+                     "no larger than 32768!", value->lineno);
+            return ERR_ATTRIBUTE;
+          }
+          os->trace_buf_size = value->v.s4b;
+          break;
         default :
           sderror ("Unknown attribute in OS object!", value->lineno);
           return ERR_ATTRIBUTE;
@@ -433,6 +508,22 @@ os_err:
           }
           task->stacksize = value->v.s4b;
           break;
+        case ATTR_DEADLINE :
+          if (value->value_type != VALUE_TYPE_INT) goto task_err;
+          if (!CHK_RANGE2 (value->v.s8b, 1, MAX_DEADLINE)) {
+            sderror ("Task deadline out of range!", value->lineno);
+            return ERR_ATTRIBUTE;
+          }
+          task->deadline = value->v.s4b;
+          break;
+        case ATTR_TIMESLICE :
+          if (value->value_type != VALUE_TYPE_INT) goto task_err;
+          if (!CHK_RANGE2 (value->v.s8b, 1, MAX_TIMESLICE)) {
+            sderror ("Task time slice out of range!", value->lineno);
+            return ERR_ATTRIBUTE;
+          }
+          task->timeslice = value->v.s4b;
+          break;
         case ATTR_SCHEDULE :
           if (value->value_type != VALUE_TYPE_OS_SCHEDULE) goto task_err;
           (value->v.s4b == NON) ?
@@ -548,6 +639,10 @@ event_err:
           }
           counter->ticks_per_base = value->v.s4b;
           break;
+        case ATTR_TIMINGWHEEL :
+          if (value->value_type != VALUE_TYPE_BOOL) goto counter_err;
+          counter->timing_wheel = value->v.b;
+          break;
         default :
           sderror ("Unknown attribute in Counter object!",
                    value->lineno);
@@ -1121,6 +1216,326 @@ cmpfunc3 (const void * a, const void * b)
   return epa->offset - epb->offset;
 }
 
+/* System tick timer of a board */
+typedef struct tick_timer {
+  const char * board;
+  /* Timer input clock in Hz */
+  uint64_t clock;
+  /* Largest number of timer cycles in one tick */
+  uint64_t max_cycles;
+  /* Available prescalers in ascending order, 0 terminated */
+  uint32_t prescale[6];
+} tick_timer_t;
+
+/*
+ * Must match src/arch/<arch>/timer.c and the clocks set up
+ * in src/board/<board>/board.c. SysTick runs at HCLK / 8 on
+ * ARMv7-M boards, AVR boards use Timer 1 in CTC mode and
+ * Linux timers have nanosecond resolution.
+ */
+static const tick_timer_t tick_timers[] = {
+  {"ARDUINO_UNO", 16000000, 0x10000, {1, 8, 64, 256, 1024, 0}},
+  {"ARDUINO_MEGA", 16000000, 0x10000, {1, 8, 64, 256, 1024, 0}},
+  {"ATMEGA328P", 1000000, 0x10000, {1, 8, 64, 256, 1024, 0}},
+  {"STM32VLDISCOVERY", 24000000 >> 3, 0x1000000, {1, 0}},
+  {"STM32F4DISCOVERY", 168000000 >> 3, 0x1000000, {1, 0}},
+  {"NUCLEOF401RE", 84000000 >> 3, 0x1000000, {1, 0}},
+  {"NUCLEOF411RE", 100000000 >> 3, 0x1000000, {1, 0}},
+  {"NUCLEOF746ZG", 216000000 >> 3, 0x1000000, {1, 0}},
+  {"LINUX", 1000000000, 0xFFFFFFFF, {1, 0}},
+  {NULL, 0, 0, {0}}
+};
+
+/*
+ * Find the tick period closest to TICKPERIOD_US that the
+ * system timer of the board can generate, and report the
+ * rounding error. The smallest prescaler that fits gives
+ * the best resolution.
+ */
+static void
+update_tick_period (oil_os_object_t * os)
+{
+  const tick_timer_t * timer = NULL;
+  uint64_t cycles = 0, prescale = 0;
+  int64_t error = 0;
+  int i = 0;
+
+  for (timer = tick_timers; timer->board; timer++) {
+    if (strncmp (os->board, timer->board,
+                 strlen (timer->board)) == 0) break;
+  }
+
+  if (!timer->board) {
+    if (os->tick_period_us != 1000) {
+      fprintf (stderr, "TICKPERIOD_US not supported on %s!\n",
+               os->board);
+      exit (1);
+    }
+    os->tick_duration_ns = 1000000;
+    return;
+  }
+
+  for (i = 0; timer->prescale[i]; i++) {
+    prescale = timer->prescale[i];
+    /* Round to the nearest timer cycle */
+    cycles = (timer->clock * os->tick_period_us +
+              prescale * 500000) / (prescale * 1000000);
+    if (cycles <= timer->max_cycles) break;
+  }
+
+  if (!cycles) {
+    fprintf (stderr, "TICKPERIOD_US %u too short for %s!\n",
+             os->tick_period_us, os->board);
+    exit (1);
+  }
+  if (cycles > timer->max_cycles) {
+    fprintf (stderr, "TICKPERIOD_US %u too long for %s!\n",
+             os->tick_period_us, os->board);
+    exit (1);
+  }
+
+  os->tick_duration_ns = (cycles * prescale * 1000000000 +
+                          timer->clock / 2) / timer->clock;
+  /* (achieved - requested) in ns, scaled by clock */
+  error = (int64_t) (cycles * prescale * 1000000000) -
+          (int64_t) (timer->clock * os->tick_period_us * 1000);
+
+  printf ("System tick: %u us requested, %.3f us achieved "
+          "(%+.1f ppm)\n", os->tick_period_us,
+          (double) (cycles * prescale) * 1000000.0 / timer->clock,
+          (double) error * 1000.0 /
+          ((double) timer->clock * os->tick_period_us));
+}
+
+/* Data type sizes of a target, for size estimates */
+typedef struct target_sizes {
+  const char * board;
+  /* Data and code pointers */
+  uint32_t ptr;
+  /* udata_word_t (TaskType) */
+  uint32_t word;
+  /* TickType (uatomic_t) size and alignment */
+  uint32_t tick;
+  uint32_t tick_align;
+  /* Largest natural alignment of a struct member */
+  uint32_t max_align;
+} target_sizes_t;
+
+/* Must match src/include/arch/<arch>/types.h and atomic.h */
+static const target_sizes_t target_sizes[] = {
+  {"ARDUINO", 2, 1, 2, 4, 1},
+  {"ATMEGA", 2, 1, 2, 4, 1},
+  {"LINUX64", 8, 4, 4, 4, 8},
+  {"LINUX", 4, 4, 4, 4, 4},
+  /* ARMv7-M boards */
+  {NULL, 4, 4, 4, 4, 8}
+};
+
+/* Data type sizes of the target board */
+static const target_sizes_t *
+get_target_sizes ()
+{
+  const target_sizes_t * t = NULL;
+
+  for (t = target_sizes; t->board; t++) {
+    if (strncmp (oil_os->board, t->board,
+                 strlen (t->board)) == 0) break;
+  }
+  return t;
+}
+
+/* Append a member to a struct layout, return its end offset */
+static uint32_t
+layout_add (uint32_t * size, uint32_t * align, const target_sizes_t * t,
+            uint32_t msize, uint32_t malign)
+{
+  if (malign > t->max_align) malign = t->max_align;
+  if (!malign) malign = 1;
+  *size = (*size + malign - 1) / malign * malign + msize;
+  if (malign > *align) *align = malign;
+  return *size;
+}
+
+/* Round a struct layout up to its alignment */
+static uint32_t
+layout_end (uint32_t size, uint32_t align)
+{
+  return (size + align - 1) / align * align;
+}
+
+static uint64_t
+gcd (uint64_t a, uint64_t b)
+{
+  while (b) {
+    uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/* Whether alarm is started in appmode */
+static bool
+alarm_in_appmode (oil_alarm_object_t * alarm, uint32_t mode)
+{
+  oil_appmode_object_t * appmode = NULL;
+  oil_object_list_t * index = NULL;
+
+  for_each (appmode, alarm->appmode, index) {
+    if (appmode->id == mode) return TRUE;
+  }
+  return FALSE;
+}
+
+/* Whether alarm expires at tick t (1 to hyperperiod) */
+static bool
+alarm_due (oil_alarm_object_t * alarm, uint32_t t)
+{
+  /* alarm_time <= cycle_time, checked before */
+  return ((t % alarm->cycle_time) ==
+          (alarm->alarm_time % alarm->cycle_time));
+}
+
+/*
+ * Compile the cyclic SYS_COUNTER alarms into one dispatch
+ * table per appmode. Each table covers one hyperperiod and
+ * only holds the ticks at which tasks are activated. The
+ * alarms are removed from the configuration afterwards.
+ */
+static void
+update_cyclic_executive ()
+{
+  oil_alarm_object_t * alarm = NULL;
+  oil_counter_object_t * counter = get_counter_object ("SYS_COUNTER");
+  oil_object_list_t * index = NULL;
+  const target_sizes_t * t = NULL;
+  uint64_t period = 0;
+  uint32_t mode = 0, tick = 0, activations = 0;
+  uint32_t aqt = 0, act = 0, align = 0, aalign = 0, alarm_id = 0;
+  uint32_t slot = 0, table = 0, sz = 0, salign = 0;
+  int64_t ram = 0, flash = 0;
+
+  if (oil_os->tickless || oil_os->task_timers || oil_os->edf_scheduler) {
+    fprintf (stderr, "Cyclic executive does not support TICKLESS,"
+             " TASKTIMERS or EDFSCHEDULER!\n");
+    exit (1);
+  }
+  if (oil_sched_tbls) {
+    fprintf (stderr, "Cyclic executive does not support"
+             " schedule tables!\n");
+    exit (1);
+  }
+  if (counter->ticks_per_base != 1) {
+    fprintf (stderr, "Cyclic executive requires SYS_COUNTER"
+             " ticks_per_base 1!\n");
+    exit (1);
+  }
+
+  for_each (alarm, oil_alarms, index) {
+    if ((alarm->counter != counter) ||
+        (alarm->action.type != ACTION_TYPE_ACTIVATETASK) ||
+        (!alarm->autostart) || (alarm->cycle_time == 0) ||
+        (alarm->alarm_time == 0) ||
+        (alarm->alarm_time > alarm->cycle_time)) {
+      fprintf (stderr, "%s is not a cyclic SYS_COUNTER task"
+               " activation (0 < ALARMTIME <= CYCLETIME)!\n",
+               alarm->name);
+      exit (1);
+    }
+  }
+
+  cyclic_periods = calloc (num_appmodes, sizeof (uint32_t));
+  cyclic_slots = calloc (num_appmodes, sizeof (uint32_t));
+
+  for (mode = 0; mode < num_appmodes; mode++) {
+    /* Hyperperiod is the LCM of all the cycles */
+    period = 1;
+    for_each (alarm, oil_alarms, index) {
+      if (!alarm_in_appmode (alarm, mode)) continue;
+      period = period / gcd (period, alarm->cycle_time) *
+               alarm->cycle_time;
+      if (period > counter->max_allowed_value) {
+        fprintf (stderr, "Cyclic executive hyperperiod exceeds"
+                 " SYS_COUNTER range!\n");
+        exit (1);
+      }
+    }
+    cyclic_periods[mode] = period;
+
+    for (tick = 1; tick <= period; tick++) {
+      bool due = FALSE;
+      for_each (alarm, oil_alarms, index) {
+        if (!alarm_in_appmode (alarm, mode)) continue;
+        if (!alarm_due (alarm, tick)) continue;
+        activations++;
+        due = TRUE;
+      }
+      if (due) cyclic_slots[mode]++;
+    }
+
+    printf ("Cyclic executive: mode %u hyperperiod %u ticks,"
+            " %u slots\n", mode, cyclic_periods[mode],
+            cyclic_slots[mode]);
+  }
+
+  /* Estimate data sizes of both kernels on the target */
+  t = get_target_sizes ();
+  alarm_id = (num_alarms > 0x100) ? 2 : 1;
+  layout_add (&act, &aalign, t, t->word, t->word);
+  layout_add (&act, &aalign, t, (max_mask > 0xFF) ?
+              ((max_mask > 0xFFFF) ? ((max_mask > 0xFFFFFFFF) ?
+              8 : 4) : 2) : 1, 8);
+  layout_add (&act, &aalign, t, t->ptr, t->ptr);
+  layout_add (&act, &aalign, t, t->word, t->word);
+  act = layout_end (act, aalign);
+  layout_add (&aqt, &align, t, alarm_id, alarm_id);
+  layout_add (&aqt, &align, t, t->ptr, t->ptr);
+  layout_add (&aqt, &align, t, 1, 1);
+  layout_add (&aqt, &align, t, t->tick, t->tick_align);
+  if (wide_counter_time)
+    layout_add (&aqt, &align, t, t->tick * 2, t->max_align);
+  else
+    layout_add (&aqt, &align, t, t->tick, t->tick_align);
+  layout_add (&aqt, &align, t, act, aalign);
+  layout_add (&aqt, &align, t, t->ptr, t->ptr);
+  layout_add (&aqt, &align, t, t->ptr, t->ptr);
+  aqt = layout_end (aqt, align);
+
+  salign = 0;
+  layout_add (&slot, &salign, t, t->tick, t->tick_align);
+  layout_add (&slot, &salign, t, t->ptr, t->ptr);
+  layout_add (&slot, &salign, t, t->word, t->word);
+  slot = layout_end (slot, salign);
+  salign = 0;
+  layout_add (&table, &salign, t, t->ptr, t->ptr);
+  layout_add (&table, &salign, t, t->tick, t->tick_align);
+  layout_add (&table, &salign, t, t->tick, t->tick_align);
+  table = layout_end (table, salign);
+
+  /* alarms[] and auto_alarms[] are initialized data */
+  ram = (int64_t) num_alarms * (aqt + num_appmodes * alarm_id);
+  flash = ram;
+  /* Dispatcher state: phase, next slot and table */
+  ram -= t->tick * 2 + t->ptr;
+  for (mode = 0; mode < num_appmodes; mode++) {
+    sz += table + cyclic_slots[mode] * slot;
+  }
+  flash -= sz + activations * t->word;
+
+  /* The tables may take more flash than the alarms */
+  printf ("Cyclic executive %s about %lld bytes RAM and %s about"
+          " %lld bytes flash (data only)\n",
+          (ram < 0) ? "costs" : "saves",
+          (long long) ((ram < 0) ? -ram : ram),
+          (flash < 0) ? "costs" : "saves",
+          (long long) ((flash < 0) ? -flash : flash));
+
+  /* The alarms only live on in the dispatch tables */
+  cyclic_alarms = oil_alarms;
+  oil_alarms = NULL;
+  num_alarms = 0;
+}
+
 static void
 update_oil_objects ()
 {
@@ -1140,12 +1555,23 @@ update_oil_objects ()
   prios_t * prios = malloc (sizeof (prios_t) * num_tasks);
   bool appmode_default_set = FALSE;
   uint32_t * cnter_cnt;
+  uint64_t tick_window = 0;
 
   /* Update OS object */
   if (oil_os->board == NULL) {
     fprintf (stderr, "Board is not specified!\n");
     exit (1);
   }
+  update_tick_period (oil_os);
+  if (oil_os->trace && !oil_os->trace_buf_size) {
+    /* 12 bytes per record, keep it small on AVR boards */
+    if (strncmp (oil_os->board, "ARDUINO", 7) == 0 ||
+        strncmp (oil_os->board, "ATMEGA", 6) == 0) {
+      oil_os->trace_buf_size = 32;
+    } else {
+      oil_os->trace_buf_size = 1024;
+    }
+  }
 
   /* Update task objects */
   id = 1;
@@ -1167,6 +1593,18 @@ update_oil_objects ()
       exit (1);
     }
     icount = 0;
+    if (oil_os->edf_scheduler) {
+      if (!task->deadline) {
+        fprintf (stderr, "%s deadline not specified!\n", task->name);
+        exit (1);
+      }
+      if (task->priority != -1) {
+        fprintf (stdout, "Warning: %s priority ignored."
+                 " Derived from deadline with EDF.\n", task->name);
+      }
+      /* Shorter deadline, higher preemption level */
+      task->priority = MAX_DEADLINE - task->deadline + 1;
+    }
     if (task->priority == -1) {
       fprintf (stdout, "Warning: %s priority not specified."
                " Default to lowest task priority (1).\n", task->name);
@@ -1177,6 +1615,16 @@ update_oil_objects ()
                " Default to 1.\n", task->name);
       task->activation = 1;
     }
+    /*
+     * The absolute deadline of a task is stamped when an
+     * activation starts. A queued activation would inherit a
+     * deadline from its termination instead of its release.
+     */
+    if (oil_os->edf_scheduler && (task->activation > 1)) {
+      fprintf (stderr, "%s multiple activation not supported"
+               " with EDF!\n", task->name);
+      exit (1);
+    }
     /* Multiple activation should be enabled */
     if (task->activation > 1) {
       mult_activation = TRUE;
@@ -1209,6 +1657,19 @@ update_oil_objects ()
 
   max_prio = cur_p;
 
+  /* EDF ready queue is linked through the next field */
+  if (oil_os->edf_scheduler) mult_task_per_prio = TRUE;
+
+  /*
+   * Under EDF, a task may start on top of a preempted task
+   * of the same preemption level, which would reuse its
+   * shared stack.
+   */
+  if (oil_os->edf_scheduler && oil_os->shared_stack) {
+    fprintf (stderr, "SHAREDSTACK not supported with EDF!\n");
+    exit (1);
+  }
+
   qsort (prios, num_tasks, sizeof (prios_t), cmpfunc2);
 
   i = 0;
@@ -1216,6 +1677,41 @@ update_oil_objects ()
     task->priority = prios[i++].prio;
   }
 
+  /* Time slices apply to a priority level as a whole */
+  for_each (task, oil_tasks, index) {
+    if (!task->timeslice) continue;
+    if (oil_os->edf_scheduler) {
+      fprintf (stderr, "%s time slice not supported with EDF!\n",
+               task->name);
+      exit (1);
+    }
+    /*
+     * Rotation starts the next task of a level while the
+     * rotated one is still on the shared stack of the level.
+     */
+    if (oil_os->shared_stack) {
+      fprintf (stderr, "%s time slice not supported with"
+               " SHAREDSTACK!\n", task->name);
+      exit (1);
+    }
+    if (!prio_slices) {
+      prio_slices = calloc (max_prio + 1, sizeof (uint32_t));
+    }
+    if (prio_slices[task->priority] &&
+        (prio_slices[task->priority] != task->timeslice)) {
+      fprintf (stderr, "%s time slice differs from other tasks"
+               " of the same priority!\n", task->name);
+      exit (1);
+    }
+    prio_slices[task->priority] = task->timeslice;
+  }
+  if (prio_slices && !mult_task_per_prio) {
+    fprintf (stdout, "Warning: time slices ignored."
+             " No tasks share a priority.\n");
+    free (prio_slices);
+    prio_slices = NULL;
+  }
+
   /* Update event objects */
   id = 0;
   max_mask = 1;
@@ -1281,9 +1777,37 @@ update_oil_objects ()
    */
   counter = get_counter_object ("SYS_COUNTER");
   if (!counter->min_cycle) counter->min_cycle = 1;
-  if (!counter->max_allowed_value) counter->max_allowed_value = 0xFFFF;
+  /*
+   * Counter events are compared within half of the TickType
+   * range of the target (see TICK_WINDOW in counter.h).
+   */
+  tick_window = (uint64_t) 1 << (get_target_sizes ()->tick * 8 - 1);
+  if (!counter->max_allowed_value) {
+    counter->max_allowed_value = (tick_window > 0x10000) ?
+                                 0xFFFF : tick_window - 1;
+  }
   if (!counter->ticks_per_base) counter->ticks_per_base = 1;
 
+  if (oil_os->edf_scheduler) {
+    /* Deadlines are compared modulo the SYS_COUNTER range */
+    for_each (task, oil_tasks, index) {
+      if (task->deadline > counter->max_allowed_value / 2) {
+        fprintf (stderr, "%s deadline exceeds half of SYS_COUNTER"
+                 " range!\n", task->name);
+        exit (1);
+      }
+    }
+  }
+
+  /* Time slices are counted down in TickType */
+  for_each (task, oil_tasks, index) {
+    if (prio_slices && (task->timeslice > counter->max_allowed_value)) {
+      fprintf (stderr, "%s time slice exceeds SYS_COUNTER"
+               " range!\n", task->name);
+      exit (1);
+    }
+  }
+
   for_each (counter, oil_counters, index) {
     counter->id = id++;
     if (counter->min_cycle == 0) {
@@ -1300,24 +1824,54 @@ update_oil_objects ()
                counter->name);
       exit (1);
     }
-    /* We need to make sure max_allowed_value can fit into atomic_t */
-    if (strncmp (oil_os->board, "ARDUINO_UNO", 11) == 0) {
-      if (counter->max_allowed_value > 0xFFFF) {
-        fprintf (stderr, "Counter %s max_allowed_value illegal!\n",
-                 counter->name);
-        fprintf (stderr, "Board max_allowed_value is 0xFFFF\n");
-        exit (1);
+    if (counter->max_allowed_value > (tick_window << 1) - 1) {
+      fprintf (stderr, "Counter %s max_allowed_value illegal!\n",
+               counter->name);
+      fprintf (stderr, "Board max_allowed_value is 0x%llX\n",
+               (unsigned long long) ((tick_window << 1) - 1));
+      exit (1);
+    }
+    if (counter->max_allowed_value >= tick_window) {
+      /*
+       * Pending counter events would not fit in half of the
+       * TickType range (see TICK_WINDOW in counter.h).
+       */
+      fprintf (stdout, "Warning: %s max_allowed_value above 0x%llX."
+               " Counter time widened to %u bits, use 0x%llX or"
+               " less to keep it in TickType.\n", counter->name,
+               (unsigned long long) (tick_window - 1),
+               get_target_sizes ()->tick * 16,
+               (unsigned long long) (tick_window - 1));
+      wide_counter_time = TRUE;
+    }
+    if (counter->ticks_per_base > counter->max_allowed_value) {
+      fprintf (stderr, "Counter %s ticks_per_base exceeds"
+               " max_allowed_value!\n", counter->name);
+      exit (1);
+    }
+    if (max_tick < counter->max_allowed_value)
+      max_tick = counter->max_allowed_value;
+    if (counter->timing_wheel) {
+      /*
+       * Alarms can be set up to max_allowed_value +
+       * ticks_per_base ticks ahead of the wheel time. All
+       * levels but the top one must not wrap around within
+       * that range.
+       */
+      counter->wheel_levels = 1;
+      while ((((uint64_t) WHEEL_SLOTS - 1) <<
+              ((counter->wheel_levels - 1) * WHEEL_SLOT_BITS)) <
+             ((uint64_t) counter->max_allowed_value +
+              counter->ticks_per_base)) {
+        counter->wheel_levels++;
       }
-    } else {
-      if (counter->max_allowed_value > 0xFFFFFFFF) {
-        fprintf (stderr, "Counter %s max_allowed_value illegal!\n",
-                 counter->name);
-        fprintf (stderr, "Board max_allowed_value is 0xFFFFFFFF\n");
+      if (counter->wheel_levels > MAX_WHEEL_LEVELS) {
+        fprintf (stderr, "Counter %s max_allowed_value too large "
+                 "for timing wheel!\n", counter->name);
         exit (1);
       }
+      with_timing_wheel = TRUE;
     }
-    if (max_tick < counter->max_allowed_value)
-      max_tick = counter->max_allowed_value;
   }
 
   /* Update resource objects */
@@ -1413,6 +1967,11 @@ update_oil_objects ()
         }
         break;
       case ACTION_TYPE_SETEVENT :
+        if (!(alarm->action.task)) {
+          fprintf (stderr, "%s task not specified!\n",
+                   alarm->name);
+          exit (1);
+        }
         if (!(alarm->action.event)) {
           fprintf (stderr, "%s event not specified!\n",
                    alarm->name);
@@ -1647,6 +2206,17 @@ update_oil_objects ()
     sched_tbl->delay = sched_tbl->duration - max_off;
   }
 
+  if (oil_os->cyclic_executive) update_cyclic_executive ();
+
+  /* The kernel has no alarm queues without alarms */
+  if (with_timing_wheel && !num_alarms && !oil_os->task_timers) {
+    fprintf (stdout, "Warning: timing wheels ignored. No alarms.\n");
+    for_each (counter, oil_counters, index) {
+      counter->timing_wheel = FALSE;
+    }
+    with_timing_wheel = FALSE;
+  }
+
   /* Update driver objects */
   if (num_drivers) {
     id = 0;
@@ -1722,8 +2292,10 @@ generate_code ()
   oil_sched_tbl_object_t * sched_tbl = NULL;
   oil_expiry_point_object_t * exp = NULL;
   oil_expiry_point_event_object_t * task_event = NULL;
+  oil_expiry_point_event_object_t * task_event2 = NULL;
   oil_driver_object_t * driver = NULL;
-  oil_object_list_t * index = NULL, * index2 = NULL;
+  oil_object_list_t * index = NULL, * index2 = NULL, * index3 = NULL;
+  uint64_t mask = 0;
 
   /* Tmp file for config.mk */
   FILE * tmp_cfgmk = NULL;
@@ -1780,6 +2352,62 @@ generate_code ()
   }
   if (with_sched_tbl_sync)
     PRT_CFGMK ("CFG += -DSCHEDTBL_SYNC\n");
+  if (with_timing_wheel) {
+    PRT_CFGMK ("# Timing wheel alarm queue for selected counters\n");
+    PRT_CFGMK ("CFG += -DUSE_TIMING_WHEEL\n");
+  }
+  if (wide_counter_time) {
+    PRT_CFGMK ("# Counter time wider than TickType\n");
+    PRT_CFGMK ("CFG += -DWIDE_COUNTER_TIME\n");
+  }
+  if (oil_os->tickless) {
+    PRT_CFGMK ("# Suppress periodic ticks when idle\n");
+    PRT_CFGMK ("CFG += -DTICKLESS\n");
+  }
+  if (oil_os->stats) {
+    PRT_CFGMK ("# Collect kernel statistics\n");
+    PRT_CFGMK ("CFG += -DKERNEL_STATS\n");
+  }
+  if (oil_os->task_stats) {
+    PRT_CFGMK ("# Per-task CPU time accounting\n");
+    PRT_CFGMK ("CFG += -DTASK_STATS\n");
+  }
+  if (oil_os->latency_hist) {
+    PRT_CFGMK ("# Release to dispatch latency histograms\n");
+    PRT_CFGMK ("CFG += -DLATENCY_HIST\n");
+  }
+  if (oil_os->syscall_prof) {
+    PRT_CFGMK ("# Per-service call, error and cycle profile\n");
+    PRT_CFGMK ("CFG += -DSYSCALL_PROF\n");
+  }
+  if (oil_os->stack_monitor) {
+    PRT_CFGMK ("# Stack high-watermark monitor\n");
+    PRT_CFGMK ("CFG += -DSTACK_MONITOR\n");
+  }
+  if (oil_os->shared_stack) {
+    PRT_CFGMK ("# Basic tasks of the same priority share one stack\n");
+    PRT_CFGMK ("CFG += -DSHARED_STACK\n");
+  }
+  if (oil_os->task_timers) {
+    PRT_CFGMK ("# Per-task timers for WaitEventTimeout and SleepTicks\n");
+    PRT_CFGMK ("CFG += -DTASK_TIMERS\n");
+  }
+  if (oil_os->edf_scheduler) {
+    PRT_CFGMK ("# Earliest deadline first scheduling\n");
+    PRT_CFGMK ("CFG += -DEDF_SCHEDULER\n");
+  }
+  if (prio_slices) {
+    PRT_CFGMK ("# Round robin time slicing within a priority\n");
+    PRT_CFGMK ("CFG += -DTIME_SLICING\n");
+  }
+  if (oil_os->cyclic_executive) {
+    PRT_CFGMK ("# Static dispatch tables replace SYS_COUNTER alarms\n");
+    PRT_CFGMK ("CFG += -DCYCLIC_EXECUTIVE\n");
+  }
+  if (oil_os->trace) {
+    PRT_CFGMK ("# Record kernel events in trace buffer\n");
+    PRT_CFGMK ("CFG += -DKERNEL_TRACE\n");
+  }
   PRT_CFGMK ("\n");
   PRT_CFGMK ("# Selected objects to be compiled\n");
 
@@ -1792,6 +2420,23 @@ generate_code ()
   PRT_CFGMK ("OBJ += debug.o\n");
   PRT_CFGMK ("OBJ += config/config.o\n");
   PRT_CFGMK ("OBJ += printf.o\n");
+  PRT_CFGMK ("OBJ += cycle.o\n");
+
+  if (oil_os->task_stats) {
+    PRT_CFGMK ("OBJ += taskstats.o\n");
+  }
+  if (oil_os->latency_hist) {
+    PRT_CFGMK ("OBJ += latency.o\n");
+  }
+  if (oil_os->syscall_prof) {
+    PRT_CFGMK ("OBJ += sysprof.o\n");
+  }
+  if (oil_os->stack_monitor) {
+    PRT_CFGMK ("OBJ += stackmon.o\n");
+  }
+  if (oil_os->trace) {
+    PRT_CFGMK ("OBJ += trace.o\n");
+  }
 
   if (oil_os->shell) {
     /* Shell configured */
@@ -1802,6 +2447,9 @@ generate_code ()
     PRT_CFGMK ("# AUTOSAR objects\n");
     PRT_CFGMK ("OBJ += schedtbl.o\n");
   }
+  if (oil_os->cyclic_executive) {
+    PRT_CFGMK ("OBJ += cyclic.o\n");
+  }
   PRT_CFGMK ("OBJ += drivers/driver.o\n");
   PRT_CFGMK ("\n");
   PRT_CFGMK ("# Driver Modules\n");
@@ -1886,7 +2534,7 @@ generate_code ()
   /* Events */
   PRT_CFGH ("/* Events */\n");
   for_each (event, oil_events, index) {
-    PRT_CFGH ("#define %s\t0x%" PRIu64 "U\n", event->name, event->mask);
+    PRT_CFGH ("#define %s\t0x%" PRIx64 "U\n", event->name, event->mask);
   }
   PRT_CFGH ("#define NUM_EVENTS\t0x%XU\n", num_events);
   PRT_CFGH ("\n");
@@ -1916,34 +2564,105 @@ generate_code ()
   PRT_CFGH ("#define KERN_STACK_END    (KERN_STACK - KERN_STK_SIZE)\n");
   PRT_CFGH ("\n");
   PRT_CFGH ("#define TASK_STACK_START  (KERN_STACK_END)\n");
-  for_each (task, oil_tasks, index) {
-    PRT_CFGH ("#define TASK_STK_SIZE_%d\t0x%XU\n",
-              task->id, task->stacksize);
-    PRT_CFGH ("#define TASK_STACK_%d\t\\\n", task->id);
-    if (task->id == 1) {
-      PRT_CFGH ("  (TASK_STACK_START)\n");
+  if (oil_os->shared_stack) {
+    /*
+     * Basic tasks never block. A basic task started while
+     * another one is still on its stack has a strictly higher
+     * priority and terminates first. A preemption chain thus
+     * holds at most one basic task per priority level, and its
+     * worst case depth is the sum over the levels of the
+     * largest STACKSIZE. This is the size of the region below.
+     * Each level gets a fixed part of it instead of stacking
+     * frames at the current stack pointer, so tasks are still
+     * entered through a regular context switch. This relies on
+     * fixed priorities and FIFO order among tasks of equal
+     * priority. Extended tasks keep their own stacks. Each
+     * stack is placed right below the previous one.
+     */
+    char top[32] = "TASK_STACK_START", size[32] = "";
+    uint32_t prio = 0, level_size = 0;
+
+    for_each (task, oil_tasks, index) {
+      if (!task->event) continue;
+      PRT_CFGH ("#define TASK_STK_SIZE_%d\t0x%XU\n",
+                task->id, task->stacksize);
+      if (size[0]) {
+        PRT_CFGH ("#define TASK_STACK_%d\t(%s - %s)\n",
+                  task->id, top, size);
+      } else {
+        PRT_CFGH ("#define TASK_STACK_%d\t(%s)\n", task->id, top);
+      }
+      sprintf (top, "TASK_STACK_%d", task->id);
+      sprintf (size, "TASK_STK_SIZE_%d", task->id);
+    }
+
+    for (prio = 1; prio <= max_prio; prio++) {
+      level_size = 0;
+      for_each (task, oil_tasks, index) {
+        if (task->event || task->priority != prio) continue;
+        if (task->stacksize > level_size) level_size = task->stacksize;
+      }
+      if (!level_size) continue;
+      PRT_CFGH ("#define SHARED_STK_SIZE_%u\t0x%XU\n", prio, level_size);
+      if (size[0]) {
+        PRT_CFGH ("#define SHARED_STACK_%u\t(%s - %s)\n",
+                  prio, top, size);
+      } else {
+        PRT_CFGH ("#define SHARED_STACK_%u\t(%s)\n", prio, top);
+      }
+      sprintf (top, "SHARED_STACK_%u", prio);
+      sprintf (size, "SHARED_STK_SIZE_%u", prio);
+      for_each (task, oil_tasks, index) {
+        if (task->event || task->priority != prio) continue;
+        PRT_CFGH ("#define TASK_STK_SIZE_%d\tSHARED_STK_SIZE_%u\n",
+                  task->id, prio);
+        PRT_CFGH ("#define TASK_STACK_%d\tSHARED_STACK_%u\n",
+                  task->id, prio);
+      }
+    }
+
+    if (size[0]) {
+      PRT_CFGH ("#define TASK_STACK_END\t(%s - %s)\n", top, size);
     } else {
-      PRT_CFGH ("  (TASK_STACK_START");
-      for (i = 1; i < task->id; i++) {
-        PRT_CFGH (" - TASK_STK_SIZE_%d", i);
+      PRT_CFGH ("#define TASK_STACK_END\t(%s)\n", top);
+    }
+  } else {
+    for_each (task, oil_tasks, index) {
+      PRT_CFGH ("#define TASK_STK_SIZE_%d\t0x%XU\n",
+                task->id, task->stacksize);
+      PRT_CFGH ("#define TASK_STACK_%d\t\\\n", task->id);
+      if (task->id == 1) {
+        PRT_CFGH ("  (TASK_STACK_START)\n");
+      } else {
+        PRT_CFGH ("  (TASK_STACK_START");
+        for (i = 1; i < task->id; i++) {
+          PRT_CFGH (" - TASK_STK_SIZE_%d", i);
+        }
+        PRT_CFGH (")\n");
       }
-      PRT_CFGH (")\n");
     }
-  }
 
-  PRT_CFGH ("#define TASK_STACK_END\t\\\n");
-  PRT_CFGH ("  (TASK_STACK_START");
-  for (i = 1; i <= num_tasks; i++) {
-    PRT_CFGH (" - TASK_STK_SIZE_%d", i);
+    PRT_CFGH ("#define TASK_STACK_END\t\\\n");
+    PRT_CFGH ("  (TASK_STACK_START");
+    for (i = 1; i <= num_tasks; i++) {
+      PRT_CFGH (" - TASK_STK_SIZE_%d", i);
+    }
+    PRT_CFGH (")\n");
   }
-  PRT_CFGH (")\n");
   PRT_CFGH ("\n");
   PRT_CFGH ("#define IDLE_STACK\tTASK_STACK_END\n");
   PRT_CFGH ("\n");
-  PRT_CFGH ("/* Duration of a tick of the systemn counter in nanoseconds */\n");
-  // TODO OSTICKDURATION should be configured?
-  PRT_CFGH ("#define OSTICKDURATION    1000000UL\n");
+  PRT_CFGH ("/* Requested system tick period in microseconds */\n");
+  PRT_CFGH ("#define TICKPERIOD_US     %uUL\n", oil_os->tick_period_us);
+  PRT_CFGH ("/* Duration of a tick of the system counter in nanoseconds */\n");
+  PRT_CFGH ("#define OSTICKDURATION    %" PRIu64 "UL\n",
+            oil_os->tick_duration_ns);
   PRT_CFGH ("\n");
+  if (oil_os->trace) {
+    PRT_CFGH ("/* Number of records in the kernel trace buffer */\n");
+    PRT_CFGH ("#define TRACE_BUF_SIZE    %uU\n", oil_os->trace_buf_size);
+    PRT_CFGH ("\n");
+  }
   PRT_CFGH ("/* Used by Cortex M3 SYSTICK when calibration not available */\n");
   PRT_CFGH ("#define SYSTICK_RELOAD_VALUE  0x0U\n");
   PRT_CFGH ("\n");
@@ -2001,8 +2720,14 @@ generate_code ()
             get_type_string (max_tick));
 #endif
   PRT_CFGH ("/* Type for alarm ID. Limits max alarm supported. */\n");
-  PRT_CFGH ("typedef %s alarm_t;\n",
-            get_type_string (num_alarms ? num_alarms - 1 : 0));
+  if (oil_os->task_timers) {
+    /* Task timers are numbered after the alarms */
+    PRT_CFGH ("typedef %s alarm_t;\n",
+              get_type_string (num_alarms + num_tasks));
+  } else {
+    PRT_CFGH ("typedef %s alarm_t;\n",
+              get_type_string (num_alarms ? num_alarms - 1 : 0));
+  }
   PRT_CFGH ("/* Type for IRQ numbers */\n");
   PRT_CFGH ("typedef %s IRQType;\n",
             get_type_string (max_irq));
@@ -2035,6 +2760,7 @@ generate_code ()
   PRT_CFGC ("\n");
   PRT_CFGC ("#include <osek/osek.h>\n");
   PRT_CFGC ("#include <task.h>\n");
+  if (oil_os->cyclic_executive) PRT_CFGC ("#include <cyclic.h>\n");
   PRT_CFGC ("\n");
   for_each (task, oil_tasks, index) {
     PRT_CFGC ("extern StatusType Func%s (void);\n", task->name);
@@ -2042,12 +2768,18 @@ generate_code ()
   PRT_CFGC ("\n");
   PRT_CFGC ("TCB tasks[] = {\n");
   PRT_CFGC ("  {IDLE_STACK, IDLE_STACK, {{0}},\n");
-  PRT_CFGC ("   TASK_PREEMPTABLE | TASK_EXTENDED,\n");
+  if (oil_os->tickless) {
+    /* Idle task reprograms the system timer when tickless */
+    PRT_CFGC ("   TASK_PREEMPTABLE | TASK_EXTENDED | TASK_PRIVILEGED,\n");
+  } else {
+    PRT_CFGC ("   TASK_PREEMPTABLE | TASK_EXTENDED,\n");
+  }
   PRT_CFGC ("   0, 0, 0, INVALID_PRIO, NULL, SUSPENDED, 0, 0,\n");
   PRT_CFGC ("   (IDLE_STACK - IDLE_STK_SIZE),\n");
   PRT_CFGC ("   (code_addr_t) IdleTask");
   if (mult_activation) PRT_CFGC (", 0, 1");
   if (mult_task_per_prio) PRT_CFGC (", (TCB *) 0");
+  if (oil_os->edf_scheduler) PRT_CFGC (", 0");
   PRT_CFGC ("},\n");
   for_each (task, oil_tasks, index) {
     PRT_CFGC ("  {TASK_STACK_%d, TASK_STACK_%d, {{0}},\n",
@@ -2086,6 +2818,7 @@ generate_code ()
     PRT_CFGC ("   (code_addr_t) Func%s", task->name);
     if (mult_activation) PRT_CFGC (", %d, %d", 0, task->activation);
     if (mult_task_per_prio) PRT_CFGC (", (TCB *) 0");
+    if (oil_os->edf_scheduler) PRT_CFGC (", %d", task->deadline);
     PRT_CFGC ("},\n");
   }
   PRT_CFGC ("};\n");
@@ -2115,7 +2848,9 @@ generate_code ()
   PRT_CFGC ("\n");
   PRT_CFGC ("prio_queue_t prio_queue[MAX_PRIO + 1] = {");
   for (i = 0; i < (max_prio + 1); i++) {
-    if (mult_task_per_prio)
+    if (prio_slices)
+      PRT_CFGC ("{0, 0, %u}, ", prio_slices[i]);
+    else if (mult_task_per_prio)
       PRT_CFGC ("{0, 0}, ");
     else
       PRT_CFGC ("0, ");
@@ -2141,11 +2876,34 @@ generate_code ()
   }
   PRT_CFGC ("};\n");
   PRT_CFGC ("\n");
+  if (with_timing_wheel) {
+    i = 0;
+    for_each (counter, oil_counters, index) {
+      if (!counter->timing_wheel) continue;
+      PRT_CFGC ("AlarmQueueType * wslots_%s[%d * WHEEL_SLOTS];\n",
+                counter->name, counter->wheel_levels);
+    }
+    PRT_CFGC ("TimingWheelType wheels[] = {\n");
+    for_each (counter, oil_counters, index) {
+      if (!counter->timing_wheel) continue;
+      PRT_CFGC ("  {wslots_%s, %d, 0, 0},\n", counter->name,
+                counter->wheel_levels);
+    }
+    PRT_CFGC ("};\n");
+    PRT_CFGC ("\n");
+  }
   PRT_CFGC ("Counter counters[] = {\n");
   for_each (counter, oil_counters, index) {
-    PRT_CFGC ("  {0, {0x%X, %d, %d}, 0, NULL},\n",
+    PRT_CFGC ("  {0, {0x%X, %d, %d}, 0, NULL",
               counter->max_allowed_value,
               counter->ticks_per_base, counter->min_cycle);
+    if (with_timing_wheel) {
+      if (counter->timing_wheel)
+        PRT_CFGC (", &wheels[%d]", i++);
+      else
+        PRT_CFGC (", NULL");
+    }
+    PRT_CFGC ("},\n");
   }
   PRT_CFGC ("};\n");
   PRT_CFGC ("\n");
@@ -2165,7 +2923,8 @@ generate_code ()
     }
   }
   PRT_CFGC ("\n");
-  PRT_CFGC ("AlarmQueueType alarms[] = {\n");
+  /* Task timers (if any) follow, initialized by the kernel */
+  PRT_CFGC ("AlarmQueueType alarms[NUM_ALARMS + NUM_TASK_TIMERS] = {\n");
   for_each (alarm, oil_alarms, index) {
     PRT_CFGC ("  {%d, &counters[%s], 0, %d, %d, ",
               alarm->id, alarm->counter->name,
@@ -2178,7 +2937,8 @@ generate_code ()
       }
       case ACTION_TYPE_SETEVENT :
       {
-        PRT_CFGC ("{0, 0x%" PRIu64 ", NULL, 0}, ", alarm->action.event->mask);
+        PRT_CFGC ("{%d, 0x%" PRIx64 ", NULL, 0}, ",
+                  alarm->action.task->id, alarm->action.event->mask);
         break;
       }
       case ACTION_TYPE_ALARMCALLBACK :
@@ -2228,6 +2988,39 @@ generate_code ()
   }
   PRT_CFGC ("};\n");
   PRT_CFGC ("\n");
+  if (oil_os->cyclic_executive) {
+    for (i = 0; i < num_appmodes; i++) {
+      uint32_t tick = 0;
+      for (tick = 1; tick <= cyclic_periods[i]; tick++) {
+        bool due = FALSE;
+        for_each (alarm, cyclic_alarms, index) {
+          if (!alarm_in_appmode (alarm, i)) continue;
+          if (!alarm_due (alarm, tick)) continue;
+          if (!due) PRT_CFGC ("const TaskType ctask%d_%u[] = {", i, tick);
+          PRT_CFGC ("%d, ", alarm->action.task->id);
+          due = TRUE;
+        }
+        if (due) PRT_CFGC ("};\n");
+      }
+      PRT_CFGC ("const CyclicSlotType cslots%d[] = {\n", i);
+      for (tick = 1; tick <= cyclic_periods[i]; tick++) {
+        uint32_t n = 0;
+        for_each (alarm, cyclic_alarms, index) {
+          if (alarm_in_appmode (alarm, i) && alarm_due (alarm, tick)) n++;
+        }
+        if (n) PRT_CFGC ("  {%u, {ctask%d_%u, %u}},\n", tick, i, tick, n);
+      }
+      PRT_CFGC ("};\n");
+    }
+    PRT_CFGC ("\n");
+    PRT_CFGC ("const CyclicTableType cyclic_tables[] = {\n");
+    for (i = 0; i < num_appmodes; i++) {
+      PRT_CFGC ("  {cslots%d, %u, %u},\n", i, cyclic_slots[i],
+                cyclic_periods[i]);
+    }
+    PRT_CFGC ("};\n");
+    PRT_CFGC ("\n");
+  }
   PRT_CFGC ("IRQType isr1_list[] = {");
   for_each (isr, oil_isrs, index) {
     if (isr->category == 1)
@@ -2244,16 +3037,27 @@ generate_code ()
   if (with_sched_tbl) {
     for_each (exp, oil_expiry_points, index) {
       if (exp->num_tasks > 0) {
-        PRT_CFGC ("TaskType tlist_%s[] = {", exp->name);
+        PRT_CFGC ("const TaskType tlist_%s[] = {", exp->name);
         for_each (task, exp->tasks, index2) {
           PRT_CFGC ("%d, ", task->id);
         }
         PRT_CFGC ("};\n");
       }
       if (exp->num_task_events > 0) {
-        PRT_CFGC ("ExpiryPointEventList elist_%s[] = {", exp->name);
+        /* Events of the same task are set with one entry */
+        exp->num_task_events = 0;
+        PRT_CFGC ("const ExpiryPointEventList elist_%s[] = {", exp->name);
         for_each (task_event, exp->task_events, index2) {
-          PRT_CFGC ("{%d, 0x%" PRIu64 "}, ", task_event->task->id, task_event->event->mask);
+          mask = 0;
+          for_each (task_event2, exp->task_events, index3) {
+            if (task_event2->task != task_event->task) continue;
+            /* Already emitted with an earlier entry */
+            if (!mask && index3 != index2) break;
+            mask |= task_event2->event->mask;
+          }
+          if (!mask) continue;
+          PRT_CFGC ("{%d, 0x%" PRIx64 "}, ", task_event->task->id, mask);
+          exp->num_task_events++;
         }
         PRT_CFGC ("};\n");
       }
@@ -2264,10 +3068,10 @@ generate_code ()
       for_each (exp, sched_tbl->exps, index2) {
         PRT_CFGC ("  {%d, ", exp->offset);
         if (exp->num_tasks > 0)
-          PRT_CFGC ("tlist_%s, ", exp->name);
+          PRT_CFGC ("{tlist_%s, ", exp->name);
         else
-          PRT_CFGC ("NULL, ");
-        PRT_CFGC ("%d, ", exp->num_tasks);
+          PRT_CFGC ("{NULL, ");
+        PRT_CFGC ("%d}, ", exp->num_tasks);
         if (exp->num_task_events > 0)
           PRT_CFGC ("elist_%s, ", exp->name);
         else
@@ -2401,6 +3205,9 @@ print_help (const char * cmd)
   printf ("\t-d \t\t\tDump all objects\n");
   printf ("\t-b \t\t\tBackup old configuration files\n");
   printf ("\t-m \t\t\tBuild system image\n");
+  printf ("\t-w <REPORT> \t\tRecommend stack sizes from a saved\n");
+  printf ("\t\t\t\tshell \"stack\" report\n");
+  printf ("\t-p <PERCENT> \t\tStack size safety margin (25)\n");
   printf ("\t-h \t\t\tPrint this help message\n");
   printf ("\t-v \t\t\tVersion\n");
 }
@@ -2513,7 +3320,7 @@ main (int argc, char * argv[])
   char * cwd = NULL;
 
   /* Parse argument options */
-  while ((c = getopt (argc, argv, "i:s:rtdbmhv")) != -1) {
+  while ((c = getopt (argc, argv, "i:s:rtdbmw:p:hv")) != -1) {
     switch (c) {
       case 'i':
         include_path = malloc (strlen (optarg) + 1);
@@ -2547,6 +3354,16 @@ main (int argc, char * argv[])
       case 'm':
         mflag = TRUE;
         break;
+      case 'w':
+        stack_report = optarg;
+        break;
+      case 'p':
+        stack_margin = atoi (optarg);
+        if (stack_margin < 0) {
+          fprintf (stderr, "Invalid stack margin %s!\n", optarg);
+          exit (1);
+        }
+        break;
       case 'h':
         print_help (argv[0]);
         exit (0);
@@ -2555,7 +3372,8 @@ main (int argc, char * argv[])
         printf ("Author: Ye Li (liye@sdvos.org)\n");
         exit (0);
       case '?':
-        if (optopt == 'i' || optopt == 's') {
+        if (optopt == 'i' || optopt == 's' ||
+            optopt == 'w' || optopt == 'p') {
           fprintf (stderr, "Option -%c requires argument!\n", optopt);
         } else {
           fprintf (stderr, "Unknow option: -%c!\n", optopt);
@@ -2597,8 +3415,12 @@ main (int argc, char * argv[])
 
   if (rflag) show_stats ();
 
+  if (stack_report && (show_stack_report (stack_report, stack_margin) < 0)) {
+    exit (1);
+  }
+
   if (!sdvos_root) {
-    if (!rflag && !dflag) {
+    if (!rflag && !dflag && !stack_report) {
       fprintf (stderr, "SDVOS source root directory not specified!\n\n");
       print_help (argv[0]);
     }
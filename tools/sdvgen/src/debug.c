@@ -52,6 +52,30 @@ dump_os (oil_os_object_t * os)
   printf ("  USERESSCHEDULER: %s\n", (os->use_resscheduler) ?
           "TRUE" : "FALSE");
   printf ("  DEBUGLEVEL: %d\n", os->debuglevel);
+  printf ("  TICKLESS: %s\n", (os->tickless) ?
+          "TRUE" : "FALSE");
+  printf ("  STATS: %s\n", (os->stats) ?
+          "TRUE" : "FALSE");
+  printf ("  TASKSTATS: %s\n", (os->task_stats) ?
+          "TRUE" : "FALSE");
+  printf ("  LATENCYHIST: %s\n", (os->latency_hist) ?
+          "TRUE" : "FALSE");
+  printf ("  SYSCALLPROF: %s\n", (os->syscall_prof) ?
+          "TRUE" : "FALSE");
+  printf ("  STACKMONITOR: %s\n", (os->stack_monitor) ?
+          "TRUE" : "FALSE");
+  printf ("  SHAREDSTACK: %s\n", (os->shared_stack) ?
+          "TRUE" : "FALSE");
+  printf ("  TASKTIMERS: %s\n", (os->task_timers) ?
+          "TRUE" : "FALSE");
+  printf ("  EDFSCHEDULER: %s\n", (os->edf_scheduler) ?
+          "TRUE" : "FALSE");
+  printf ("  CYCLICEXECUTIVE: %s\n", (os->cyclic_executive) ?
+          "TRUE" : "FALSE");
+  printf ("  TICKPERIOD_US: %u\n", os->tick_period_us);
+  printf ("  TRACE: %s\n", (os->trace) ?
+          "TRUE" : "FALSE");
+  printf ("  TRACEBUFSIZE: %u\n", os->trace_buf_size);
   printf ("  BOARD: %s\n", os->board);
 
   for_each (driver, oil_drivers, index) {
@@ -85,6 +109,10 @@ dump_task (oil_task_object_t * task)
   printf ("  Activation = %d\n", task->activation);
   printf ("  Schedule = %s\n", sched);
   printf ("  Stacksize = %d\n", task->stacksize);
+  if (task->deadline)
+    printf ("  Deadline = %d\n", task->deadline);
+  if (task->timeslice)
+    printf ("  Timeslice = %u\n", task->timeslice);
 
   if (task->autostart) {
     printf ("  Auto start in application mode: ");
@@ -138,6 +166,8 @@ dump_counter (oil_counter_object_t * counter)
   printf ("  MINCYCLE = %d\n", counter->min_cycle);
   printf ("  MAXALLOWEDVALUE = %d\n", counter->max_allowed_value);
   printf ("  TICKSPERBASE = %d\n", counter->ticks_per_base);
+  printf ("  TIMINGWHEEL = %s\n", (counter->timing_wheel) ?
+          "TRUE" : "FALSE");
 }
 
 void
@@ -405,4 +435,72 @@ show_stats ()
   printf ("-------------------------------------------\n");
 }
 
+/* Stack sizes are recommended in multiples of this */
+#define STACK_SIZE_ALIGN    8
+
+/**
+ * Print the recommended size of one stack. peak and size
+ * are from the report, current is the configured size (0
+ * if unknown).
+ */
+static void
+show_stack_size (const char * name, unsigned long peak,
+                 unsigned long size, unsigned long current, int margin)
+{
+  unsigned long rec = (peak * (100 + margin) + 99) / 100;
+  char config[24] = "-";
+
+  rec = (rec + STACK_SIZE_ALIGN - 1) & ~(STACK_SIZE_ALIGN - 1UL);
+  if (current) snprintf (config, sizeof (config), "%lu", current);
+  printf ("%-18s| %-8lu| %-8lu| %-8s| %lu%s\n", name, peak, size,
+          config, rec, (peak >= size) ? " (full, re-measure)" : "");
+}
+
+int
+show_stack_report (const char * report, int margin)
+{
+  oil_task_object_t * task;
+  oil_object_list_t * index;
+  char line[256], id[16];
+  unsigned long peak = 0, size = 0;
+  FILE * fp = NULL;
+  bool found = FALSE;
+
+  if (!(fp = fopen (report, "r"))) {
+    fprintf (stderr, "Cannot open %s!\n", report);
+    return -1;
+  }
+
+  printf ("-------------------------------------------\n");
+  printf ("SDVOS Stack Size Recommendation (+%d%%)\n", margin);
+  printf ("-------------------------------------------\n");
+  printf ("Stack             | Peak    | Size    | Config  | Recommended\n");
+  printf ("-------------------------------------------\n");
+
+  /* Lines of the shell "stack" command: TID SIZE PEAK FREE */
+  while (fgets (line, sizeof (line), fp)) {
+    if (sscanf (line, "%15s %lu %lu", id, &size, &peak) != 3) continue;
+
+    if (strcmp (id, "KERN") == 0) {
+      show_stack_size ("KERN_STK_SIZE", peak, size, 0, margin);
+    } else if (strcmp (id, "0") == 0) {
+      show_stack_size ("IDLE_STK_SIZE", peak, size, 0, margin);
+    } else {
+      found = FALSE;
+      for_each (task, oil_tasks, index) {
+        if (task->id == strtoul (id, NULL, 10)) {
+          found = TRUE;
+          break;
+        }
+      }
+      if (!found) continue;
+      show_stack_size (task->name, peak, size, task->stacksize, margin);
+    }
+  }
+  printf ("-------------------------------------------\n");
+
+  fclose (fp);
+  return 0;
+}
+
 /* vi: set et ai sw=2 sts=2: */
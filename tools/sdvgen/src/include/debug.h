@@ -35,6 +35,7 @@ extern void dump_exp (oil_expiry_point_object_t * exp);
 extern void dump_sched_tbl (oil_sched_tbl_object_t * sched_tbl);
 extern void dump_all_objects (void);
 extern void show_stats (void);
+extern int show_stack_report (const char * report, int margin);
 
 #endif
 
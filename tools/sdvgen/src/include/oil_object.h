@@ -28,6 +28,8 @@
 #define MAX_PRIORITY            (255)
 #define MAX_ACTIVATION          (255)
 #define MAX_STACKSIZE           (UINT_MAX)
+#define MAX_DEADLINE            (INT_MAX)
+#define MAX_TIMESLICE           (0xFFFFFFFF)
 #define MAX_MASK                (0xFF)
 #define MAX_MINCYCLE            (0xFFFFFFFF)
 #define MAX_MAXALLOWEDVALUE     (0xFFFFFFFF)
@@ -36,6 +38,12 @@
 #define MAX_CYCLETIME           (0xFFFFFFFF)
 #define MAX_VECTOR              (UINT_MAX)
 #define MAX_DURATION            (0xFFFF)
+#define MAX_TICKPERIOD_US       (1000000)
+#define MAX_TRACEBUFSIZE        (32768)
+/* Must match WHEEL_SLOT_BITS in src/include/counter.h */
+#define WHEEL_SLOT_BITS         (4)
+#define WHEEL_SLOTS             (1 << WHEEL_SLOT_BITS)
+#define MAX_WHEEL_LEVELS        (32 / WHEEL_SLOT_BITS)
 
 #define ERR_OBJECT              (-1)
 #define ERR_ATTRIBUTE           (-2)
@@ -95,6 +103,34 @@ typedef struct oil_os_object {
   char * board;
   /* Default is FALSE */
   bool shell;
+  /* Default is FALSE */
+  bool tickless;
+  /* Default is FALSE */
+  bool stats;
+  /* Default is FALSE */
+  bool task_stats;
+  /* Default is FALSE */
+  bool latency_hist;
+  /* Default is FALSE */
+  bool syscall_prof;
+  /* Default is FALSE */
+  bool stack_monitor;
+  /* Default is FALSE */
+  bool shared_stack;
+  /* Default is FALSE */
+  bool task_timers;
+  /* Default is FALSE */
+  bool edf_scheduler;
+  /* Default is FALSE */
+  bool cyclic_executive;
+  /* Default is 1000 */
+  uint32_t tick_period_us;
+  /* Achievable tick period in ns, set by update_oil_objects */
+  uint64_t tick_duration_ns;
+  /* Default is FALSE */
+  bool trace;
+  /* Default is 0 (board dependent) */
+  uint32_t trace_buf_size;
 } oil_os_object_t;
 
 typedef struct oil_appmode_object {
@@ -119,6 +155,10 @@ typedef struct oil_task_object {
   uint32_t activation;
   task_schedule_t schedule;
   uint32_t stacksize;
+  /* Default is 0 (none) */
+  uint32_t deadline;
+  /* Default is 0 (no time slicing) */
+  uint32_t timeslice;
   /* Default is FALSE */
   bool autostart;
   oil_object_list_t * appmode;
@@ -133,6 +173,10 @@ typedef struct oil_counter_object {
   uint32_t min_cycle;
   uint32_t max_allowed_value;
   uint32_t ticks_per_base;
+  /* Default is FALSE */
+  bool timing_wheel;
+  /* Number of timing wheel levels, set by builder */
+  uint32_t wheel_levels;
 } oil_counter_object_t;
 
 typedef struct oil_event_object {
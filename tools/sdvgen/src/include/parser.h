@@ -66,6 +66,7 @@ extern bool rflag, tflag, dflag, bflag;
 extern bool mult_task_per_prio, mult_activation;
 extern bool with_sched_tbl, with_sched_tbl_sync;
 extern bool mult_schedtbl_per_cntr;
+extern bool with_timing_wheel;
 extern char * include_path;
 extern char * include_path_list[];
 extern char * sdvos_root;
@@ -104,16 +104,32 @@ extern void sderror (const char *s, int line, ...);
 %token <i> ATTR_BOARD
 %token <i> ATTR_DRIVER
 %token <i> ATTR_SHELL
+%token <i> ATTR_TICKLESS
+%token <i> ATTR_STATS
+%token <i> ATTR_TASKSTATS
+%token <i> ATTR_LATENCYHIST
+%token <i> ATTR_SYSCALLPROF
+%token <i> ATTR_STACKMONITOR
+%token <i> ATTR_SHAREDSTACK
+%token <i> ATTR_TASKTIMERS
+%token <i> ATTR_EDFSCHEDULER
+%token <i> ATTR_CYCLICEXECUTIVE
+%token <i> ATTR_TICKPERIOD_US
+%token <i> ATTR_TRACE
+%token <i> ATTR_TRACEBUFSIZE
 %token <i> ATTR_PRIORITY
 %token <i> ATTR_SCHEDULE
 %token <i> ATTR_ACTIVATION
 %token <i> ATTR_STACKSIZE
+%token <i> ATTR_DEADLINE
+%token <i> ATTR_TIMESLICE
 %token <i> ATTR_AUTOSTART
 %token <i> ATTR_MASK
 %token <i> ATTR_DEFAULT
 %token <i> ATTR_MINCYCLE
 %token <i> ATTR_MAXALLOWEDVALUE
 %token <i> ATTR_TICKSPERBASE
+%token <i> ATTR_TIMINGWHEEL
 %token <i> ATTR_RESOURCEPROPERTY
 %token <i> ATTR_LINKEDRESOURCE
 %token <i> ATTR_ALARMTIME
@@ -177,6 +193,19 @@ obj_name : OS ID {
     oil_os->debuglevel = 2;
     oil_os->board = NULL;
     oil_os->shell = FALSE;
+    oil_os->tickless = FALSE;
+    oil_os->stats = FALSE;
+    oil_os->task_stats = FALSE;
+    oil_os->latency_hist = FALSE;
+    oil_os->syscall_prof = FALSE;
+    oil_os->stack_monitor = FALSE;
+    oil_os->shared_stack = FALSE;
+    oil_os->task_timers = FALSE;
+    oil_os->edf_scheduler = FALSE;
+    oil_os->cyclic_executive = FALSE;
+    oil_os->tick_period_us = 1000;
+    oil_os->trace = FALSE;
+    oil_os->trace_buf_size = 0;
   } else {
     if (strncmp ($2, oil_os->name, strlen (oil_os->name))) {
       yyerror ("Multiple OS object detected!");
@@ -285,16 +314,32 @@ attr_name : oil_obj { $$ = $1; }
           | ATTR_BOARD { $$ = $1; }
           | ATTR_DRIVER { $$ = $1; }
           | ATTR_SHELL { $$ = $1; }
+          | ATTR_TICKLESS { $$ = $1; }
+          | ATTR_STATS { $$ = $1; }
+          | ATTR_TASKSTATS { $$ = $1; }
+          | ATTR_LATENCYHIST { $$ = $1; }
+          | ATTR_SYSCALLPROF { $$ = $1; }
+          | ATTR_STACKMONITOR { $$ = $1; }
+          | ATTR_SHAREDSTACK { $$ = $1; }
+          | ATTR_TASKTIMERS { $$ = $1; }
+          | ATTR_EDFSCHEDULER { $$ = $1; }
+          | ATTR_CYCLICEXECUTIVE { $$ = $1; }
+          | ATTR_TICKPERIOD_US { $$ = $1; }
+          | ATTR_TRACE { $$ = $1; }
+          | ATTR_TRACEBUFSIZE { $$ = $1; }
           | ATTR_PRIORITY { $$ = $1; }
           | ATTR_SCHEDULE { $$ = $1; }
           | ATTR_ACTIVATION { $$ = $1; }
           | ATTR_STACKSIZE { $$ = $1; }
+          | ATTR_DEADLINE { $$ = $1; }
+          | ATTR_TIMESLICE { $$ = $1; }
           | ATTR_AUTOSTART { $$ = $1; }
           | ATTR_MASK { $$ = $1; }
           | ATTR_DEFAULT { $$ = $1; }
           | ATTR_MINCYCLE { $$ = $1; }
           | ATTR_MAXALLOWEDVALUE { $$ = $1; }
           | ATTR_TICKSPERBASE { $$ = $1; }
+          | ATTR_TIMINGWHEEL { $$ = $1; }
           | ATTR_RESOURCEPROPERTY { $$ = $1; }
           | ATTR_LINKEDRESOURCE { $$ = $1; }
           | ATTR_ALARMTIME { $$ = $1; }
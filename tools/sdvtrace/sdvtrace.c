@@ -0,0 +1,566 @@
+/*
+ *                   SDVOS Trace Decoder
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Decode a dump of the SDVOS kernel trace buffer (see
+ * src/include/trace.h) into Chrome trace JSON or CTF. All
+ * supported targets are little endian, so the dump is
+ * decoded byte by byte as little endian.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/* Must match src/include/trace.h */
+#define TRACE_MAGIC            0x54564453UL
+#define TRACE_VERSION          1
+#define TRACE_HEADER_SIZE      16
+#define TRACE_RECORD_SIZE      12
+
+#define TRACE_NONE             0
+#define TRACE_TASK_SWITCH      1
+#define TRACE_ISR_ENTER        2
+#define TRACE_ISR_EXIT         3
+#define TRACE_ALARM            4
+#define TRACE_SCHEDTBL         5
+#define TRACE_RES_GET          6
+#define TRACE_RES_RELEASE      7
+#define TRACE_NUM_TYPES        8
+
+#define TRACE_NO_TASK          0xFFFFFFFFUL
+
+/* Magic number of a CTF packet header */
+#define CTF_MAGIC              0xC1FC1FC1UL
+
+/* Chrome trace thread ids */
+#define TID_TASKS              1
+#define TID_ISRS               2
+#define TID_KERNEL             3
+#define TID_RESOURCES          100
+
+#define MAX_NAMES              256
+#define MAX_NAME_LEN           64
+
+typedef struct record {
+  uint64_t timestamp;
+  uint32_t data;
+  uint16_t id;
+  uint8_t type;
+  uint8_t arg;
+} record_t;
+
+/* Object names read from config/config.h */
+typedef struct name_table {
+  const char * section;
+  const char * fallback;
+  char names[MAX_NAMES][MAX_NAME_LEN];
+} name_table_t;
+
+enum {
+  NAMES_TASK = 0,
+  NAMES_ALARM,
+  NAMES_RESOURCE,
+  NAMES_SCHEDTBL,
+  NUM_NAME_TABLES
+};
+
+static name_table_t name_tables[NUM_NAME_TABLES] = {
+  {"/* Tasks */", "Task", {{0}}},
+  {"/* Alarms */", "Alarm", {{0}}},
+  {"/* Resources */", "Resource", {{0}}},
+  {"/* Schedule Tables */", "ScheduleTable", {{0}}},
+};
+
+static const char * type_names[TRACE_NUM_TYPES] = {
+  "none", "task_switch", "isr_enter", "isr_exit",
+  "alarm", "schedtbl", "res_get", "res_release",
+};
+
+static record_t * records = NULL;
+static uint32_t num_records = 0;
+static uint32_t freq = 0;
+static uint32_t lost = 0;
+
+static uint32_t
+get_le32 (const uint8_t * p)
+{
+  return (uint32_t) p[0] | ((uint32_t) p[1] << 8) |
+         ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint16_t
+get_le16 (const uint8_t * p)
+{
+  return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static void
+put_le (FILE * fp, uint64_t v, int bytes)
+{
+  int i = 0;
+
+  for (i = 0; i < bytes; i++) {
+    fputc ((v >> (i * 8)) & 0xFF, fp);
+  }
+}
+
+static const char *
+get_name (int table, uint32_t id)
+{
+  static char buf[4][MAX_NAME_LEN + 16];
+  static int next = 0;
+  char * ret = buf[next++ & 3];
+
+  if (table == NAMES_TASK && id == TRACE_NO_TASK) return "none";
+  if (id < MAX_NAMES && name_tables[table].names[id][0]) {
+    return name_tables[table].names[id];
+  }
+  if (table == NAMES_TASK && id == 0) return "idle";
+  snprintf (ret, MAX_NAME_LEN + 16, "%s %u",
+            name_tables[table].fallback, id);
+  return ret;
+}
+
+/*
+ * Read object ids from the generated config/config.h. Each
+ * section starts with a comment and lists the objects as
+ * "#define NAME<tab>0xIDU". Counts (NUM_*, MAX_*) are skipped.
+ */
+static bool
+read_names (const char * file)
+{
+  FILE * fp = fopen (file, "r");
+  char line[256], name[MAX_NAME_LEN];
+  unsigned int id = 0;
+  int table = -1, i = 0;
+
+  if (!fp) {
+    fprintf (stderr, "Cannot open %s: %s\n", file, strerror (errno));
+    return false;
+  }
+
+  while (fgets (line, sizeof (line), fp)) {
+    if (strncmp (line, "/*", 2) == 0) {
+      table = -1;
+      for (i = 0; i < NUM_NAME_TABLES; i++) {
+        if (strncmp (line, name_tables[i].section,
+                     strlen (name_tables[i].section)) == 0) {
+          table = i;
+        }
+      }
+      continue;
+    }
+    if (table < 0) continue;
+    if (sscanf (line, "#define %63s %x", name, &id) != 2) continue;
+    if (strncmp (name, "NUM_", 4) == 0 ||
+        strncmp (name, "MAX_", 4) == 0) continue;
+    if (id < MAX_NAMES) {
+      strcpy (name_tables[table].names[id], name);
+    }
+  }
+
+  fclose (fp);
+  return true;
+}
+
+/*
+ * Load a dump and put the valid records in the order they
+ * were written. 32-bit timestamps are extended to 64 bits
+ * assuming consecutive records are less than half of the
+ * counter range apart. Records can be slightly out of order
+ * when an ISR preempts TraceRecord, hence the signed delta.
+ */
+static bool
+read_dump (const char * file)
+{
+  FILE * fp = fopen (file, "rb");
+  uint8_t header[TRACE_HEADER_SIZE], * buf = NULL;
+  uint32_t size = 0, head = 0, first = 0, i = 0, ts = 0, prev = 0;
+  uint64_t now = 0;
+  const uint8_t * p = NULL;
+
+  if (!fp) {
+    fprintf (stderr, "Cannot open %s: %s\n", file, strerror (errno));
+    return false;
+  }
+
+  if (fread (header, sizeof (header), 1, fp) != 1 ||
+      get_le32 (header) != TRACE_MAGIC) {
+    fprintf (stderr, "%s is not an SDVOS trace dump!\n", file);
+    goto err;
+  }
+  if (get_le16 (header + 4) != TRACE_VERSION) {
+    fprintf (stderr, "Unsupported trace version %u!\n",
+             get_le16 (header + 4));
+    goto err;
+  }
+  size = get_le16 (header + 6);
+  freq = get_le32 (header + 8);
+  head = get_le32 (header + 12);
+  if (!size || !freq) {
+    fprintf (stderr, "Trace was not initialized!\n");
+    goto err;
+  }
+
+  buf = malloc (size * TRACE_RECORD_SIZE);
+  records = malloc (size * sizeof (record_t));
+  if (!buf || !records) {
+    fprintf (stderr, "Out of memory!\n");
+    goto err;
+  }
+  if (fread (buf, TRACE_RECORD_SIZE, size, fp) != size) {
+    fprintf (stderr, "%s is truncated!\n", file);
+    goto err;
+  }
+
+  if (head > size) {
+    first = head - size;
+    lost = first;
+  }
+
+  for (i = first; i != head; i++) {
+    p = buf + (i & (size - 1)) * TRACE_RECORD_SIZE;
+    if (p[10] == TRACE_NONE || p[10] >= TRACE_NUM_TYPES) continue;
+    ts = get_le32 (p);
+    if (num_records == 0) {
+      now = ts;
+    } else {
+      now += (int64_t) (int32_t) (ts - prev);
+    }
+    prev = ts;
+    records[num_records].timestamp = now;
+    records[num_records].data = get_le32 (p + 4);
+    records[num_records].id = get_le16 (p + 8);
+    records[num_records].type = p[10];
+    records[num_records].arg = p[11];
+    num_records++;
+  }
+
+  free (buf);
+  fclose (fp);
+  return true;
+
+err:
+  free (buf);
+  fclose (fp);
+  return false;
+}
+
+/* Microseconds since the first record */
+static double
+to_us (uint64_t timestamp)
+{
+  return (double) (timestamp - records[0].timestamp) *
+         1000000.0 / freq;
+}
+
+static const char *
+isr_name (uint32_t vector)
+{
+  static char buf[32];
+
+  /* Signal numbers on Linux, handler addresses otherwise */
+  if (vector < 256) {
+    snprintf (buf, sizeof (buf), "ISR %u", vector);
+  } else {
+    snprintf (buf, sizeof (buf), "ISR 0x%x", vector);
+  }
+  return buf;
+}
+
+static void
+chrome_thread (FILE * fp, int tid, const char * name, bool * first)
+{
+  fprintf (fp, "%s\n    {\"name\": \"thread_name\", \"ph\": \"M\", "
+           "\"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+           *first ? "" : ",", tid, name);
+  *first = false;
+}
+
+static void
+write_chrome (FILE * fp)
+{
+  uint32_t i = 0, task = TRACE_NO_TASK;
+  uint64_t task_start = 0;
+  bool first = true, res_seen[MAX_NAMES] = {false};
+  record_t * r = NULL;
+
+  fprintf (fp, "{\n  \"displayTimeUnit\": \"ns\",\n");
+  fprintf (fp, "  \"otherData\": {\"freq\": %u, \"lost\": %u},\n",
+           freq, lost);
+  fprintf (fp, "  \"traceEvents\": [");
+
+  chrome_thread (fp, TID_TASKS, "Tasks", &first);
+  chrome_thread (fp, TID_ISRS, "ISRs", &first);
+  chrome_thread (fp, TID_KERNEL, "Kernel", &first);
+
+  for (i = 0; i < num_records; i++) {
+    r = &records[i];
+    switch (r->type) {
+      case TRACE_TASK_SWITCH :
+        /* Close the slice of the task switched out */
+        if (task != TRACE_NO_TASK) {
+          fprintf (fp, ",\n    {\"name\": \"%s\", \"cat\": \"task\", "
+                   "\"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                   "\"pid\": 0, \"tid\": %d}",
+                   get_name (NAMES_TASK, task), to_us (task_start),
+                   to_us (r->timestamp) - to_us (task_start),
+                   TID_TASKS);
+        }
+        task = r->id;
+        task_start = r->timestamp;
+        break;
+      case TRACE_ISR_ENTER :
+      case TRACE_ISR_EXIT :
+        fprintf (fp, ",\n    {\"name\": \"%s\", \"cat\": \"isr\", "
+                 "\"ph\": \"%s\", \"ts\": %.3f, \"pid\": 0, "
+                 "\"tid\": %d, \"args\": {\"category\": %u}}",
+                 isr_name (r->data),
+                 (r->type == TRACE_ISR_ENTER) ? "B" : "E",
+                 to_us (r->timestamp), TID_ISRS, r->arg);
+        break;
+      case TRACE_ALARM :
+        fprintf (fp, ",\n    {\"name\": \"%s\", \"cat\": \"alarm\", "
+                 "\"ph\": \"i\", \"s\": \"t\", \"ts\": %.3f, "
+                 "\"pid\": 0, \"tid\": %d, \"args\": {\"count\": %u}}",
+                 get_name (NAMES_ALARM, r->id), to_us (r->timestamp),
+                 TID_KERNEL, r->data);
+        break;
+      case TRACE_SCHEDTBL :
+        fprintf (fp, ",\n    {\"name\": \"%s\", \"cat\": \"schedtbl\", "
+                 "\"ph\": \"i\", \"s\": \"t\", \"ts\": %.3f, "
+                 "\"pid\": 0, \"tid\": %d, "
+                 "\"args\": {\"expiry_point\": %u}}",
+                 get_name (NAMES_SCHEDTBL, r->id), to_us (r->timestamp),
+                 TID_KERNEL, r->data);
+        break;
+      case TRACE_RES_GET :
+      case TRACE_RES_RELEASE :
+        /* One track per resource, held from get to release */
+        if (r->id < MAX_NAMES && !res_seen[r->id]) {
+          res_seen[r->id] = true;
+          chrome_thread (fp, TID_RESOURCES + r->id,
+                         get_name (NAMES_RESOURCE, r->id), &first);
+        }
+        fprintf (fp, ",\n    {\"name\": \"%s\", \"cat\": \"resource\", "
+                 "\"ph\": \"%s\", \"ts\": %.3f, \"pid\": 0, "
+                 "\"tid\": %d}",
+                 get_name (NAMES_TASK, r->data),
+                 (r->type == TRACE_RES_GET) ? "B" : "E",
+                 to_us (r->timestamp), TID_RESOURCES + r->id);
+        break;
+    }
+  }
+
+  /* The task still running at the end of the trace */
+  if (task != TRACE_NO_TASK && num_records) {
+    fprintf (fp, ",\n    {\"name\": \"%s\", \"cat\": \"task\", "
+             "\"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+             "\"pid\": 0, \"tid\": %d}",
+             get_name (NAMES_TASK, task), to_us (task_start),
+             to_us (records[num_records - 1].timestamp) -
+             to_us (task_start), TID_TASKS);
+  }
+
+  fprintf (fp, "\n  ]\n}\n");
+}
+
+/*
+ * Write a CTF 1.8 trace: a TSDL metadata file and a single
+ * stream made of one packet. Event ids are the trace types.
+ */
+static bool
+write_ctf (const char * dir)
+{
+  char path[4096];
+  FILE * fp = NULL;
+  uint32_t i = 0;
+
+  if (mkdir (dir, 0755) < 0 && errno != EEXIST) {
+    fprintf (stderr, "Cannot create %s: %s\n", dir, strerror (errno));
+    return false;
+  }
+
+  snprintf (path, sizeof (path), "%s/metadata", dir);
+  if (!(fp = fopen (path, "w"))) {
+    fprintf (stderr, "Cannot open %s: %s\n", path, strerror (errno));
+    return false;
+  }
+  fprintf (fp,
+    "/* CTF 1.8 */\n\n"
+    "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n"
+    "typealias integer { size = 16; align = 8; signed = false; } := uint16_t;\n"
+    "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+    "\n"
+    "trace {\n"
+    "  major = 1;\n"
+    "  minor = 8;\n"
+    "  byte_order = le;\n"
+    "  packet.header := struct {\n"
+    "    uint32_t magic;\n"
+    "  };\n"
+    "};\n\n"
+    "clock {\n"
+    "  name = cycles;\n"
+    "  freq = %u;\n"
+    "};\n\n"
+    "typealias integer {\n"
+    "  size = 64; align = 8; signed = false;\n"
+    "  map = clock.cycles.value;\n"
+    "} := cycles_t;\n\n"
+    "stream {\n"
+    "  event.header := struct {\n"
+    "    uint8_t id;\n"
+    "    cycles_t timestamp;\n"
+    "  };\n"
+    "};\n\n", freq);
+  fprintf (fp,
+    "event {\n  name = \"%s\";\n  id = %d;\n  fields := struct {\n"
+    "    uint16_t next_task;\n    uint8_t flag;\n    uint32_t prev_task;\n"
+    "  };\n};\n\n", type_names[TRACE_TASK_SWITCH], TRACE_TASK_SWITCH);
+  fprintf (fp,
+    "event {\n  name = \"%s\";\n  id = %d;\n  fields := struct {\n"
+    "    uint16_t unused;\n    uint8_t category;\n    uint32_t vector;\n"
+    "  };\n};\n\n", type_names[TRACE_ISR_ENTER], TRACE_ISR_ENTER);
+  fprintf (fp,
+    "event {\n  name = \"%s\";\n  id = %d;\n  fields := struct {\n"
+    "    uint16_t unused;\n    uint8_t category;\n    uint32_t vector;\n"
+    "  };\n};\n\n", type_names[TRACE_ISR_EXIT], TRACE_ISR_EXIT);
+  fprintf (fp,
+    "event {\n  name = \"%s\";\n  id = %d;\n  fields := struct {\n"
+    "    uint16_t alarm;\n    uint8_t unused;\n    uint32_t count;\n"
+    "  };\n};\n\n", type_names[TRACE_ALARM], TRACE_ALARM);
+  fprintf (fp,
+    "event {\n  name = \"%s\";\n  id = %d;\n  fields := struct {\n"
+    "    uint16_t table;\n    uint8_t unused;\n    uint32_t expiry_point;\n"
+    "  };\n};\n\n", type_names[TRACE_SCHEDTBL], TRACE_SCHEDTBL);
+  fprintf (fp,
+    "event {\n  name = \"%s\";\n  id = %d;\n  fields := struct {\n"
+    "    uint16_t resource;\n    uint8_t unused;\n    uint32_t task;\n"
+    "  };\n};\n\n", type_names[TRACE_RES_GET], TRACE_RES_GET);
+  fprintf (fp,
+    "event {\n  name = \"%s\";\n  id = %d;\n  fields := struct {\n"
+    "    uint16_t resource;\n    uint8_t unused;\n    uint32_t task;\n"
+    "  };\n};\n", type_names[TRACE_RES_RELEASE], TRACE_RES_RELEASE);
+  fclose (fp);
+
+  snprintf (path, sizeof (path), "%s/stream", dir);
+  if (!(fp = fopen (path, "wb"))) {
+    fprintf (stderr, "Cannot open %s: %s\n", path, strerror (errno));
+    return false;
+  }
+  put_le (fp, CTF_MAGIC, 4);
+  for (i = 0; i < num_records; i++) {
+    put_le (fp, records[i].type, 1);
+    put_le (fp, records[i].timestamp, 8);
+    put_le (fp, records[i].id, 2);
+    put_le (fp, records[i].arg, 1);
+    put_le (fp, records[i].data, 4);
+  }
+  fclose (fp);
+
+  return true;
+}
+
+static void
+print_help (const char * prog)
+{
+  printf ("Usage: %s [options] dump\n\n", prog);
+  printf ("Decode an SDVOS kernel trace dump.\n\n");
+  printf ("Options:\n");
+  printf ("  -c config.h  Take object names from the generated "
+          "config/config.h\n");
+  printf ("  -f format    Output format: chrome (default) or ctf\n");
+  printf ("  -o output    Output file (chrome, default stdout) or "
+          "directory (ctf)\n");
+  printf ("  -h           Show this help\n");
+}
+
+int
+main (int argc, char * argv[])
+{
+  const char * format = "chrome", * output = NULL;
+  FILE * fp = stdout;
+  int c = 0;
+
+  opterr = 0;
+  while ((c = getopt (argc, argv, "c:f:o:h")) != -1) {
+    switch (c) {
+      case 'c':
+        if (!read_names (optarg)) exit (1);
+        break;
+      case 'f':
+        format = optarg;
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'h':
+        print_help (argv[0]);
+        exit (0);
+      case '?':
+        if (optopt == 'c' || optopt == 'f' || optopt == 'o') {
+          fprintf (stderr, "Option -%c requires argument!\n", optopt);
+        } else {
+          fprintf (stderr, "Unknown option: -%c!\n", optopt);
+        }
+        print_help (argv[0]);
+        exit (1);
+    }
+  }
+
+  if (optind >= argc) {
+    fprintf (stderr, "Trace dump not specified!\n");
+    print_help (argv[0]);
+    exit (1);
+  }
+
+  if (!read_dump (argv[optind])) exit (1);
+  if (lost) {
+    fprintf (stderr, "%u records overwritten before the dump\n", lost);
+  }
+
+  if (strcmp (format, "ctf") == 0) {
+    if (!output) {
+      fprintf (stderr, "CTF output needs a directory (-o)!\n");
+      exit (1);
+    }
+    if (!write_ctf (output)) exit (1);
+  } else if (strcmp (format, "chrome") == 0) {
+    if (output && !(fp = fopen (output, "w"))) {
+      fprintf (stderr, "Cannot open %s: %s\n", output, strerror (errno));
+      exit (1);
+    }
+    write_chrome (fp);
+    if (fp != stdout) fclose (fp);
+  } else {
+    fprintf (stderr, "Unknown output format: %s!\n", format);
+    exit (1);
+  }
+
+  return 0;
+}
+
+/* vi: set et ai sw=2 sts=2: */
@@ -0,0 +1,89 @@
+/*
+ * Host configuration of the kernel objects exercised by
+ * ticktest. It follows the layout of the config.h files
+ * generated by sdvgen, but the counter properties and the
+ * schedule table expiry points are set up by the test.
+ */
+
+#ifndef _CONFIG_CONFIG_H_
+#define _CONFIG_CONFIG_H_
+
+/* Tasks */
+#define NUM_TASKS	0x4U
+#define MAX_PRIO	0x1U
+
+/* AppModes */
+#define AppMode0	0x0U
+
+/* Counters */
+#define C0	0x0U
+#define SYS_COUNTER	0x1U
+/* System counter constants */
+#define OSMAXALLOWEDVALUE	0xFFFF
+#define OSTICKSPERBASE	0x1
+#define OSMINCYCLE	0x1
+
+#define NUM_COUNTERS	0x2U
+
+/* Alarms */
+#define A0	0x0U
+#define A1	0x1U
+#define A2	0x2U
+#define A3	0x3U
+#define NUM_ALARMS	0x4U
+
+/* Resources */
+#define NUM_RESOURCES	0x0U
+
+/* Events */
+#define NUM_EVENTS	0x0U
+
+/* ISRs */
+#define NUM_ISR1	0x0U
+#define NUM_ISR2	0x0U
+
+/* Schedule Tables */
+#define T0	0x0U
+#define NUM_SCHED_TBLS	0x1U
+#define NUM_AUTOSTART_SCHED_TBLS	0x0U
+
+/* Drivers */
+#define NUM_DRIVERS	0x0U
+
+/* Hook routine configuration */
+#define HAS_STARTUPHOOK	0x0U
+#define HAS_ERRORHOOK	0x0U
+#define HAS_SHUTDOWNHOOK	0x0U
+#define HAS_PRETASKHOOK	0x0U
+#define HAS_POSTTASKHOOK	0x0U
+#define USEGETSERVICEID	0x0U
+#define USEPARAMETERACCESS	0x0U
+
+#define USERESSCHEDULER	0x0U
+
+#ifndef __ASSEMBLER__
+
+#include <arch/linux/types.h>
+
+/* Type for number of activations for tasks */
+typedef uint8_t ActivationNumType;
+/* Type for priority */
+typedef uint8_t PrioType;
+/* Type for event mask (8-bit minimum) */
+typedef uint8_t event_mask_t;
+/* Type for alarm ID. Limits max alarm supported. */
+typedef uint8_t alarm_t;
+/* Type for IRQ numbers */
+typedef uint8_t IRQType;
+/* Type for IRQ priorities */
+typedef uint8_t IRQPrioType;
+/* Type for counters */
+typedef uint8_t CounterType;
+/* Type for resources */
+typedef uint8_t ResourceType;
+/* Type for schedule tables */
+typedef uint8_t sched_tbl_t;
+
+#endif /* __ASSEMBLER__ */
+
+#endif
@@ -0,0 +1,591 @@
+/*
+ *                  SDVOS Counter Time Test
+ *
+ * Copyright (C) 2015 Ye Li (liye@sdvos.org)
+ *
+ * This program is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Host test of the counter time of the kernel (see TICK_WINDOW
+ * in src/include/counter.h). src/alarm.c and src/schedtbl.c
+ * are compiled for the host and driven through their kernel
+ * services, with the counter time preset just before the
+ * point where it wraps around. Alarm expirations, schedule
+ * table expiry points, GetAlarm and GetCounterValue are
+ * compared with a model which keeps absolute time in 64 bits
+ * and never wraps. A few fixed scenarios check interleavings
+ * of alarm actions the model does not cover.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sdvos.h>
+#include <osek/osek.h>
+#include <autosar/autosar.h>
+#include <config/config.h>
+
+/* Expiry points of the schedule table at most */
+#define MAX_EPS                3
+/* Fired alarms or expiry points logged per service call */
+#define MAX_LOG                4096
+/* Operations of a scenario */
+#define NUM_OPS                80
+
+/* Kernel objects, normally generated by sdvgen */
+Counter counters[NUM_COUNTERS];
+AlarmQueueType alarms[NUM_ALARMS + NUM_TASK_TIMERS];
+AlarmType auto_alarms[1][NUM_ALARMS];
+ScheduleTableStructType schedtbls[NUM_SCHED_TBLS];
+static ExpiryPointType eps[MAX_EPS];
+static const TaskType ep_tasks[MAX_EPS] = {0, 1, 2};
+
+/* Alarms and expiry points in the order they fired */
+typedef struct log {
+  int ids[MAX_LOG];
+  int num;
+} Log;
+
+static Log kern_alarms, kern_eps;
+static Log model_alarms, model_eps;
+
+/* Alarm of the model */
+typedef struct model_alarm {
+  bool active;
+  uint64_t exp;              /* Absolute expiration */
+  uint64_t cycle;
+  uint64_t seq;              /* Order of (re)arming */
+} ModelAlarm;
+
+/* Model of counter C0 with its alarms and schedule table */
+static struct {
+  uint64_t max;
+  uint64_t tpb;
+  uint64_t c0;               /* Count at time 0 */
+  uint64_t now;              /* Absolute time in ticks */
+  uint64_t seq;
+  ModelAlarm alm[NUM_ALARMS];
+  /* Schedule table */
+  uint64_t offsets[MAX_EPS];
+  uint64_t duration;
+  unsigned num_eps;
+  bool running;
+  uint64_t base;             /* Absolute start of the round */
+  unsigned next_ep;
+} model;
+
+/* Current scenario, printed on failure */
+static const char * scenario = "";
+static unsigned long num_scenarios = 0, num_ops = 0;
+static uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+static void
+LogAdd (Log * log, int id)
+{
+  if (log->num < MAX_LOG) log->ids[log->num] = id;
+  log->num++;
+}
+
+/* Kernel stubs */
+static void Callback0 (void) { LogAdd (&kern_alarms, 0); }
+static void Callback1 (void) { LogAdd (&kern_alarms, 1); }
+static void Callback2 (void) { LogAdd (&kern_alarms, 2); }
+static void Callback3 (void) { LogAdd (&kern_alarms, 3); }
+
+static void (* const callbacks[NUM_ALARMS]) (void) = {
+  Callback0, Callback1, Callback2, Callback3
+};
+
+StatusType
+DoActivateTaskSet (TaskSetRefType set)
+{
+  LogAdd (&kern_eps, set->tasks[0]);
+  return E_OK;
+}
+
+void
+DoSetEventList (const ExpiryPointEventList * events,
+                udata_word_t num)
+{
+}
+
+StatusType
+Sys_ActivateTask (TaskType tid)
+{
+  return E_OK;
+}
+
+/* Releases a waiting task, as DoSetEvent in event.c */
+StatusType
+Sys_SetEvent (TaskType tid, EventMaskType mask)
+{
+  StopTaskTimer (tid);
+  return E_OK;
+}
+
+void
+TaskTimeout (TaskType tid)
+{
+}
+
+AppModeType
+Sys_GetActiveApplicationMode (void)
+{
+  return AppMode0;
+}
+
+void
+CheckPreemption (FlagType flag)
+{
+}
+
+void
+ArchTimerInit (void)
+{
+}
+
+void
+panic (void)
+{
+  fprintf (stderr, "kernel panic\n");
+  abort ();
+}
+
+static uint64_t
+Random (uint64_t range)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return rng % range;
+}
+
+/* Random value in [lo, hi] */
+static uint64_t
+RandomIn (uint64_t lo, uint64_t hi)
+{
+  return lo + Random (hi - lo + 1);
+}
+
+static void
+Fail (const char * what, uint64_t got, uint64_t expect)
+{
+  fprintf (stderr, "FAIL %s: %s got %llu expect %llu (op %lu)\n",
+           scenario, what, (unsigned long long) got,
+           (unsigned long long) expect, num_ops);
+  exit (1);
+}
+
+static uint64_t
+ModelCount (void)
+{
+  return (model.c0 + model.now) % (model.max + 1);
+}
+
+/* Ticks from now to the next time the count equals value */
+static uint64_t
+ModelAbs (uint64_t value)
+{
+  uint64_t count = ModelCount ();
+
+  if (value > count) return value - count;
+  return (model.max - count) + value + 1;
+}
+
+static void
+ModelArm (AlarmType id, uint64_t exp, uint64_t cycle)
+{
+  model.alm[id].active = TRUE;
+  model.alm[id].exp = exp;
+  model.alm[id].cycle = cycle;
+  model.alm[id].seq = model.seq++;
+}
+
+/* Move the model forward by a number of counter updates */
+static void
+ModelAdvance (uint64_t updates)
+{
+  uint64_t target = model.now + updates * model.tpb;
+  ModelAlarm * first = NULL;
+  int i = 0;
+
+  for (;;) {
+    first = NULL;
+    for (i = 0; i < NUM_ALARMS; i++) {
+      ModelAlarm * alm = &model.alm[i];
+      if (!alm->active || alm->exp > target) continue;
+      if (!first || alm->exp < first->exp ||
+          (alm->exp == first->exp && alm->seq < first->seq)) {
+        first = alm;
+      }
+    }
+    if (!first) break;
+    LogAdd (&model_alarms, first - model.alm);
+    if (first->cycle) {
+      ModelArm (first - model.alm, first->exp + first->cycle,
+                first->cycle);
+    } else {
+      first->active = FALSE;
+    }
+  }
+
+  while (model.running &&
+         model.base + model.offsets[model.next_ep] <= target) {
+    LogAdd (&model_eps, model.next_ep);
+    if (++model.next_ep == model.num_eps) {
+      model.next_ep = 0;
+      model.base += model.duration;
+    }
+  }
+
+  model.now = target;
+}
+
+static void
+CompareLogs (const char * what, Log * kern, Log * mdl)
+{
+  int i = 0;
+
+  if (kern->num != mdl->num) Fail (what, kern->num, mdl->num);
+  for (i = 0; i < kern->num && i < MAX_LOG; i++) {
+    if (kern->ids[i] != mdl->ids[i])
+      Fail (what, kern->ids[i], mdl->ids[i]);
+  }
+  kern->num = mdl->num = 0;
+}
+
+/* Compare everything observable of kernel and model */
+static void
+Compare (void)
+{
+  ScheduleTableStatusType status = SCHEDULETABLE_STOPPED;
+  TickType value = 0;
+  AlarmType i = 0;
+
+  CompareLogs ("alarms", &kern_alarms, &model_alarms);
+  CompareLogs ("expiry points", &kern_eps, &model_eps);
+
+  Sys_GetCounterValue (C0, &value);
+  if (value != ModelCount ()) Fail ("count", value, ModelCount ());
+
+  for (i = 0; i < NUM_ALARMS; i++) {
+    if (Sys_GetAlarm (i, &value) == E_OK) {
+      if (!model.alm[i].active) Fail ("alarm active", 1, 0);
+      /* A full TickType cycle reads back as 0 */
+      if (value != (TickType) (model.alm[i].exp - model.now))
+        Fail ("GetAlarm", value,
+              (TickType) (model.alm[i].exp - model.now));
+    } else if (model.alm[i].active) {
+      Fail ("alarm active", 0, 1);
+    }
+  }
+
+  Sys_GetScheduleTableStatus (T0, &status);
+  if ((status != SCHEDULETABLE_STOPPED) != model.running)
+    Fail ("schedule table running", status, model.running);
+}
+
+/*
+ * Check TickPos and TickDue of counter time ticks around
+ * the first and the last tick of the counter window.
+ */
+static void
+CheckWindow (CounterTimeType ticks)
+{
+  Counter * counter = &counters[C0];
+  CounterTimeType w = TICK_WINDOW;
+
+  scenario = "window";
+  counter->ticks = ticks;
+
+  if (!TickDue (counter, ticks)) Fail ("TickDue now", 0, 1);
+  if (!TickDue (counter, (CounterTimeType) (ticks - 1)))
+    Fail ("TickDue behind", 0, 1);
+  if (!TickDue (counter, (CounterTimeType) (ticks - (w - 1))))
+    Fail ("TickDue window start", 0, 1);
+  if (TickDue (counter, (CounterTimeType) (ticks + 1)))
+    Fail ("TickDue ahead", 1, 0);
+  if (TickDue (counter, (CounterTimeType) (ticks + w)))
+    Fail ("TickDue window end", 1, 0);
+
+  if (TickPos (counter, (CounterTimeType) (ticks - (w - 1))) != 0)
+    Fail ("TickPos window start",
+          TickPos (counter, (CounterTimeType) (ticks - (w - 1))), 0);
+  if (TickPos (counter, ticks) != w - 1)
+    Fail ("TickPos now", TickPos (counter, ticks), w - 1);
+  if (TickPos (counter, (CounterTimeType) (ticks + w)) !=
+      (CounterTimeType) ~0ULL)
+    Fail ("TickPos window end",
+          TickPos (counter, (CounterTimeType) (ticks + w)),
+          (CounterTimeType) ~0ULL);
+  if (TickPos (counter, (CounterTimeType) (ticks + 1)) <=
+      TickPos (counter, ticks))
+    Fail ("TickPos order", 0, 1);
+}
+
+/* Reset kernel and model for a scenario */
+static void
+Setup (uint64_t max, uint64_t tpb, uint64_t c0, uint64_t wrap)
+{
+  Counter * counter = &counters[C0];
+  ScheduleTableStructType * tbl = &schedtbls[T0];
+  uint64_t gap = 0;
+  AlarmType i = 0;
+  unsigned n = 0;
+
+  memset (counters, 0, sizeof (counters));
+  memset (alarms, 0, sizeof (alarms));
+  memset (schedtbls, 0, sizeof (schedtbls));
+  memset (&model, 0, sizeof (model));
+
+  counter->count = c0;
+  counter->properties.maxallowedvalue = max;
+  counter->properties.ticksperbase = tpb;
+  counter->properties.mincycle = 1;
+  /* Counter time wraps around after wrap ticks */
+  counter->ticks = (CounterTimeType) (0 - wrap);
+  counter->next_tick = counter->ticks;
+
+  for (i = 0; i < NUM_ALARMS; i++) {
+    alarms[i].id = i;
+    alarms[i].counter = counter;
+    alarms[i].action.callback = callbacks[i];
+    alarms[i].action.type = ALARM_ACTION_CALLBACK;
+  }
+
+  /*
+   * Repeating schedule table. Its events are at least
+   * ticksperbase ticks apart, so that each counter update
+   * processes at most one of them.
+   */
+  model.num_eps = RandomIn (1, MAX_EPS);
+  model.offsets[0] = Random (2) ? 0 : tpb;
+  for (n = 1; n < model.num_eps; n++) {
+    gap = RandomIn (tpb, tpb + max / 4);
+    model.offsets[n] = model.offsets[n - 1] + gap;
+  }
+  model.duration = model.offsets[model.num_eps - 1] +
+                   RandomIn (tpb, tpb + max / 4);
+  if (model.duration > max) {
+    model.num_eps = 1;
+    model.offsets[0] = 0;
+    model.duration = RandomIn (tpb, max);
+  }
+  for (n = 0; n < model.num_eps; n++) {
+    eps[n].offset = model.offsets[n];
+    eps[n].tasks.tasks = &ep_tasks[n];
+    eps[n].tasks.num_tasks = 1;
+  }
+  tbl->id = T0;
+  tbl->counter = counter;
+  tbl->status = SCHEDULETABLE_STOPPED;
+  tbl->flag = SCHEDULETABLE_REPEATING;
+  tbl->exps = eps;
+  tbl->num_exps = model.num_eps;
+  tbl->next_exp = INVALID_EP;
+  tbl->delay = model.duration - model.offsets[model.num_eps - 1];
+
+  model.max = max;
+  model.tpb = tpb;
+  model.c0 = c0;
+
+  num_scenarios++;
+}
+
+/* Largest number of counter updates for IncrementCounterBy */
+static uint64_t
+MaxUpdates (void)
+{
+  uint64_t updates = 3 * (model.max / model.tpb) + 2;
+
+  return (updates > (TickType) ~0UL) ? (TickType) ~0UL : updates;
+}
+
+/* Random cycle, not too short on large counters */
+static uint64_t
+RandomCycle (void)
+{
+  if (Random (3) == 0) return 0;
+  return RandomIn ((model.max > 64) ? model.max / 8 : 1, model.max);
+}
+
+static void
+RunOp (void)
+{
+  AlarmType id = Random (NUM_ALARMS);
+  uint64_t a = 0, b = 0;
+  StatusType ret = E_OK;
+
+  switch (Random (10)) {
+    case 0: case 1: case 2:
+      ret = Sys_IncrementCounter (C0);
+      ModelAdvance (1);
+      break;
+    case 3: case 4:
+      a = RandomIn (1, MaxUpdates ());
+      ret = Sys_IncrementCounterBy (C0, a);
+      ModelAdvance (a);
+      break;
+    case 5:
+      if (model.alm[id].active) return;
+      a = RandomIn (1, model.max);
+      b = RandomCycle ();
+      ret = Sys_SetRelAlarm (id, a, b);
+      ModelArm (id, model.now + a, b);
+      break;
+    case 6:
+      if (model.alm[id].active) return;
+      /* Sometimes a full counter cycle ahead */
+      a = Random (4) ? RandomIn (0, model.max) : ModelCount ();
+      b = RandomCycle ();
+      ret = Sys_SetAbsAlarm (id, a, b);
+      ModelArm (id, model.now + ModelAbs (a), b);
+      break;
+    case 7:
+      if (!model.alm[id].active) return;
+      ret = Sys_CancelAlarm (id);
+      model.alm[id].active = FALSE;
+      break;
+    case 8:
+      if (model.running) {
+        ret = Sys_StopScheduleTable (T0);
+        model.running = FALSE;
+      } else if (Random (2)) {
+        if (model.max <= model.offsets[0]) return;
+        a = RandomIn (1, model.max - model.offsets[0]);
+        ret = Sys_StartScheduleTableRel (T0, a);
+        model.running = TRUE;
+        model.base = model.now + a;
+        model.next_ep = 0;
+      } else {
+        a = RandomIn (0, model.max);
+        ret = Sys_StartScheduleTableAbs (T0, a);
+        model.running = TRUE;
+        model.base = model.now + ModelAbs (a);
+        model.next_ep = 0;
+      }
+      break;
+    default:
+      /* Let the counter run to the next event */
+      a = RandomIn (1, (model.max / model.tpb) + 1);
+      ret = Sys_IncrementCounterBy (C0, a);
+      ModelAdvance (a);
+      break;
+  }
+
+  num_ops++;
+  if (ret != E_OK) Fail ("status", ret, E_OK);
+  Compare ();
+}
+
+static void
+RunScenario (uint64_t max, uint64_t tpb, uint64_t c0, uint64_t wrap)
+{
+  static char name[128];
+  int i = 0;
+
+  snprintf (name, sizeof (name), "max=0x%llX tpb=%llu c0=%llu "
+            "wrap=%llu", (unsigned long long) max,
+            (unsigned long long) tpb, (unsigned long long) c0,
+            (unsigned long long) wrap);
+  scenario = name;
+
+  Setup (max, tpb, c0, wrap);
+  for (i = 0; i < NUM_OPS; i++) RunOp ();
+}
+
+/*
+ * An alarm setting an event stops the timer of the task it
+ * releases, while the timer expires in the same queue node.
+ * The alarms behind the timer must still expire.
+ */
+static void
+CheckNodeRemoval (void)
+{
+  TickType value = 0;
+
+  Setup (8, 1, 0, 1);
+  scenario = "stopped timer in expiring node";
+  alarms[A0].action.type = ALARM_ACTION_SETEVENT;
+  alarms[A0].action.task = 1;
+  alarms[A0].action.event = 1;
+  Sys_SetRelAlarm (A0, 2, 0);
+  StartTaskTimer (1, C0, 2);
+  Sys_SetRelAlarm (A1, 2, 0);
+  Sys_IncrementCounterBy (C0, 2);
+
+  if (kern_alarms.num != 1 || kern_alarms.ids[0] != A1)
+    Fail ("alarms fired", kern_alarms.num, 1);
+  if (AlarmIsActive (TaskTimer (1))) Fail ("timer active", 1, 0);
+  if (Sys_GetAlarm (A1, &value) != E_OS_NOFUNC)
+    Fail ("GetAlarm", E_OK, E_OS_NOFUNC);
+  if (Sys_SetRelAlarm (A1, 1, 0) != E_OK)
+    Fail ("SetRelAlarm", E_OS_STATE, E_OK);
+  kern_alarms.num = 0;
+}
+
+int
+main (int argc, char * argv[])
+{
+  static const uint64_t wraps[] = {0, 1, 2, 3, 5, 8, 13, 64};
+  /* Largest maxallowedvalue accepted by sdvgen */
+#ifdef WIDE_COUNTER_TIME
+  const uint64_t limit = (TickType) ~0UL;
+#else
+  const uint64_t limit = TICK_WINDOW - 1;
+#endif
+  const uint64_t large[] = {1000, 0xFFFF, limit / 2, limit};
+  const uint64_t tpbs[] = {1, 7, 1000};
+  uint64_t max = 0, tpb = 0, c0 = 0;
+  unsigned w = 0, i = 0, j = 0;
+
+  CheckWindow (0);
+  CheckWindow (1);
+  CheckWindow ((CounterTimeType) ~0ULL);
+  CheckWindow (TICK_WINDOW - 1);
+  CheckWindow (TICK_WINDOW);
+  CheckNodeRemoval ();
+
+  /* Every small counter from every start count */
+  for (max = 1; max <= 8; max++) {
+    for (tpb = 1; tpb <= max; tpb++) {
+      for (c0 = 0; c0 <= max; c0++) {
+        for (w = 0; w < sizeof (wraps) / sizeof (wraps[0]); w++) {
+          RunScenario (max, tpb, c0, wraps[w]);
+        }
+      }
+    }
+  }
+
+  /* Counters up to the full range allowed */
+  for (i = 0; i < sizeof (large) / sizeof (large[0]); i++) {
+    for (j = 0; j < sizeof (tpbs) / sizeof (tpbs[0]); j++) {
+      max = large[i];
+      tpb = tpbs[j];
+      RunScenario (max, tpb, 0, 1);
+      RunScenario (max, tpb, max, max / 2);
+      RunScenario (max, tpb, max / 2, 2 * max);
+      RunScenario (max, tpb, max - 1, (CounterTimeType) ~0ULL);
+    }
+  }
+
+  printf ("%lu scenarios, %lu operations, counter time %u bits: "
+          "PASS\n", num_scenarios, num_ops,
+          (unsigned) (sizeof (CounterTimeType) * 8));
+  return 0;
+}
+
+/* vi: set et ai sw=2 sts=2: */